@@ -15,6 +15,7 @@
 
 #include "ImGuiRHI/ImGuiRHI.h"
 #include "Input/InputSystem.h"
+#include "Input/InputRecorder.h"
 
 #if LEMON_GRAPHICS_D3D11
 #include "ImGuiRHI/Implementation/imgui_impl_dx11.h"
@@ -61,12 +62,24 @@ void Editor::OnWindowMessage(WindowData& windowData)
 		m_Engine->bShowImGuiEditor = false;
 #endif
 
+		// Present is unthrottled, cap the editor instead of rendering thousands of identical frames
+		m_Engine->GetSystem<Lemon::Timer>()->SetFrameRateLimit(144.0);
+
 		// Acquire the System we need
 		EditorGlobal::g_Renderer = m_Engine->GetSystem<Lemon::Renderer>();
 		// Acquire Input System
 		EditorGlobal::g_InputSystem = m_Engine->GetSystem<Lemon::InputSystem>();
 		EditorGlobal::g_Handle = windowData.Handle;
 
+		if (!m_InputReplayPath.empty())
+		{
+			m_Engine->GetInputRecorder()->StartReplay(m_InputReplayPath);
+		}
+		else if (!m_InputRecordPath.empty())
+		{
+			m_Engine->GetInputRecorder()->StartRecording(m_InputRecordPath);
+		}
+
 		if (m_Engine->bShowImGuiEditor)
 		{
 			InitImGui(windowData);
@@ -92,6 +105,9 @@ void Editor::OnWindowMessage(WindowData& windowData)
 			}
 		}
 
+		// While an input replay runs this replaces the size with the recorded one
+		m_Engine->SetWindowData(windowData);
+
 		// Passing zero dimensions will cause the swapchain to not present at all
 		uint32_t width = static_cast<uint32_t>(windowData.Width);
 		uint32_t height = static_cast<uint32_t>(windowData.Height);
@@ -105,8 +121,6 @@ void Editor::OnWindowMessage(WindowData& windowData)
 				EditorGlobal::g_Renderer->OnResize(width, height);
 			}
 		}
-
-		m_Engine->SetWindowData(windowData);
 	}
 }
 void Editor::OnTick()
@@ -202,6 +216,7 @@ void Editor::OnTick()
 
 void Editor::InitImGui(const WindowData& windowData)
 {
+	LEMON_MEMORY_SCOPE(Editor);
 	m_bHasInitImGui = true;
 	// @Copy code from Dear ImGui Demo
 	// Setup Dear ImGui context
@@ -260,6 +275,7 @@ void Editor::WidgetsCreate()
 
 void Editor::WidgetsTick(float deltaTime)
 {
+	LEMON_MEMORY_SCOPE(Editor);
 	if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_DockingEnable)
 	{
 		BeginDockSpace();
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <string>
 #include "Widgets/Widget.h"
 #include <Core/Engine.h>
 
@@ -20,6 +21,10 @@ public:
 	void OnWindowMessage(Lemon::WindowData& windowData);
 	void OnTick();
 
+	// Applied once the engine exists, see Lemon::InputRecorder
+	void SetInputRecordPath(const std::string& filePath) { m_InputRecordPath = filePath; }
+	void SetInputReplayPath(const std::string& filePath) { m_InputReplayPath = filePath; }
+
 private:
 	void InitImGui(const Lemon::WindowData& windowData);
 
@@ -36,5 +41,8 @@ private:
 
 	std::unique_ptr<Lemon::Engine> m_Engine;
 	std::vector<std::unique_ptr<Widget>> m_Widgets;
+
+	std::string m_InputRecordPath;
+	std::string m_InputReplayPath;
 };
 
@@ -1,4 +1,5 @@
 #include "WidgetMenuBar.h"
+#include "Profiler/Profiler.h"
 
 WidgetMenuBar::WidgetMenuBar(Lemon::Engine* engine) : Widget(engine)
 {
@@ -48,6 +49,16 @@ void WidgetMenuBar::Tick(float deltaTime)
 			ImGui::EndMenu();
 		}
 
+		if (ImGui::BeginMenu("Profiler"))
+		{
+			// open the json in chrome://tracing
+			if (ImGui::MenuItem("Capture 60 Frames", nullptr, false, !Lemon::Profiler::IsCapturing()))
+			{
+				Lemon::Profiler::BeginCapture(60, "LemonTrace.json");
+			}
+			ImGui::EndMenu();
+		}
+
 		if (ImGui::BeginMenu("Help"))
 		{
 			ImGui::MenuItem("About", nullptr, &m_ShowAboutWindow);
@@ -30,11 +30,10 @@ void WidgetProperties::DrawEntity(Lemon::Entity entity) const
 	{
 		char buffer[256];
 		memset(buffer, 0, sizeof(buffer));
-		std::string& entityName = entity.GetName();
-		std::strncpy(buffer, entityName.c_str(), sizeof(buffer));
+		std::strncpy(buffer, entity.GetName().c_str(), sizeof(buffer) - 1);
 		if (ImGui::InputText("##Tag", buffer, sizeof(buffer)))
 		{
-			entityName = std::string(buffer);
+			entity.SetName(std::string(buffer));
 		}
 	}
 	const ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_AllowItemOverlap;
@@ -67,9 +66,16 @@ void WidgetProperties::DrawEntity(Lemon::Entity entity) const
 		if (open)
 		{
 			auto& tc = entity.GetComponent<Lemon::TransformComponent>();
-			WidgetHelpers::DrawVec3Control("Translation", tc.Position);
-			WidgetHelpers::DrawVec3Control("Rotation", tc.Rotation);
-			WidgetHelpers::DrawVec3Control("Scale", tc.Scale, 1.0f);
+			glm::vec3 position = tc.GetPosition();
+			glm::vec3 rotation = tc.GetRotation();
+			glm::vec3 scale = tc.GetScale();
+			WidgetHelpers::DrawVec3Control("Translation", position);
+			WidgetHelpers::DrawVec3Control("Rotation", rotation);
+			WidgetHelpers::DrawVec3Control("Scale", scale, 1.0f);
+			// Only an edit may dirty the cached matrices
+			if (position != tc.GetPosition()) tc.SetPosition(position);
+			if (rotation != tc.GetRotation()) tc.SetRotation(rotation);
+			if (scale != tc.GetScale()) tc.SetScale(scale);
 			ImGui::TreePop();
 		}
 	}
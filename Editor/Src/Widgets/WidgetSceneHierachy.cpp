@@ -3,6 +3,7 @@
 
 #include "World/Entity.h"
 #include "World/World.h"
+#include "World/Components/HierarchyComponent.h"
 
 Lemon::Entity WidgetSceneHierachy::SelectEntity = {};
 
@@ -22,43 +23,35 @@ void WidgetSceneHierachy::Tick(float deltaTime)
 
 void WidgetSceneHierachy::DrawHierachyEntityTree()
 {
-	std::vector<Lemon::Entity> AllEntitys = m_Engine->GetSystem<Lemon::World>()->GetAllEntities();
+	Lemon::World* world = m_Engine->GetSystem<Lemon::World>();
+	// Not a copy, indexed because "Create Child Entity" appends to it
+	const std::vector<Lemon::Entity>& AllEntitys = world->GetAllEntities();
 	for(int i = 0;i < AllEntitys.size(); i++)
 	{
-		if(AllEntitys[i].IsGizmo())
+		// Children are drawn below their parent
+		if(AllEntitys[i].IsGizmo() || world->GetParent(AllEntitys[i]))
 			continue;// don't draw gizmo entity in hierachy
-		// Draw Tree Item
-		ImGuiTreeNodeFlags flags = ((SelectEntity == AllEntitys[i]) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
-		flags |= ImGuiTreeNodeFlags_SpanAvailWidth;//
-		flags |= ImGuiTreeNodeFlags_OpenOnDoubleClick;
-		const bool bOpened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)AllEntitys[i], flags, AllEntitys[i].GetName().c_str());
-		if (ImGui::IsItemClicked())
-		{
-			SelectEntity = AllEntitys[i];
-		}
-		bool entityDeleted = false;
-		if (ImGui::BeginPopupContextItem())
-		{
-			if (ImGui::MenuItem("Delete Entity"))
-				entityDeleted = true;
+		DrawEntityNode(AllEntitys[i]);
+	}
 
-			ImGui::EndPopup();
-		}
-		if (bOpened)
-		{
-			const ImGuiTreeNodeFlags temFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_OpenOnDoubleClick;
-			const bool opened = ImGui::TreeNodeEx((void*)9817239, temFlags, AllEntitys[i].GetName().c_str());
-			if (opened)
-				ImGui::TreePop();
-			ImGui::TreePop();
-		}
-		
-		if (entityDeleted)
+	if (m_bAttachRequested)
+	{
+		world->SetParent(m_EntityToAttach, m_AttachParent);
+		m_bAttachRequested = false;
+	}
+	if (m_EntityToDestroy)
+	{
+		// The selection goes if it is inside the destroyed subtree
+		for (Lemon::Entity ancestor = SelectEntity; ancestor; ancestor = world->GetParent(ancestor))
 		{
-			m_Engine->GetSystem<Lemon::World>()->DestroyEntity(AllEntitys[i]);
-			if (SelectEntity == AllEntitys[i])
+			if (ancestor == m_EntityToDestroy)
+			{
 				SelectEntity = {};
+				break;
+			}
 		}
+		world->DestroyEntity(m_EntityToDestroy);
+		m_EntityToDestroy = {};
 	}
 
 	//No select
@@ -73,4 +66,70 @@ void WidgetSceneHierachy::DrawHierachyEntityTree()
 			m_Engine->GetSystem<Lemon::World>()->CreateEntity("Empty Entity");
 		ImGui::EndPopup();
 	}
+}
+
+void WidgetSceneHierachy::DrawEntityNode(Lemon::Entity entity)
+{
+	Lemon::World* world = m_Engine->GetSystem<Lemon::World>();
+	const Lemon::HierarchyComponent* hierarchy = entity.HasComponent<Lemon::HierarchyComponent>() ? &entity.GetComponent<Lemon::HierarchyComponent>() : nullptr;
+	const bool bHasChildren = hierarchy && hierarchy->GetChildCount() > 0;
+
+	// Draw Tree Item
+	ImGuiTreeNodeFlags flags = ((SelectEntity == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
+	flags |= ImGuiTreeNodeFlags_SpanAvailWidth;//
+	flags |= ImGuiTreeNodeFlags_OpenOnDoubleClick;
+	if (!bHasChildren)
+		flags |= ImGuiTreeNodeFlags_Leaf;
+	const bool bOpened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, entity.GetName().c_str());
+	if (ImGui::IsItemClicked())
+	{
+		SelectEntity = entity;
+	}
+
+	// Drag an entity onto another to attach it
+	if (ImGui::BeginDragDropSource())
+	{
+		ImGui::SetDragDropPayload("HIERACHY_ENTITY", &entity, sizeof(Lemon::Entity));
+		ImGui::TextUnformatted(entity.GetName().c_str());
+		ImGui::EndDragDropSource();
+	}
+	if (ImGui::BeginDragDropTarget())
+	{
+		if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("HIERACHY_ENTITY"))
+		{
+			m_EntityToAttach = *static_cast<const Lemon::Entity*>(payload->Data);
+			m_AttachParent = entity;
+			m_bAttachRequested = true;
+		}
+		ImGui::EndDragDropTarget();
+	}
+
+	if (ImGui::BeginPopupContextItem())
+	{
+		if (ImGui::MenuItem("Create Child Entity"))
+		{
+			m_EntityToAttach = world->CreateEntity("Empty Entity");
+			m_AttachParent = entity;
+			m_bAttachRequested = true;
+		}
+		if (ImGui::MenuItem("Detach From Parent", nullptr, false, static_cast<bool>(world->GetParent(entity))))
+		{
+			m_EntityToAttach = entity;
+			m_AttachParent = {};
+			m_bAttachRequested = true;
+		}
+		if (ImGui::MenuItem("Delete Entity"))
+			m_EntityToDestroy = entity;
+
+		ImGui::EndPopup();
+	}
+
+	if (bOpened)
+	{
+		if (hierarchy)
+		{
+			hierarchy->ForEachChild([this](Lemon::Entity child) { DrawEntityNode(child); });
+		}
+		ImGui::TreePop();
+	}
 }
\ No newline at end of file
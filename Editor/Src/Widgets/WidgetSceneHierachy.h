@@ -14,4 +14,13 @@ public:
 
 private:
 	void DrawHierachyEntityTree();
+	// Draws entity and, when expanded, its children
+	void DrawEntityNode(Lemon::Entity entity);
+
+private:
+	// Applied after the tree is drawn, the hierarchy must not change while it is walked
+	Lemon::Entity m_EntityToDestroy;
+	Lemon::Entity m_EntityToAttach;
+	Lemon::Entity m_AttachParent;
+	bool m_bAttachRequested = false;
 };
@@ -142,13 +142,20 @@ void WidgetViewport::DrawGizmoHandle()
 
 	if (ImGuizmo::IsUsing())
 	{
+		// The gizmo works on the world matrix, position/rotation/scale are relative to the parent
+		if (tc.HasParent())
+		{
+			Entity parent = m_Engine->GetSystem<World>()->GetParent(WidgetSceneHierachy::SelectEntity);
+			transform = glm::inverse(parent.GetComponent<TransformComponent>().GetLocalToWorldMatrix()) * transform;
+		}
+
 		glm::vec3 translation, rotation, scale;
 		Math::DecomposeTransform(transform, translation, rotation, scale);
 
-		glm::vec3 deltaRotation = glm::degrees(rotation) - tc.Rotation;
-		tc.Position = translation;
-		tc.Rotation += deltaRotation;
-		tc.Scale = scale;
+		glm::vec3 deltaRotation = glm::degrees(rotation) - tc.GetRotation();
+		tc.SetPosition(translation);
+		tc.SetRotation(tc.GetRotation() + deltaRotation);
+		tc.SetScale(scale);
 	}
 }
 
@@ -1,6 +1,7 @@
 //= INCLUDES ======
 #include "Window.h"
 #include "Editor.h"
+#include <cstring>
 //=================
 
 int main(int argc, char** argv)
@@ -8,6 +9,19 @@ int main(int argc, char** argv)
 	// Create editor
 	Editor editor;
 
+	// --record-input file | --replay-input file
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--record-input") == 0)
+		{
+			editor.SetInputRecordPath(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--replay-input") == 0)
+		{
+			editor.SetInputReplayPath(argv[++i]);
+		}
+	}
+
 	// Create window
 	HINSTANCE hInstance = GetModuleHandle(0);
 	Window::Create(hInstance, "Lemon " + std::string("V01"));
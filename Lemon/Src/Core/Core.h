@@ -3,8 +3,8 @@
 // Platform Detection
 #include "PlatformDetection.h"
 
-#define API_INPUT_WINDOWS
 #ifdef LEMON_PLATFORM_WINDOW
+	#define API_INPUT_WINDOWS
 	#if LEMON_DYNAMIC_LINK
 		#if LEMON_BUILD_DLL
 			#define LEMON_API __declspec(dllexport)
@@ -14,16 +14,24 @@
 	#else
 		#define LEMON_API
 #endif
+	#define LEMON_DEBUGBREAK() __debugbreak()
+#elif defined(LEMON_PLATFORM_LINUX)
+	// Headless only: no window, input is the null backend
+	#define API_INPUT_NULL
+	#define LEMON_API
+	#define LEMON_DEBUGBREAK() __builtin_trap()
+	// Comes with the windows headers there
+	#define FORCEINLINE inline __attribute__((always_inline))
 #else
-	#error Current Application only support windows
+	#error Current Application only support windows and headless linux
 #endif
 
 #define BIT(x) (1 << x)
 #define FORCE_INLINE inline
 
 #ifdef LEMON_DEBUG
-	#define LEMON_CORE_ASSERT(x, ...)   { if(!(x)) { LEMON_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); }}
-	#define LEMON_CLIENT_ASSERT(x, ...) { if(!(x)) { LEMON_CLIENT_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); }}
+	#define LEMON_CORE_ASSERT(x, ...)   { if(!(x)) { LEMON_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); LEMON_DEBUGBREAK(); }}
+	#define LEMON_CLIENT_ASSERT(x, ...) { if(!(x)) { LEMON_CLIENT_ERROR("Assertion Failed: {0}", __VA_ARGS__); LEMON_DEBUGBREAK(); }}
 #else
 	#define LEMON_CORE_ASSERT(x, ...) 
 	#define LEMON_CLIENT_ASSERT(x, ...)
@@ -1,354 +1,411 @@
 #pragma once
 
-#include <typeinfo>
-#include <list>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Lemon
 {
-
-	// IDelegate
-
-	template<typename ReturnType, typename ...ParamType>
-	class IDelegate
+	// Identifies one binding of a MultiDelegate, 0 is never handed out
+	struct DelegateHandle
 	{
-	public:
-		IDelegate() {}
-		virtual ~IDelegate() {}
-		virtual bool IsType(const std::type_info& type) = 0;
-		virtual ReturnType Execute(ParamType ... params) = 0;
-		virtual bool Compare(IDelegate<ReturnType, ParamType...>* delegate) const = 0;
-	};
+		uint32_t Id = 0;
 
+		bool IsValid() const { return Id != 0; }
+		void Reset() { Id = 0; }
+	};
 
-	//StaticDelegate
+	//Delegate
+	// Single bound callable kept in inline storage, binding never allocates.
+	// Big enough for an object pointer plus any member function pointer, lambdas have to fit as well.
 	template<typename ReturnType, typename ...ParamType>
-	class StaticDelegate :
-		public IDelegate<ReturnType, ParamType...>
+	class Delegate
 	{
 	public:
+		static constexpr size_t StorageSize = 40;
+		static constexpr size_t StorageAlign = alignof(void*);
 
-		typedef  ReturnType(*Func)(ParamType...);
+		Delegate() = default;
+		~Delegate() { Reset(); }
 
-		StaticDelegate(Func _func) : m_Func(_func) { }
-
-		virtual bool IsType(const std::type_info& type) { return typeid(StaticDelegate<ReturnType, ParamType...>) == type; }
+		Delegate(Delegate&& other) noexcept { MoveFrom(other); }
+		Delegate& operator=(Delegate&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				MoveFrom(other);
+			}
+			return *this;
+		}
 
-		virtual ReturnType Execute(ParamType ... params) override { return mFunc(params...); }
+		Delegate(const Delegate&) = delete;
+		Delegate& operator=(const Delegate&) = delete;
 
-		virtual bool Compare(IDelegate<ReturnType, ParamType ...>* delegate)const
+		void BindStatic(ReturnType(*func)(ParamType...))
 		{
-			if (nullptr == delegate || !delegate->IsType(typeid(StaticDelegate<ReturnType, ParamType ...>))) return false;
-			StaticDelegate<ReturnType, ParamType ...>* cast = static_cast<StaticDelegate<ReturnType, ParamType ...>*>(delegate);
-			return cast->mFunc == mFunc;
+			Bind(StaticBinding{ func });
 		}
 
-		virtual ~StaticDelegate() {}
-	private:
-		Func m_Func;
-	};
+		template<typename T, typename F>
+		void BindDynamic(T* object, F method)
+		{
+			Bind(MethodBinding<T, F>{ object, method });
+		}
 
+		template<typename F>
+		void BindLambda(F&& func)
+		{
+			Bind(LambdaBinding<std::decay_t<F>>{ std::forward<F>(func) });
+		}
 
-	//StaticDelegate Special Template
-	template<typename ReturnType, typename ...ParamType>
-	class StaticDelegate<ReturnType(*)(ParamType ...)> :
-		public IDelegate<ReturnType, ParamType ...>
-	{
-	public:
-		typedef  ReturnType(*Func)(ParamType...);
+		bool IsBound() const { return m_Stub != nullptr; }
 
-		StaticDelegate(Func func) : m_Func(func) { }
+		void Reset()
+		{
+			if (m_Manager)
+			{
+				m_Manager(EOperation::Destroy, m_Storage, nullptr);
+			}
+			m_Stub = nullptr;
+			m_Manager = nullptr;
+		}
 
-		virtual bool IsType(const std::type_info& type) { return typeid(StaticDelegate<ReturnType(*)(ParamType ...)>) == type; }
+		ReturnType Execute(ParamType&... params) { return m_Stub(m_Storage, params...); }
 
-		virtual ReturnType Execute(ParamType ... params) { return mFunc(params...); }
+		// Same function or same object/method pair, lambdas only compare equal to themselves
+		bool IsBoundTo(ReturnType(*func)(ParamType...)) const { return Matches(StaticBinding{ func }); }
 
-		virtual bool Compare(IDelegate<ReturnType, ParamType ...>* delegate)const
-		{
-			if (nullptr == delegate || !delegate->IsType(typeid(StaticDelegate<ReturnType(*)(ParamType ...)>))) return false;
-			StaticDelegate<ReturnType(*)(ParamType ...)>* cast = static_cast<StaticDelegate<ReturnType(*)(ParamType ...)>*>(delegate);
-			return cast->m_Func == m_Func;
-		}
+		template<typename T, typename F>
+		bool IsBoundTo(T* object, F method) const { return Matches(MethodBinding<T, F>{ object, method }); }
 
-		virtual ~StaticDelegate() {}
 	private:
-		Func m_Func;
-	};
+		enum class EOperation
+		{
+			Move,
+			Destroy
+		};
 
-	//Class Member Delegate
-	template<typename T, typename ReturnType, typename ...ParamType>
-	class MethodDelegate :
-		public IDelegate<ReturnType, ParamType...>
-	{
-	public:
-		typedef ReturnType(T::* Method)(ParamType...);
+		using Stub = ReturnType(*)(void*, ParamType&...);
+		// nullptr for trivially copyable bindings, they are moved with memcpy
+		using Manager = void(*)(EOperation, void*, void*);
 
-		MethodDelegate(T* object, Method method) : m_Object(object), m_Method(method) { }
+		struct StaticBinding
+		{
+			ReturnType(*Func)(ParamType...);
 
-		virtual bool IsType(const std::type_info& type) { return typeid(MethodDelegate<T, ReturnType, ParamType...>) == type; }
+			ReturnType operator()(ParamType&... params) { return Func(params...); }
+		};
 
-		virtual ReturnType Execute(ParamType...params)
+		template<typename T, typename F>
+		struct MethodBinding
 		{
-			(m_Object->*m_Method)(params...);
-		}
+			T* Object;
+			F Method;
 
-		virtual bool Compare(IDelegate<ReturnType, ParamType...>* delegate) const
+			ReturnType operator()(ParamType&... params) { return (Object->*Method)(params...); }
+		};
+
+		template<typename F>
+		struct LambdaBinding
 		{
-			if (nullptr == delegate || !delegate->IsType(typeid(MethodDelegate<ReturnType, ParamType...>))) return false;
-			MethodDelegate<ReturnType, ParamType...>* cast = static_cast<MethodDelegate<ReturnType, ParamType...>*>(delegate);
-			return cast->m_Object == m_Object && cast->m_Method == m_Method;
-		}
+			F Func;
 
-		MethodDelegate() {}
-		virtual ~MethodDelegate() {}
-	private:
-		T* m_Object;
-		Method m_Method;
-	};
+			ReturnType operator()(ParamType&... params) { return Func(params...); }
+		};
 
-	//Class Member Delegate Special Template
-	template<typename T, typename ReturnType, typename ...ParamType>
-	class MethodDelegate<T, ReturnType(T::*)(ParamType...)> :
-		public IDelegate<ReturnType, ParamType...>
-	{
-	public:
-		typedef ReturnType(T::* Method)(ParamType...);
+		template<typename B>
+		static ReturnType Invoke(void* storage, ParamType&... params)
+		{
+			return (*std::launder(static_cast<B*>(storage)))(params...);
+		}
 
-		MethodDelegate(T* object, Method method) : m_Object(object), m_Method(method) { }
+		template<typename B>
+		static void Manage(EOperation operation, void* storage, void* source)
+		{
+			switch (operation)
+			{
+			case EOperation::Move:
+				new (storage) B(std::move(*std::launder(static_cast<B*>(source))));
+				std::launder(static_cast<B*>(source))->~B();
+				break;
+			case EOperation::Destroy:
+				std::launder(static_cast<B*>(storage))->~B();
+				break;
+			}
+		}
 
-		virtual bool IsType(const std::type_info& type) { return typeid(MethodDelegate<T, ReturnType(T::*)(ParamType...)>) == type; }
+		template<typename B>
+		void Bind(B&& binding)
+		{
+			using Binding = std::decay_t<B>;
+			static_assert(sizeof(Binding) <= StorageSize, "Delegate binding does not fit the inline storage");
+			static_assert(alignof(Binding) <= StorageAlign, "Delegate binding is over-aligned");
+
+			Reset();
+			// zeroed so bindings can be compared bytewise
+			std::memset(m_Storage, 0, StorageSize);
+			new (m_Storage) Binding(std::forward<B>(binding));
+			m_Stub = &Invoke<Binding>;
+			m_Manager = std::is_trivially_copyable_v<Binding> ? nullptr : &Manage<Binding>;
+		}
 
-		virtual ReturnType Execute(ParamType...params)
+		template<typename B>
+		bool Matches(const B& binding) const
 		{
-			return (m_Object->*m_Method)(params...);
+			if (m_Stub != &Invoke<B>)
+			{
+				return false;
+			}
+			alignas(StorageAlign) unsigned char storage[StorageSize] = {};
+			new (storage) B(binding);
+			return std::memcmp(storage, m_Storage, sizeof(B)) == 0;
 		}
 
-		virtual bool Compare(IDelegate<ReturnType, ParamType...>* delegate) const
+		void MoveFrom(Delegate& other)
 		{
-			if (nullptr == delegate || !delegate->IsType(typeid(MethodDelegate<T, ReturnType(T::*)(ParamType...)>))) return false;
-			MethodDelegate<T, ReturnType(T::*)(ParamType...)>* cast = static_cast<MethodDelegate<T, ReturnType(T::*)(ParamType...)>*>(delegate);
-			return cast->m_Object == m_Object && cast->m_Method == m_Method;
+			if (other.m_Manager)
+			{
+				other.m_Manager(EOperation::Move, m_Storage, other.m_Storage);
+			}
+			else
+			{
+				std::memcpy(m_Storage, other.m_Storage, StorageSize);
+			}
+			m_Stub = other.m_Stub;
+			m_Manager = other.m_Manager;
+			other.m_Stub = nullptr;
+			other.m_Manager = nullptr;
 		}
 
-		MethodDelegate() {}
-		virtual ~MethodDelegate() {}
 	private:
-		T* m_Object;
-		Method m_Method;
+		Stub m_Stub = nullptr;
+		Manager m_Manager = nullptr;
+		alignas(StorageAlign) unsigned char m_Storage[StorageSize];
 	};
 
 	//MultiCast Delegate
+	// Bindings live contiguously in one vector sorted by handle id, Broadcast is a linear walk over it.
+	// Adding or removing from inside Broadcast (also reentrant) is allowed:
+	// new bindings are parked until the outermost Broadcast returns and removed ones are only flagged dead
+	// until then, so the binding that is currently executing is never moved or destroyed.
 	template<typename ReturnType, typename ...ParamType>
 	class MultiDelegate
 	{
 	public:
-		typedef std::list<IDelegate<ReturnType, ParamType...>*> ListDelegate;
-		typedef typename ListDelegate::iterator ListDelegateIterator;
-		typedef typename ListDelegate::const_iterator ConstListDelegateIterator;
+		using BroadcastResult = std::conditional_t<std::is_void_v<ReturnType>, void, std::vector<ReturnType>>;
 
 		MultiDelegate() { }
 		~MultiDelegate() { Clear(); }
 
-		bool Empty() const
+		bool Empty() const { return Size() == 0; }
+		uint32_t Size() const { return m_LiveCount; }
+
+		void Reserve(uint32_t count) { m_Bindings.reserve(count); }
+
+		void Clear()
 		{
-			for (ConstListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			for (Binding& binding : m_Bindings)
+			{
+				Kill(binding);
+			}
+			for (Binding& binding : m_PendingBindings)
 			{
-				if (*iter) return false;
+				Kill(binding);
 			}
-			return true;
+			Compact();
 		}
 
-		void Clear()
+		DelegateHandle AddStatic(ReturnType(*func)(ParamType...))
 		{
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			// binding the same function twice is ignored, like before
+			if (const Binding* binding = FindBinding([func](const Binding& b) { return b.Callback.IsBoundTo(func); }))
 			{
-				if (*iter)
-				{
-					delete (*iter);
-					(*iter) = nullptr;
-				}
+				return { binding->Id };
 			}
+			return Add([func](Delegate<ReturnType, ParamType...>& callback) { callback.BindStatic(func); });
 		}
 
-		template<typename T>
-		MultiDelegate<ReturnType, ParamType...>& AddStatic(T func)
+		template<typename T, typename F>
+		DelegateHandle AddDynamic(T* object, F func)
 		{
-			StaticDelegate<T>* delegate = new StaticDelegate<T>(func);
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			if (const Binding* binding = FindBinding([object, func](const Binding& b) { return b.Callback.IsBoundTo(object, func); }))
 			{
-				if ((*iter) && (*iter)->Compare(delegate))
-				{
-					delete delegate;
-					return *this;
-				}
+				return { binding->Id };
 			}
-			m_ListDelegates.push_back(delegate);
-			return *this;
+			return Add([object, func](Delegate<ReturnType, ParamType...>& callback) { callback.BindDynamic(object, func); });
 		}
 
-		template<typename T, typename F>
-		MultiDelegate<ReturnType, ParamType...>& AddDynamic(T* object, F func)
+		// Lambdas are never deduplicated, keep the handle to remove them
+		template<typename F>
+		DelegateHandle AddLambda(F&& func)
 		{
-			MethodDelegate<T, F>* delegate = new MethodDelegate<T, F>(object, func);
+			return Add([&func](Delegate<ReturnType, ParamType...>& callback) { callback.BindLambda(std::forward<F>(func)); });
+		}
 
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+		// Invalidates handle, returns false if it was not bound (anymore)
+		bool Remove(DelegateHandle& handle)
+		{
+			const uint32_t id = handle.Id;
+			handle.Reset();
+			if (id == 0)
 			{
-				if ((*iter) && (*iter)->Compare(delegate))
-				{
-					delete delegate;
-					return *this;
-				}
+				return false;
 			}
-			m_ListDelegates.push_back(delegate);
-			return *this;
-		}
 
-		MultiDelegate<ReturnType, ParamType...>& Remove(IDelegate<ReturnType, ParamType...>* delegate)
-		{
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			for (std::vector<Binding>* bindings : { &m_Bindings, &m_PendingBindings })
 			{
-				if ((*iter) && (*iter)->Compare(delegate))
+				auto iter = std::lower_bound(bindings->begin(), bindings->end(), id, [](const Binding& b, uint32_t value) { return b.Id < value; });
+				if (iter != bindings->end() && iter->Id == id && !iter->bRemoved)
 				{
-					if ((*iter) != delegate) delete (*iter);  
-					(*iter) = 0;
-					break;
+					Kill(*iter);
+					Compact();
+					return true;
 				}
 			}
-			delete delegate;
-			return *this;
+			return false;
+		}
+
+		bool RemoveStatic(ReturnType(*func)(ParamType...))
+		{
+			return RemoveIf([func](const Binding& b) { return b.Callback.IsBoundTo(func); });
 		}
 
-		std::vector<ReturnType> Broadcast(ParamType... params)
+		template<typename T, typename F>
+		bool RemoveDynamic(T* object, F func)
 		{
-			ListDelegateIterator iter = m_ListDelegates.begin();
-			std::vector<ReturnType> results;
-			while (iter != m_ListDelegates.end())
+			return RemoveIf([object, func](const Binding& b) { return b.Callback.IsBoundTo(object, func); });
+		}
+
+		BroadcastResult Broadcast(ParamType... params)
+		{
+			m_BroadcastDepth++;
+
+			// Bindings added meanwhile go to m_PendingBindings, so the size can not change under us
+			const size_t count = m_Bindings.size();
+			if constexpr (std::is_void_v<ReturnType>)
 			{
-				if (nullptr == (*iter))
+				for (size_t i = 0; i < count; i++)
 				{
-					iter = m_ListDelegates.erase(iter);
+					if (!m_Bindings[i].bRemoved)
+					{
+						m_Bindings[i].Callback.Execute(params...);
+					}
 				}
-				else
+				m_BroadcastDepth--;
+				Compact();
+			}
+			else
+			{
+				std::vector<ReturnType> results;
+				results.reserve(m_LiveCount);
+				for (size_t i = 0; i < count; i++)
 				{
-					results.push_back((*iter)->Execute(params...));
-					++iter;
+					if (!m_Bindings[i].bRemoved)
+					{
+						results.push_back(m_Bindings[i].Callback.Execute(params...));
+					}
 				}
+				m_BroadcastDepth--;
+				Compact();
+				return results;
 			}
-			return results;
 		}
 
 	private:
 		MultiDelegate<ReturnType, ParamType...>(const MultiDelegate& _event) = delete;
 		MultiDelegate<ReturnType, ParamType...>& operator=(const MultiDelegate& _event) = delete;
 
-	private:
-		ListDelegate m_ListDelegates;
-	};
-
-	template< typename ...ParamType>
-	class MultiDelegate<void, ParamType...>
-	{
-
-	public:
-
-		typedef std::list<IDelegate<void, ParamType...>*> ListDelegate;
-		typedef typename ListDelegate::iterator ListDelegateIterator;
-		typedef typename ListDelegate::const_iterator ConstListDelegateIterator;
-
-		MultiDelegate() { }
-		~MultiDelegate() { Clear(); }
-
-		bool Empty() const
+		struct Binding
 		{
-			for (ConstListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
-			{
-				if (*iter) return false;
-			}
-			return true;
+			Delegate<ReturnType, ParamType...> Callback;
+			uint32_t Id = 0;
+			// Removed bindings keep their id so the vector stays sorted until Compact
+			bool bRemoved = false;
+		};
+
+		template<typename BindFunc>
+		DelegateHandle Add(BindFunc&& bind)
+		{
+			std::vector<Binding>& bindings = m_BroadcastDepth > 0 ? m_PendingBindings : m_Bindings;
+			Binding& binding = bindings.emplace_back();
+			bind(binding.Callback);
+			binding.Id = ++m_NextId;
+			m_LiveCount++;
+			return { binding.Id };
 		}
 
-		void Clear()
+		template<typename Predicate>
+		const Binding* FindBinding(Predicate&& predicate) const
 		{
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			for (const std::vector<Binding>* bindings : { &m_Bindings, &m_PendingBindings })
 			{
-				if (*iter)
+				for (const Binding& binding : *bindings)
 				{
-					delete (*iter);
-					(*iter) = nullptr;
+					if (!binding.bRemoved && predicate(binding))
+					{
+						return &binding;
+					}
 				}
 			}
+			return nullptr;
 		}
 
-		template<typename T>
-		MultiDelegate<void, ParamType...>& AddStatic(T func)
+		template<typename Predicate>
+		bool RemoveIf(Predicate&& predicate)
 		{
-			StaticDelegate<T>* delegate = new StaticDelegate<T>(func);
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			if (const Binding* binding = FindBinding(predicate))
 			{
-				if ((*iter) && (*iter)->Compare(delegate))
-				{
-					delete delegate;
-					return *this;
-				}
+				DelegateHandle handle = { binding->Id };
+				return Remove(handle);
 			}
-			m_ListDelegates.push_back(delegate);
-			return *this;
+			return false;
 		}
 
-		template<typename T, typename F>
-		MultiDelegate<void, ParamType...>& AddDynamic(T* object, F func)
+		void Kill(Binding& binding)
 		{
-			MethodDelegate<T, F>* delegate =  new MethodDelegate<T, F>(object, func);
-
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			if (!binding.bRemoved)
 			{
-				if ((*iter) && (*iter)->Compare(delegate))
-				{
-					delete delegate;
-					return *this;
-				}
+				binding.bRemoved = true;
+				m_LiveCount--;
+				m_bHasDeadBindings = true;
 			}
-			m_ListDelegates.push_back(delegate);
-			return *this;
 		}
 
-		MultiDelegate<void, ParamType...>& Remove(IDelegate<void, ParamType...>* delegate)
+		// Only outside of Broadcast: drops dead bindings and appends the parked ones, keeping the id order
+		void Compact()
 		{
-			for (ListDelegateIterator iter = m_ListDelegates.begin(); iter != m_ListDelegates.end(); ++iter)
+			if (m_BroadcastDepth > 0)
 			{
-				if ((*iter) && (*iter)->Compare(delegate))
-				{
-					if ((*iter) != delegate) delete (*iter);
-					(*iter) = 0;
-					break;
-				}
+				return;
 			}
-			delete delegate;
-			return *this;
-		}
 
-		void Broadcast(ParamType... params)
-		{
-			ListDelegateIterator iter = m_ListDelegates.begin();
-			while (iter != m_ListDelegates.end())
+			if (m_bHasDeadBindings)
 			{
-				if (nullptr == (*iter))
-				{
-					iter = m_ListDelegates.erase(iter);
-				}
-				else
+				m_Bindings.erase(std::remove_if(m_Bindings.begin(), m_Bindings.end(), [](const Binding& b) { return b.bRemoved; }), m_Bindings.end());
+				m_bHasDeadBindings = false;
+			}
+			for (Binding& binding : m_PendingBindings)
+			{
+				if (!binding.bRemoved)
 				{
-					(*iter)->Execute(params...);
-					++iter;
+					m_Bindings.push_back(std::move(binding));
 				}
 			}
+			m_PendingBindings.clear();
 		}
-	private:
-		MultiDelegate<void, ParamType...>(const MultiDelegate& _event) = delete;
-		MultiDelegate<void, ParamType...>& operator=(const MultiDelegate& _event) = delete;
 
 	private:
-		ListDelegate m_ListDelegates;
+		std::vector<Binding> m_Bindings;
+		std::vector<Binding> m_PendingBindings;
+		uint32_t m_NextId = 0;
+		uint32_t m_LiveCount = 0;
+		uint32_t m_BroadcastDepth = 0;
+		bool m_bHasDeadBindings = false;
 	};
 
 }
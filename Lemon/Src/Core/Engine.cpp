@@ -2,9 +2,12 @@
 #include "Engine.h"
 #include "SystemManager.h"
 #include "Timer.h"
+#include "JobSystem.h"
+#include "FrameAllocator.h"
 #include "Renderer/Renderer.h"
 #include "World/World.h"
 #include "Input/InputSystem.h"
+#include "Input/InputRecorder.h"
 #include "Resources/ResourceSystem.h"
 
 using namespace std;
@@ -13,22 +16,31 @@ namespace Lemon
 {
 	Engine::Engine(const WindowData& windowData)
 	{
+		LEMON_MEMORY_SCOPE(Engine);
+
 		// Window
 		m_WindowData = windowData;
 
 		// Initialize Logger
 		Lemon::Logger::Init();
+		Profiler::SetThreadName("Main");
+		FrameAllocator::Initialize();
 
 		//SystemManager
 		m_SystemManager = CreateRef<SystemManager>();
 
 		//Register System
-		m_SystemManager->RegisterSystem<Timer>(this); // must be first so it ticks first
-		m_SystemManager->RegisterSystem<ResourceSystem>(this);
-		m_SystemManager->RegisterSystem<InputSystem>(this);
+		// Tick order is derived from the declared access, independent systems tick concurrently.
+		// Systems whose Tick is empty or trivial stay on the main thread, a job would cost more than the tick
+		m_SystemManager->RegisterSystem<JobSystem>(this, SystemAccess::None().MainThread()); // first so it is destroyed last, other systems may schedule jobs
+		m_SystemManager->RegisterSystem<Timer>(this, SystemAccess::None().MainThread());
+		m_SystemManager->RegisterSystem<ResourceSystem>(this, SystemAccess::None().MainThread());
+		// Polls the OS input devices
+		m_SystemManager->RegisterSystem<InputSystem>(this, SystemAccess::None().MainThread());
 
-		m_SystemManager->RegisterSystem<World>(this);
-		m_SystemManager->RegisterSystem<Renderer>(this);
+		// Creates RHI resources for new geometry while it ticks
+		m_SystemManager->RegisterSystem<World>(this, SystemAccess().Read<Timer>().Read<InputSystem>().Read<ResourceSystem>().FixedStep().MainThread());
+		m_SystemManager->RegisterSystem<Renderer>(this, SystemAccess().Read<Timer>().Read<ResourceSystem>().Write<World>().MainThread());
 
 		//Initialize Systems
 		m_SystemManager->Initialize();
@@ -36,21 +48,50 @@ namespace Lemon
 		// Get the Timer
 		m_Timer = m_SystemManager->GetSystem<Timer>();
 
+		m_InputRecorder = CreateScope<InputRecorder>(this);
 
 		LEMON_CORE_INFO("LemonEngine Initialize");
 	}
 
 	Engine::~Engine()
 	{
-	
+		// Finishes a recording while the systems are still alive
+		m_InputRecorder = nullptr;
+
+		// Systems are destroyed after this, whatever they log from now on is written synchronously
+		Logger::Shutdown();
 	}
 	void Engine::Tick() const
 	{
-		m_SystemManager->Tick(static_cast<float>(m_Timer->GetDeltaTimeSec()));
+		m_InputRecorder->BeginReplayFrame();
+		m_Timer->BeginFrame();
+		m_InputRecorder->RecordFrame();
+
+		if (!m_Timer->IsFixedTimestep())
+		{
+			m_SystemManager->Tick(m_Timer->GetDeltaTimeSec());
+			return;
+		}
+
+		// Simulate in fixed steps, then everything else once at the frame rate
+		for (uint32_t step = 0; step < m_Timer->GetPendingFixedSteps(); step++)
+		{
+			m_SystemManager->Tick(m_Timer->GetFixedStepSec(), ESystemTickGroup::FixedStep);
+			m_Timer->AdvanceFixedStep();
+		}
+		m_SystemManager->Tick(m_Timer->GetDeltaTimeSec(), ESystemTickGroup::VariableStep);
+	}
+
+	void Engine::SetFixedTimestep(bool bEnable, double stepsPerSecond /*= 60.0*/)
+	{
+		m_Timer->SetFixedStepRate(stepsPerSecond);
+		m_Timer->SetFixedTimestep(bEnable);
 	}
 
 	void Engine::SetWindowData(WindowData& windowData)
 	{
+		// A replay keeps the recorded window size, the caller sees the size to use
+		m_InputRecorder->OverrideWindowData(windowData);
 		m_WindowData = windowData;
 		OnWindowMessageEvent.Broadcast(windowData);
 	}
@@ -70,6 +111,9 @@ namespace Lemon
 		GetSystem<InputSystem>()->EndOneFrame();
 
 		GetSystem<World>()->EndOneFrame();
-		
+
+		Profiler::EndFrame();
+		FrameAllocator::EndFrame();
+		MemoryTracker::EndFrame();
 	}
 }
\ No newline at end of file
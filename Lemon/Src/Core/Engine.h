@@ -9,6 +9,7 @@ namespace Lemon
 {
 	class Timer;
 	class InputSystem;
+	class InputRecorder;
 
 	struct WindowData
 	{
@@ -31,9 +32,14 @@ namespace Lemon
 		// Performs a simulation cycle
 		void Tick() const;
 
+		// Run fixed step systems (World) at stepsPerSecond, decoupled from the frame rate
+		void SetFixedTimestep(bool bEnable, double stepsPerSecond = 60.0);
+
 		// WindowData
 		const WindowData& GetWindowData() const { return m_WindowData; }
 		void SetWindowData(WindowData& windowData);
+		// Constructed without a window handle: no swap chain and no window input
+		bool IsHeadless() const { return m_WindowData.Handle == nullptr; }
 
 		template<typename T>
 		T* GetSystem() const
@@ -47,6 +53,8 @@ namespace Lemon
 		// Some use Getter
 		const Timer* GetTimer() const;
 		const InputSystem* GetInputSystem() const;
+		// Records or replays the input and frame delta of every Tick
+		InputRecorder* GetInputRecorder() const { return m_InputRecorder.get(); }
 
 	public:
 		//Delegate
@@ -58,6 +66,7 @@ namespace Lemon
 		WindowData m_WindowData;
 		Ref<SystemManager> m_SystemManager;
 		Timer* m_Timer;
+		Scope<InputRecorder> m_InputRecorder;
 
 
 	};
@@ -0,0 +1,171 @@
+#include "LemonPCH.h"
+#include "FrameAllocator.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace Lemon
+{
+	namespace
+	{
+		struct FrameArena
+		{
+			Scope<uint8_t[]> Memory;
+			std::atomic<size_t> Offset = 0;
+			std::atomic<size_t> OverflowBytes = 0;
+			std::atomic<uint32_t> AllocationCount = 0;
+
+			struct OverflowBlock
+			{
+				void* Memory;
+				size_t Alignment;
+			};
+			std::mutex OverflowMutex;
+			std::vector<OverflowBlock> OverflowBlocks;
+
+			void Reset()
+			{
+				std::lock_guard<std::mutex> lock(OverflowMutex);
+				for (const OverflowBlock& block : OverflowBlocks)
+				{
+					::operator delete(block.Memory, std::align_val_t(block.Alignment));
+				}
+				OverflowBlocks.clear();
+				Offset.store(0, std::memory_order_relaxed);
+				OverflowBytes.store(0, std::memory_order_relaxed);
+				AllocationCount.store(0, std::memory_order_relaxed);
+			}
+		};
+
+		struct FrameAllocatorState
+		{
+			~FrameAllocatorState()
+			{
+				for (FrameArena& arena : Arenas)
+				{
+					arena.Reset();
+				}
+			}
+
+			std::array<FrameArena, FrameAllocator::BufferCount> Arenas;
+			size_t Capacity = 0;
+			std::atomic<uint32_t> CurrentIndex = 0;
+			FrameAllocatorStats Stats;
+			bool bReportedOverflow = false;
+		};
+
+		FrameAllocatorState& GetState()
+		{
+			static FrameAllocatorState s_State;
+			return s_State;
+		}
+	}
+
+	void FrameAllocator::Initialize(size_t bytesPerFrame /*= DefaultBytesPerFrame*/)
+	{
+		FrameAllocatorState& state = GetState();
+		for (FrameArena& arena : state.Arenas)
+		{
+			arena.Reset();
+			arena.Memory.reset(new uint8_t[bytesPerFrame]);
+		}
+		state.Capacity = bytesPerFrame;
+		state.CurrentIndex = 0;
+		ResetStats();
+	}
+
+	void FrameAllocator::Shutdown()
+	{
+		FrameAllocatorState& state = GetState();
+		for (FrameArena& arena : state.Arenas)
+		{
+			arena.Reset();
+			arena.Memory.reset();
+		}
+		state.Capacity = 0;
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment /*= alignof(std::max_align_t)*/)
+	{
+		FrameAllocatorState& state = GetState();
+		FrameArena& arena = state.Arenas[state.CurrentIndex.load(std::memory_order_relaxed)];
+		arena.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		if (arena.Memory)
+		{
+			const uintptr_t base = reinterpret_cast<uintptr_t>(arena.Memory.get());
+			size_t offset = arena.Offset.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				const size_t alignedOffset = ((base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+				const size_t newOffset = alignedOffset + size;
+				if (newOffset > state.Capacity)
+				{
+					break;
+				}
+				if (arena.Offset.compare_exchange_weak(offset, newOffset, std::memory_order_relaxed))
+				{
+					return arena.Memory.get() + alignedOffset;
+				}
+			}
+		}
+
+		// Arena exhausted, keep going on the heap and let the stats tell that the budget is too small
+		void* memory = ::operator new(size, std::align_val_t(alignment));
+		arena.OverflowBytes.fetch_add(size, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(arena.OverflowMutex);
+		arena.OverflowBlocks.push_back({ memory, alignment });
+		return memory;
+	}
+
+	void FrameAllocator::EndFrame()
+	{
+		FrameAllocatorState& state = GetState();
+		const uint32_t currentIndex = state.CurrentIndex.load(std::memory_order_relaxed);
+		FrameArena& arena = state.Arenas[currentIndex];
+
+		FrameAllocatorStats& stats = state.Stats;
+		stats.CapacityBytes = state.Capacity;
+		stats.LastFrameOverflowBytes = arena.OverflowBytes.load(std::memory_order_relaxed);
+		stats.LastFrameBytes = arena.Offset.load(std::memory_order_relaxed) + stats.LastFrameOverflowBytes;
+		stats.LastFrameAllocations = arena.AllocationCount.load(std::memory_order_relaxed);
+		stats.PeakFrameBytes = (std::max)(stats.PeakFrameBytes, stats.LastFrameBytes);
+		stats.FrameCount++;
+		if (stats.LastFrameOverflowBytes > 0)
+		{
+			stats.OverflowFrameCount++;
+			if (!state.bReportedOverflow && state.Capacity > 0)
+			{
+				LEMON_CORE_WARN("FrameAllocator: frame needed {} bytes, arena holds {}", stats.LastFrameBytes, state.Capacity);
+				state.bReportedOverflow = true;
+			}
+		}
+
+		// The arena we switch to was used BufferCount - 1 frames ago, nothing may reference it anymore
+		const uint32_t nextIndex = (currentIndex + 1) % BufferCount;
+		state.Arenas[nextIndex].Reset();
+		state.CurrentIndex.store(nextIndex, std::memory_order_relaxed);
+	}
+
+	size_t FrameAllocator::GetCurrentFrameBytes()
+	{
+		FrameAllocatorState& state = GetState();
+		const FrameArena& arena = state.Arenas[state.CurrentIndex.load(std::memory_order_relaxed)];
+		return arena.Offset.load(std::memory_order_relaxed) + arena.OverflowBytes.load(std::memory_order_relaxed);
+	}
+
+	FrameAllocatorStats FrameAllocator::GetStats()
+	{
+		FrameAllocatorStats stats = GetState().Stats;
+		stats.CapacityBytes = GetState().Capacity;
+		return stats;
+	}
+
+	void FrameAllocator::ResetStats()
+	{
+		FrameAllocatorState& state = GetState();
+		state.Stats = FrameAllocatorStats();
+		state.Stats.CapacityBytes = state.Capacity;
+		state.bReportedOverflow = false;
+	}
+}
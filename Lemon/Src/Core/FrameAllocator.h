@@ -0,0 +1,76 @@
+#pragma once
+#include "Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Lemon
+{
+	struct FrameAllocatorStats
+	{
+		// Size of one arena, there are FrameAllocator::BufferCount of them
+		size_t CapacityBytes = 0;
+		// Bytes handed out during the last finished frame, including what did not fit the arena
+		size_t LastFrameBytes = 0;
+		size_t LastFrameOverflowBytes = 0;
+		uint32_t LastFrameAllocations = 0;
+		// Worst frame since the last reset, use it to size the arena
+		size_t PeakFrameBytes = 0;
+		uint64_t OverflowFrameCount = 0;
+		uint64_t FrameCount = 0;
+	};
+
+	/**
+	 * Linear allocator for data that only lives for the current frame.
+	 * Allocation is a pointer bump, nothing is freed individually. EndFrame switches to the next arena and resets it,
+	 * so memory allocated in frame N stays valid until frame N + BufferCount - 1 ends.
+	 * Requests that do not fit fall back to the heap and are freed when their arena is reset.
+	 * Allocate is thread safe, EndFrame must only be called while no one else allocates.
+	 */
+	class LEMON_API FrameAllocator
+	{
+	public:
+		static constexpr uint32_t BufferCount = 2;
+		static constexpr size_t DefaultBytesPerFrame = 4 * 1024 * 1024;
+
+		// (Re)creates the arenas, everything allocated before becomes invalid
+		static void Initialize(size_t bytesPerFrame = DefaultBytesPerFrame);
+		static void Shutdown();
+
+		static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		static T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))); }
+
+		// Frame boundary, called once per frame by Engine::EndOneFrame
+		static void EndFrame();
+
+		static size_t GetCurrentFrameBytes();
+		static FrameAllocatorStats GetStats();
+		static void ResetStats();
+	};
+
+	// STL allocator on top of FrameAllocator, deallocate does nothing so reserve up front where the size is known
+	template<typename T>
+	class FrameStlAllocator
+	{
+	public:
+		using value_type = T;
+
+		FrameStlAllocator() = default;
+		template<typename U>
+		FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+		T* allocate(size_t count) { return FrameAllocator::AllocateArray<T>(count); }
+		void deallocate(T*, size_t) noexcept {}
+
+		template<typename U>
+		bool operator==(const FrameStlAllocator<U>&) const noexcept { return true; }
+		template<typename U>
+		bool operator!=(const FrameStlAllocator<U>&) const noexcept { return false; }
+	};
+
+	// Must not be kept longer than FrameAllocator::BufferCount frames
+	template<typename T>
+	using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
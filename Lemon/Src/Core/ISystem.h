@@ -1,6 +1,9 @@
 #pragma once
 #include <memory>
+#include <vector>
+#include <typeindex>
 #include "Core.h"
+#include "MemoryTracker.h"
 
 namespace Lemon
 {
@@ -15,6 +18,8 @@ namespace Lemon
 
 		virtual bool Initialize() { return true; }
 		virtual void Tick(float deltaTime) {}
+		// Allocations made inside Initialize and Tick are charged to this tag
+		virtual EMemoryTag GetMemoryTag() const { return EMemoryTag::Engine; }
 
 		template <typename T>
 		Ref<T> GetRefPtr() { return dynamic_pointer_cast<T>(shared_from_this()); }
@@ -24,6 +29,33 @@ namespace Lemon
 		Engine* m_Engine;
 	};
 
+	/**
+	 * Which other systems a system touches during its Tick, declared at registration.
+	 * SystemManager orders two systems (by registration order) only if one of them writes what the other reads or writes,
+	 * everything else may tick concurrently. A system always writes itself.
+	 * Nothing declared means unknown access, such a system is ordered against every other system.
+	 */
+	struct SystemAccess
+	{
+		std::vector<std::type_index> Reads;
+		std::vector<std::type_index> Writes;
+		// Tick must run on the thread calling SystemManager::Tick (e.g. it talks to the graphics API)
+		bool bMainThread = false;
+		// Simulation system, ticked once per fixed step when the Timer is in fixed timestep mode
+		bool bFixedStep = false;
+		bool bExclusive = true;
+
+		template<typename T>
+		SystemAccess& Read() { Reads.emplace_back(typeid(T)); bExclusive = false; return *this; }
+		template<typename T>
+		SystemAccess& Write() { Writes.emplace_back(typeid(T)); bExclusive = false; return *this; }
+		SystemAccess& MainThread() { bMainThread = true; return *this; }
+		SystemAccess& FixedStep() { bFixedStep = true; return *this; }
+
+		// Touches nothing but itself
+		static SystemAccess None() { SystemAccess access; access.bExclusive = false; return access; }
+	};
+
 	template<typename T>
 	constexpr void ValidateSystemType() { static_assert(std::is_base_of<ISystem, T>::value, "Provided type does not implement ISubystem"); }
 }
@@ -0,0 +1,429 @@
+#include "LemonPCH.h"
+#include "JobSystem.h"
+
+namespace Lemon
+{
+	// Index of the calling thread inside the job system, 0 is the thread that called Initialize
+	static thread_local uint32_t s_ThreadIndex = JobSystem::InvalidThreadIndex;
+
+	//----------------------------------WorkStealingQueue----------------------------------//
+	bool WorkStealingQueue::Push(Job* job)
+	{
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_Top.load(std::memory_order_acquire);
+		if (bottom - top >= static_cast<int64_t>(Capacity))
+		{
+			return false;
+		}
+		m_Jobs[bottom & Mask].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	Job* WorkStealingQueue::Pop()
+	{
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+		m_Bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_Top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// queue was already empty
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = m_Jobs[bottom & Mask].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			// last job, race against stealers for it
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				job = nullptr;
+			}
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	Job* WorkStealingQueue::Steal()
+	{
+		int64_t top = m_Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+		{
+			return nullptr;
+		}
+
+		Job* job = m_Jobs[top & Mask].load(std::memory_order_relaxed);
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			// lost the race against Pop or another stealer
+			return nullptr;
+		}
+		return job;
+	}
+
+	uint32_t WorkStealingQueue::Size() const
+	{
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_Top.load(std::memory_order_relaxed);
+		return bottom > top ? static_cast<uint32_t>(bottom - top) : 0;
+	}
+
+	//----------------------------------JobSystem----------------------------------//
+	JobSystem::JobSystem(Engine* engine, uint32_t numThreads /*= 0*/)
+		:ISystem(engine)
+	{
+		m_NumThreads = numThreads ? numThreads : (std::max)(1u, std::thread::hardware_concurrency());
+	}
+
+	JobSystem::~JobSystem()
+	{
+		m_bRunning = false;
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+		{
+			worker.join();
+		}
+		m_Workers.clear();
+	}
+
+	bool JobSystem::Initialize()
+	{
+		m_Contexts.reserve(m_NumThreads);
+		for (uint32_t i = 0; i < m_NumThreads; i++)
+		{
+			m_Contexts.emplace_back(CreateScope<ThreadContext>());
+			m_Contexts.back()->RandomState = i + 1;
+		}
+
+		// the initializing thread is worker 0, it executes jobs whenever it waits
+		s_ThreadIndex = 0;
+		m_bRunning = true;
+
+		for (uint32_t i = 1; i < m_NumThreads; i++)
+		{
+			m_Workers.emplace_back([this, i]() { WorkerLoop(i); });
+		}
+
+		LEMON_CORE_INFO("JobSystem started with {0} threads", m_NumThreads);
+		return true;
+	}
+
+	uint32_t JobSystem::GetCurrentThreadIndex()
+	{
+		return s_ThreadIndex;
+	}
+
+	JobHandle JobSystem::Schedule(std::function<void()> task, const JobHandle& dependency /*= {}*/)
+	{
+		JobHandle handle;
+		handle.m_Counter = CreateRef<JobCounter>();
+		handle.m_Counter->Value.store(1, std::memory_order_relaxed);
+
+		const uint32_t threadIndex = GetCurrentThreadIndex();
+		Job* job = (m_bRunning && threadIndex < m_NumThreads) ? AllocateJob(*m_Contexts[threadIndex]) : nullptr;
+		if (!job)
+		{
+			// foreign thread or pool exhausted, run it right here
+			Wait(dependency);
+			task();
+			handle.m_Counter->bFinished = true;
+			handle.m_Counter->Value.store(0, std::memory_order_release);
+			return handle;
+		}
+
+		job->Task = std::move(task);
+		job->Counter = handle.m_Counter;
+
+		if (dependency.m_Counter)
+		{
+			JobCounter& dependencyCounter = *dependency.m_Counter;
+			std::lock_guard<std::mutex> lock(dependencyCounter.ContinuationMutex);
+			if (!dependencyCounter.bFinished)
+			{
+				dependencyCounter.Continuations.push_back(job);
+				return handle;
+			}
+		}
+
+		Submit(job);
+		return handle;
+	}
+
+	JobHandle JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& function,
+		const JobHandle& dependency /*= {}*/)
+	{
+		if (count == 0)
+		{
+			return dependency;
+		}
+
+		grainSize = (std::max)(1u, grainSize);
+		const uint32_t numJobs = (count + grainSize - 1) / grainSize;
+
+		JobHandle handle;
+		handle.m_Counter = CreateRef<JobCounter>();
+		handle.m_Counter->Value.store(static_cast<int32_t>(numJobs), std::memory_order_relaxed);
+
+		const uint32_t threadIndex = GetCurrentThreadIndex();
+		const bool bCanSchedule = m_bRunning && threadIndex < m_NumThreads && numJobs > 1;
+		if (!bCanSchedule)
+		{
+			Wait(dependency);
+			function(0, count);
+			handle.m_Counter->bFinished = true;
+			handle.m_Counter->Value.store(0, std::memory_order_release);
+			return handle;
+		}
+
+		// one copy of the user function shared by every chunk
+		Ref<std::function<void(uint32_t, uint32_t)>> sharedFunction = CreateRef<std::function<void(uint32_t, uint32_t)>>(function);
+
+		std::vector<Job*> parkedJobs;
+		for (uint32_t jobIndex = 0; jobIndex < numJobs; jobIndex++)
+		{
+			const uint32_t begin = jobIndex * grainSize;
+			const uint32_t end = (std::min)(begin + grainSize, count);
+
+			Job* job = AllocateJob(*m_Contexts[threadIndex]);
+			if (!job)
+			{
+				Wait(dependency);
+				(*sharedFunction)(begin, end);
+				ReleaseCounter(*handle.m_Counter);
+				continue;
+			}
+			job->Task = [sharedFunction, begin, end]() { (*sharedFunction)(begin, end); };
+			job->Counter = handle.m_Counter;
+			parkedJobs.push_back(job);
+		}
+
+		if (parkedJobs.empty())
+		{
+			// every chunk ran inline, the last one already finished the counter
+			return handle;
+		}
+
+		if (dependency.m_Counter)
+		{
+			JobCounter& dependencyCounter = *dependency.m_Counter;
+			std::lock_guard<std::mutex> lock(dependencyCounter.ContinuationMutex);
+			if (!dependencyCounter.bFinished)
+			{
+				dependencyCounter.Continuations.insert(dependencyCounter.Continuations.end(), parkedJobs.begin(), parkedJobs.end());
+				return handle;
+			}
+		}
+
+		for (Job* job : parkedJobs)
+		{
+			Submit(job);
+		}
+		return handle;
+	}
+
+	void JobSystem::Wait(const JobHandle& handle)
+	{
+		const uint32_t threadIndex = GetCurrentThreadIndex();
+		const bool bIsWorker = m_bRunning && threadIndex < m_NumThreads;
+		while (!handle.IsCompleted())
+		{
+			// help out instead of blocking
+			Job* job = bIsWorker ? GetJob(threadIndex) : nullptr;
+			if (job)
+			{
+				Execute(job, threadIndex);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	JobSystemStats JobSystem::GetStats() const
+	{
+		JobSystemStats stats;
+		stats.PerThread.reserve(m_Contexts.size());
+		for (const auto& context : m_Contexts)
+		{
+			JobSystemThreadStats threadStats;
+			threadStats.JobsExecuted = context->JobsExecuted.load(std::memory_order_relaxed);
+			threadStats.StealAttempts = context->StealAttempts.load(std::memory_order_relaxed);
+			threadStats.StealSuccesses = context->StealSuccesses.load(std::memory_order_relaxed);
+
+			stats.JobsExecuted += threadStats.JobsExecuted;
+			stats.StealAttempts += threadStats.StealAttempts;
+			stats.StealSuccesses += threadStats.StealSuccesses;
+			stats.PerThread.push_back(threadStats);
+		}
+		return stats;
+	}
+
+	void JobSystem::ResetStats()
+	{
+		for (auto& context : m_Contexts)
+		{
+			context->JobsExecuted = 0;
+			context->StealAttempts = 0;
+			context->StealSuccesses = 0;
+		}
+	}
+
+	Job* JobSystem::AllocateJob(ThreadContext& context)
+	{
+		// ring of preallocated jobs, slots are only handed out again once their job has finished
+		for (uint32_t i = 0; i < WorkStealingQueue::Capacity; i++)
+		{
+			Job& job = context.JobPool[context.NextPoolIndex];
+			context.NextPoolIndex = (context.NextPoolIndex + 1) & (WorkStealingQueue::Capacity - 1);
+			if (!job.bInFlight.load(std::memory_order_acquire))
+			{
+				job.bInFlight.store(true, std::memory_order_relaxed);
+				return &job;
+			}
+		}
+		return nullptr;
+	}
+
+	void JobSystem::Submit(Job* job)
+	{
+		PushReady(job);
+
+		// workers only sleep on the condition when nothing is queued, see WorkerLoop
+		if (m_SleepingWorkers.load() > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_WakeMutex);
+			}
+			m_WakeCondition.notify_one();
+		}
+	}
+
+	void JobSystem::PushReady(Job* job)
+	{
+		const uint32_t threadIndex = GetCurrentThreadIndex();
+		if (threadIndex < m_NumThreads)
+		{
+			m_QueuedJobs.fetch_add(1);
+			if (m_Contexts[threadIndex]->Queue.Push(job))
+			{
+				return;
+			}
+			m_QueuedJobs.fetch_sub(1);
+		}
+		// queue is full, don't lose the job
+		Execute(job, threadIndex);
+	}
+
+	Job* JobSystem::GetJob(uint32_t threadIndex)
+	{
+		ThreadContext& context = *m_Contexts[threadIndex];
+		Job* job = context.Queue.Pop();
+
+		if (!job && m_NumThreads > 1)
+		{
+			for (uint32_t attempt = 0; attempt < m_NumThreads; attempt++)
+			{
+				// xorshift32 to pick a victim
+				uint32_t random = context.RandomState;
+				random ^= random << 13;
+				random ^= random >> 17;
+				random ^= random << 5;
+				context.RandomState = random;
+
+				const uint32_t victim = random % m_NumThreads;
+				if (victim == threadIndex)
+				{
+					continue;
+				}
+
+				context.StealAttempts.fetch_add(1, std::memory_order_relaxed);
+				job = m_Contexts[victim]->Queue.Steal();
+				if (job)
+				{
+					context.StealSuccesses.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+			}
+		}
+
+		if (job)
+		{
+			m_QueuedJobs.fetch_sub(1);
+		}
+		return job;
+	}
+
+	void JobSystem::Execute(Job* job, uint32_t threadIndex)
+	{
+		job->Task();
+		if (threadIndex < m_NumThreads)
+		{
+			m_Contexts[threadIndex]->JobsExecuted.fetch_add(1, std::memory_order_relaxed);
+		}
+		FinishJob(job);
+	}
+
+	void JobSystem::FinishJob(Job* job)
+	{
+		Ref<JobCounter> counter = std::move(job->Counter);
+		job->Task = nullptr;
+		job->bInFlight.store(false, std::memory_order_release);
+
+		ReleaseCounter(*counter);
+	}
+
+	void JobSystem::ReleaseCounter(JobCounter& counter)
+	{
+		if (counter.Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::vector<Job*> continuations;
+			{
+				std::lock_guard<std::mutex> lock(counter.ContinuationMutex);
+				counter.bFinished = true;
+				continuations.swap(counter.Continuations);
+			}
+			for (Job* continuation : continuations)
+			{
+				Submit(continuation);
+			}
+		}
+	}
+
+	void JobSystem::WorkerLoop(uint32_t threadIndex)
+	{
+		s_ThreadIndex = threadIndex;
+		Profiler::SetThreadName("JobWorker " + std::to_string(threadIndex));
+
+		while (m_bRunning)
+		{
+			if (Job* job = GetJob(threadIndex))
+			{
+				Execute(job, threadIndex);
+				continue;
+			}
+
+			if (m_QueuedJobs.load() > 0)
+			{
+				// jobs exist but someone else won the race, try again
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			m_SleepingWorkers.fetch_add(1);
+			m_WakeCondition.wait(lock, [this]() { return m_QueuedJobs.load() > 0 || !m_bRunning; });
+			m_SleepingWorkers.fetch_sub(1);
+		}
+	}
+}
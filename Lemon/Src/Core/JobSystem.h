@@ -0,0 +1,198 @@
+#pragma once
+#include "Core.h"
+#include "ISystem.h"
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+namespace Lemon
+{
+	struct Job;
+
+	// Shared by every job of one Schedule/ParallelFor call, reaches zero when all of them have finished.
+	// Jobs scheduled with this counter as a dependency are parked here until then.
+	struct JobCounter
+	{
+		std::atomic<int32_t> Value = 0;
+
+		std::mutex ContinuationMutex;
+		std::vector<Job*> Continuations;
+		bool bFinished = false;
+	};
+
+	class LEMON_API JobHandle
+	{
+		friend class JobSystem;
+	public:
+		JobHandle() = default;
+
+		bool IsValid() const { return m_Counter != nullptr; }
+		// an invalid handle counts as completed so it can always be used as a dependency
+		bool IsCompleted() const { return !m_Counter || m_Counter->Value.load(std::memory_order_acquire) == 0; }
+
+	private:
+		Ref<JobCounter> m_Counter;
+	};
+
+	struct Job
+	{
+		std::function<void()> Task;
+		Ref<JobCounter> Counter;
+		std::atomic<bool> bInFlight = false;
+	};
+
+	/**
+	 * Chase-Lev work-stealing deque.
+	 * Only the owning thread may Push/Pop (LIFO, from the bottom), any thread may Steal (FIFO, from the top).
+	 */
+	class WorkStealingQueue
+	{
+	public:
+		static constexpr uint32_t Capacity = 4096;
+
+		bool Push(Job* job);
+		Job* Pop();
+		Job* Steal();
+
+		uint32_t Size() const;
+	private:
+		static constexpr uint32_t Mask = Capacity - 1;
+		static_assert((Capacity & Mask) == 0, "WorkStealingQueue capacity must be a power of two");
+
+		alignas(64) std::atomic<int64_t> m_Top = 0;
+		alignas(64) std::atomic<int64_t> m_Bottom = 0;
+		std::array<std::atomic<Job*>, Capacity> m_Jobs;
+	};
+
+	struct JobSystemThreadStats
+	{
+		uint64_t JobsExecuted = 0;
+		uint64_t StealAttempts = 0;
+		uint64_t StealSuccesses = 0;
+	};
+
+	struct JobSystemStats
+	{
+		uint64_t JobsExecuted = 0;
+		uint64_t StealAttempts = 0;
+		uint64_t StealSuccesses = 0;
+		// index 0 is the main thread
+		std::vector<JobSystemThreadStats> PerThread;
+
+		double GetStealSuccessRate() const { return StealAttempts ? static_cast<double>(StealSuccesses) / StealAttempts : 0.0; }
+	};
+
+	/**
+	 * Worker pool with one thread per core (the main thread counts as worker 0).
+	 * Every thread owns a work-stealing queue; idle threads steal from the others.
+	 * Jobs may only be scheduled from the main thread or from inside another job,
+	 * calls from any other thread run the job inline.
+	 */
+	class LEMON_API JobSystem : public ISystem
+	{
+	public:
+		JobSystem(Engine* engine, uint32_t numThreads = 0);
+		~JobSystem();
+
+		bool Initialize() override;
+
+		// Run task on any worker, after dependency has completed if one is given
+		JobHandle Schedule(std::function<void()> task, const JobHandle& dependency = {});
+
+		// Split [0, count) into ranges of at most grainSize and run function(begin, end) for each of them
+		JobHandle ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& function,
+			const JobHandle& dependency = {});
+
+		// Blocks until handle is completed, running queued jobs on the calling thread meanwhile
+		void Wait(const JobHandle& handle);
+
+		uint32_t GetNumThreads() const { return m_NumThreads; }
+		// Index of the calling thread in [0, GetNumThreads()), or InvalidThreadIndex for foreign threads
+		static uint32_t GetCurrentThreadIndex();
+		static constexpr uint32_t InvalidThreadIndex = ~0u;
+
+		JobSystemStats GetStats() const;
+		void ResetStats();
+
+	private:
+		struct alignas(64) ThreadContext
+		{
+			WorkStealingQueue Queue;
+			std::array<Job, WorkStealingQueue::Capacity> JobPool;
+			uint32_t NextPoolIndex = 0;
+			uint32_t RandomState = 0;
+
+			std::atomic<uint64_t> JobsExecuted = 0;
+			std::atomic<uint64_t> StealAttempts = 0;
+			std::atomic<uint64_t> StealSuccesses = 0;
+		};
+
+		Job* AllocateJob(ThreadContext& context);
+		void Submit(Job* job);
+		void PushReady(Job* job);
+		Job* GetJob(uint32_t threadIndex);
+		void Execute(Job* job, uint32_t threadIndex);
+		void FinishJob(Job* job);
+		void ReleaseCounter(JobCounter& counter);
+
+		void WorkerLoop(uint32_t threadIndex);
+
+	private:
+		uint32_t m_NumThreads = 1;
+		std::vector<Scope<ThreadContext>> m_Contexts;
+		std::vector<std::thread> m_Workers;
+
+		std::atomic<bool> m_bRunning = false;
+		std::atomic<int32_t> m_QueuedJobs = 0;
+		std::atomic<int32_t> m_SleepingWorkers = 0;
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCondition;
+	};
+
+	/**
+	 * Scratch storage with one T per JobSystem thread, each on its own cache line so neighbours do not false share.
+	 * Local() is the calling thread's slot, jobs use it without locking. Threads outside the pool share one extra slot.
+	 * The order threads pick up work is not fixed, combine the slots with an order independent operation
+	 * or use World::ParallelReduce when the result has to be deterministic.
+	 */
+	template<typename T>
+	class PerThread
+	{
+	public:
+		explicit PerThread(const JobSystem* jobSystem, const T& value = T())
+			: m_Slots((jobSystem ? jobSystem->GetNumThreads() : 0) + 1, Slot{ value })
+		{
+		}
+
+		T& Local()
+		{
+			const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+			return m_Slots[(std::min)(threadIndex, GetCount() - 1)].Value;
+		}
+
+		uint32_t GetCount() const { return static_cast<uint32_t>(m_Slots.size()); }
+		T& operator[](uint32_t index) { return m_Slots[index].Value; }
+		const T& operator[](uint32_t index) const { return m_Slots[index].Value; }
+
+		template<typename Fn>
+		void ForEach(Fn&& fn)
+		{
+			for (Slot& slot : m_Slots)
+			{
+				fn(slot.Value);
+			}
+		}
+
+	private:
+		struct alignas(64) Slot
+		{
+			T Value;
+		};
+		std::vector<Slot> m_Slots;
+	};
+}
@@ -0,0 +1,254 @@
+#include "LemonPCH.h"
+#include "MemoryTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace Lemon
+{
+	namespace
+	{
+		// In front of every tracked block, keeps the user pointer 16 byte aligned
+		struct alignas(16) AllocationHeader
+		{
+			uint64_t Size;
+			// distance from the malloc'd pointer to the user pointer
+			uint32_t Offset;
+			EMemoryTag Tag;
+		};
+		static_assert(sizeof(AllocationHeader) == 16, "AllocationHeader must keep 16 byte alignment");
+
+		struct alignas(64) TagCounters
+		{
+			std::atomic<int64_t> LiveBytes{ 0 };
+			std::atomic<int64_t> PeakBytes{ 0 };
+			std::atomic<int64_t> LiveAllocations{ 0 };
+			std::atomic<uint64_t> TotalAllocations{ 0 };
+			std::atomic<int64_t> BudgetBytes{ 0 };
+			// only touched by EndFrame
+			bool bOverBudget = false;
+		};
+
+		// Constant initialized, operator new may run before any dynamic initializer
+		TagCounters s_Counters[static_cast<size_t>(EMemoryTag::Count)];
+		thread_local EMemoryTag s_ThreadTag = EMemoryTag::Untagged;
+
+		uint32_t s_DumpInterval = 0;
+		uint64_t s_FrameIndex = 0;
+
+		const char* s_TagNames[] =
+		{
+			"Untagged",
+			"Engine",
+			"World",
+			"EntityStorage",
+			"Renderer",
+			"RHI",
+			"Resources",
+			"TextureData",
+			"MeshData",
+			"Editor",
+			"Log",
+		};
+		static_assert(sizeof(s_TagNames) / sizeof(s_TagNames[0]) == static_cast<size_t>(EMemoryTag::Count), "Every EMemoryTag needs a name");
+
+		TagCounters& GetCounters(EMemoryTag tag)
+		{
+			return s_Counters[static_cast<size_t>(tag)];
+		}
+	}
+
+	void* MemoryTracker::Allocate(size_t size, size_t alignment, EMemoryTag tag)
+	{
+		alignment = (std::max)(alignment, alignof(AllocationHeader));
+		// malloc already returns 16 byte aligned memory, stricter alignments need room to shift the block
+		const size_t padding = alignment > alignof(AllocationHeader) ? alignment : 0;
+		uint8_t* raw = static_cast<uint8_t*>(std::malloc(size + sizeof(AllocationHeader) + padding));
+		if (!raw)
+		{
+			return nullptr;
+		}
+
+		const uintptr_t user = (reinterpret_cast<uintptr_t>(raw) + sizeof(AllocationHeader) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+		header->Size = size;
+		header->Offset = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(raw));
+		header->Tag = tag;
+
+		TagCounters& counters = GetCounters(tag);
+		const int64_t liveBytes = counters.LiveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+		counters.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+		counters.TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+		int64_t peak = counters.PeakBytes.load(std::memory_order_relaxed);
+		while (liveBytes > peak && !counters.PeakBytes.compare_exchange_weak(peak, liveBytes, std::memory_order_relaxed))
+		{
+		}
+
+		return reinterpret_cast<void*>(user);
+	}
+
+	void MemoryTracker::Free(void* memory)
+	{
+		if (!memory)
+		{
+			return;
+		}
+
+		const AllocationHeader* header = static_cast<const AllocationHeader*>(memory) - 1;
+		TagCounters& counters = GetCounters(header->Tag);
+		counters.LiveBytes.fetch_sub(static_cast<int64_t>(header->Size), std::memory_order_relaxed);
+		counters.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+
+		std::free(static_cast<uint8_t*>(memory) - header->Offset);
+	}
+
+	EMemoryTag MemoryTracker::GetThreadTag()
+	{
+		return s_ThreadTag;
+	}
+
+	void MemoryTracker::SetThreadTag(EMemoryTag tag)
+	{
+		s_ThreadTag = tag;
+	}
+
+	const char* MemoryTracker::GetTagName(EMemoryTag tag)
+	{
+		return tag < EMemoryTag::Count ? s_TagNames[static_cast<size_t>(tag)] : "Invalid";
+	}
+
+	MemoryTagStats MemoryTracker::GetStats(EMemoryTag tag)
+	{
+		const TagCounters& counters = GetCounters(tag);
+		MemoryTagStats stats;
+		stats.LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+		stats.PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+		stats.LiveAllocations = counters.LiveAllocations.load(std::memory_order_relaxed);
+		stats.TotalAllocations = counters.TotalAllocations.load(std::memory_order_relaxed);
+		stats.BudgetBytes = counters.BudgetBytes.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void MemoryTracker::ResetPeaks()
+	{
+		for (TagCounters& counters : s_Counters)
+		{
+			counters.PeakBytes.store(counters.LiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+
+	void MemoryTracker::SetBudget(EMemoryTag tag, int64_t budgetBytes)
+	{
+		GetCounters(tag).BudgetBytes.store(budgetBytes, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::SetFrameDumpInterval(uint32_t intervalFrames)
+	{
+		s_DumpInterval = intervalFrames;
+	}
+
+	void MemoryTracker::DumpStats()
+	{
+		stringstream stream;
+		stream << "Memory (live KB / peak KB / live allocations / budget KB):";
+		for (uint32_t i = 0; i < static_cast<uint32_t>(EMemoryTag::Count); i++)
+		{
+			const MemoryTagStats stats = GetStats(static_cast<EMemoryTag>(i));
+			if (stats.TotalAllocations == 0)
+			{
+				continue;
+			}
+			stream << "\n\t" << s_TagNames[i] << ": " << stats.LiveBytes / 1024 << " / " << stats.PeakBytes / 1024 << " / " << stats.LiveAllocations;
+			if (stats.BudgetBytes > 0)
+			{
+				stream << " / " << stats.BudgetBytes / 1024;
+			}
+		}
+		LEMON_CORE_INFO(stream.str());
+	}
+
+	std::string MemoryTracker::GetStatsJson()
+	{
+		stringstream stream;
+		stream << "{\n";
+		for (uint32_t i = 0; i < static_cast<uint32_t>(EMemoryTag::Count); i++)
+		{
+			const MemoryTagStats stats = GetStats(static_cast<EMemoryTag>(i));
+			stream << "\t\"" << s_TagNames[i] << "\": { ";
+			stream << "\"liveBytes\": " << stats.LiveBytes << ", ";
+			stream << "\"peakBytes\": " << stats.PeakBytes << ", ";
+			stream << "\"liveAllocations\": " << stats.LiveAllocations << ", ";
+			stream << "\"totalAllocations\": " << stats.TotalAllocations << ", ";
+			stream << "\"budgetBytes\": " << stats.BudgetBytes << " }";
+			stream << (i + 1 < static_cast<uint32_t>(EMemoryTag::Count) ? ",\n" : "\n");
+		}
+		stream << "}\n";
+		return stream.str();
+	}
+
+	void MemoryTracker::EndFrame()
+	{
+		for (uint32_t i = 0; i < static_cast<uint32_t>(EMemoryTag::Count); i++)
+		{
+			TagCounters& counters = s_Counters[i];
+			const int64_t budget = counters.BudgetBytes.load(std::memory_order_relaxed);
+			const int64_t liveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+			const bool bOverBudget = budget > 0 && liveBytes > budget;
+			if (bOverBudget && !counters.bOverBudget)
+			{
+				LEMON_CORE_WARN("Memory tag {0} over budget: {1} KB live, budget {2} KB", s_TagNames[i], liveBytes / 1024, budget / 1024);
+			}
+			counters.bOverBudget = bOverBudget;
+		}
+
+		s_FrameIndex++;
+		if (s_DumpInterval > 0 && s_FrameIndex % s_DumpInterval == 0)
+		{
+			DumpStats();
+		}
+	}
+}
+
+#if LEMON_MEMORY_TRACKING
+//====Global new/delete replacement====//
+// Everything allocated through new is charged to the tag of the allocating thread
+
+static void* TrackedNew(size_t size, size_t alignment)
+{
+	void* memory = ::Lemon::MemoryTracker::Allocate(size, alignment, ::Lemon::MemoryTracker::GetThreadTag());
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+static void* TrackedNewNoThrow(size_t size, size_t alignment) noexcept
+{
+	return ::Lemon::MemoryTracker::Allocate(size, alignment, ::Lemon::MemoryTracker::GetThreadTag());
+}
+
+void* operator new(size_t size) { return TrackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return TrackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedNew(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedNew(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete[](void* memory) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete(void* memory, size_t) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, size_t) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { ::Lemon::MemoryTracker::Free(memory); }
+#endif
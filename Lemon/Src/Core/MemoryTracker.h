@@ -0,0 +1,125 @@
+#pragma once
+#include "Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Global new/delete are routed through the tracker unless this is 0, the tagged containers are tracked either way
+#ifndef LEMON_MEMORY_TRACKING
+	#ifdef LEMON_SHIPPING
+		#define LEMON_MEMORY_TRACKING 0
+	#else
+		#define LEMON_MEMORY_TRACKING 1
+	#endif
+#endif
+
+namespace Lemon
+{
+	enum class EMemoryTag : uint8_t
+	{
+		Untagged,
+		Engine,
+		World,
+		// entt component pools and entity lists
+		EntityStorage,
+		Renderer,
+		RHI,
+		Resources,
+		// CPU copies of texture pixels (TextureRawData)
+		TextureData,
+		// CPU copies of vertices and indices
+		MeshData,
+		Editor,
+		Log,
+		Count
+	};
+
+	struct MemoryTagStats
+	{
+		int64_t LiveBytes = 0;
+		int64_t PeakBytes = 0;
+		int64_t LiveAllocations = 0;
+		uint64_t TotalAllocations = 0;
+		// 0 = no budget
+		int64_t BudgetBytes = 0;
+	};
+
+	class LEMON_API MemoryTracker
+	{
+	public:
+		static void* Allocate(size_t size, size_t alignment, EMemoryTag tag);
+		static void Free(void* memory);
+
+		// Tag that untagged allocations on the calling thread are charged to
+		static EMemoryTag GetThreadTag();
+		static void SetThreadTag(EMemoryTag tag);
+
+		static const char* GetTagName(EMemoryTag tag);
+		static MemoryTagStats GetStats(EMemoryTag tag);
+		// Peaks restart from the current live bytes
+		static void ResetPeaks();
+
+		// Warns once each time the live bytes of tag go above budgetBytes, 0 removes the budget
+		static void SetBudget(EMemoryTag tag, int64_t budgetBytes);
+
+		// Log the table every intervalFrames frames, 0 turns the dump off
+		static void SetFrameDumpInterval(uint32_t intervalFrames);
+		static void DumpStats();
+		static std::string GetStatsJson();
+
+		// Budget checks and the periodic dump, called once per frame by Engine::EndOneFrame
+		static void EndFrame();
+	};
+
+	// Charges allocations of the calling thread to tag while alive
+	class MemoryTagScope
+	{
+	public:
+		MemoryTagScope(EMemoryTag tag) :m_PreviousTag(MemoryTracker::GetThreadTag())
+		{
+			MemoryTracker::SetThreadTag(tag);
+		}
+
+		~MemoryTagScope()
+		{
+			MemoryTracker::SetThreadTag(m_PreviousTag);
+		}
+
+		MemoryTagScope(const MemoryTagScope&) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+	private:
+		EMemoryTag m_PreviousTag;
+	};
+
+	// STL allocator charging everything to Tag, independent of the thread tag
+	template<typename T, EMemoryTag Tag>
+	class TaggedStlAllocator
+	{
+	public:
+		using value_type = T;
+
+		template<typename U>
+		struct rebind { using other = TaggedStlAllocator<U, Tag>; };
+
+		TaggedStlAllocator() = default;
+		template<typename U>
+		TaggedStlAllocator(const TaggedStlAllocator<U, Tag>&) noexcept {}
+
+		T* allocate(size_t count) { return static_cast<T*>(MemoryTracker::Allocate(sizeof(T) * count, alignof(T), Tag)); }
+		void deallocate(T* memory, size_t) noexcept { MemoryTracker::Free(memory); }
+
+		template<typename U>
+		bool operator==(const TaggedStlAllocator<U, Tag>&) const noexcept { return true; }
+		template<typename U>
+		bool operator!=(const TaggedStlAllocator<U, Tag>&) const noexcept { return false; }
+	};
+
+	template<typename T, EMemoryTag Tag>
+	using TaggedVector = std::vector<T, TaggedStlAllocator<T, Tag>>;
+}
+
+#define LEMON_MEMORY_CONCAT_IMPL(x, y) x##y
+#define LEMON_MEMORY_CONCAT(x, y) LEMON_MEMORY_CONCAT_IMPL(x, y)
+#define LEMON_MEMORY_SCOPE(tag) ::Lemon::MemoryTagScope LEMON_MEMORY_CONCAT(memoryScope, __LINE__)(::Lemon::EMemoryTag::tag)
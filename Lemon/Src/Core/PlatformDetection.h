@@ -1,3 +1,4 @@
+#pragma once
 // Platform detection using predefined macros
 #ifdef _WIN32
 	/* Windows x64/x86 */
@@ -33,7 +34,6 @@
 #error "Android is not supported!"
 #elif defined(__linux__)
 #define LEMON_PLATFORM_LINUX
-#error "Linux is not supported!"
 #else
 	/* Unknown compiler/platform */
 #error "Unknown platform!"
@@ -1,15 +1,28 @@
 #include "LemonPCH.h"
 #include "SystemManager.h"
+#include "JobSystem.h"
 
 namespace Lemon
 {
+	uint32_t SystemTypeIndex::Next()
+	{
+		static std::atomic<uint32_t> s_NextIndex = 0;
+		return s_NextIndex++;
+	}
+
+	SystemManager::SystemManager() = default;
+
 	SystemManager::~SystemManager()
 	{
+		m_StageHandles.clear();
+
 		// Loop in reverse registration order to avoid dependency conflicts
 		for (size_t i = m_Systems.size() - 1; i > 0; i--)
 		{
+			std::replace(m_SystemLookup.begin(), m_SystemLookup.end(), m_Systems[i].get(), static_cast<ISystem*>(nullptr));
 			m_Systems[i].reset();
 		}
+		m_SystemLookup.clear();
 		m_Systems.clear();
 	}
 
@@ -18,21 +31,186 @@ namespace Lemon
 		auto result = true;
 		for (const auto& system : m_Systems)
 		{
+			MemoryTagScope memoryScope(system->GetMemoryTag());
 			if (!system->Initialize())
 			{
 				LEMON_CORE_ERROR("Failed to initialize {0}", typeid(*system).name());
 				result = false;
 			}
 		}
+
+		m_JobSystem = GetSystem<JobSystem>();
+		BuildSchedule();
+		LEMON_CORE_INFO("System schedule:\n{0}", DumpSchedule());
+
 		return result;
 	}
 
-	void SystemManager::Tick(float deltaTime/* = 0.0f*/)
+	void SystemManager::Tick(float deltaTime/* = 0.0f*/, ESystemTickGroup group/* = ESystemTickGroup::All*/)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		auto isInGroup = [this, group](uint32_t index)
+		{
+			return group == ESystemTickGroup::All || m_Schedule[index].bFixedStep == (group == ESystemTickGroup::FixedStep);
+		};
+
+		for (const auto& stage : m_Stages)
+		{
+			const size_t tickCount = std::count_if(stage.begin(), stage.end(), isInGroup);
+			if (!m_JobSystem || tickCount <= 1)
+			{
+				for (uint32_t index : stage)
+				{
+					if (isInGroup(index))
+					{
+						LEMON_PROFILE_SCOPE(m_Schedule[index].Name.c_str());
+						MemoryTagScope memoryScope(m_Systems[index]->GetMemoryTag());
+						m_Systems[index]->Tick(deltaTime);
+					}
+				}
+				continue;
+			}
+
+			m_StageHandles.clear();
+			for (uint32_t index : stage)
+			{
+				if (isInGroup(index) && !m_Schedule[index].bMainThread)
+				{
+					ISystem* system = m_Systems[index].get();
+					const char* name = m_Schedule[index].Name.c_str();
+					m_StageHandles.emplace_back(m_JobSystem->Schedule([system, name, deltaTime]()
+					{
+						LEMON_PROFILE_SCOPE(name);
+						MemoryTagScope memoryScope(system->GetMemoryTag());
+						system->Tick(deltaTime);
+					}));
+				}
+			}
+			for (uint32_t index : stage)
+			{
+				if (isInGroup(index) && m_Schedule[index].bMainThread)
+				{
+					LEMON_PROFILE_SCOPE(m_Schedule[index].Name.c_str());
+					MemoryTagScope memoryScope(m_Systems[index]->GetMemoryTag());
+					m_Systems[index]->Tick(deltaTime);
+				}
+			}
+			for (const JobHandle& handle : m_StageHandles)
+			{
+				m_JobSystem->Wait(handle);
+			}
+		}
+	}
+
+	std::string SystemManager::DumpSchedule() const
+	{
+		std::stringstream stream;
+		for (size_t stageIndex = 0; stageIndex < m_Stages.size(); stageIndex++)
+		{
+			stream << "Stage " << stageIndex << ":";
+			for (uint32_t index : m_Stages[stageIndex])
+			{
+				const SystemScheduleNode& node = m_Schedule[index];
+				stream << "\n\t" << node.Name;
+				if (node.bMainThread)
+				{
+					stream << " [main thread]";
+				}
+				if (node.bFixedStep)
+				{
+					stream << " [fixed step]";
+				}
+				if (!node.Dependencies.empty())
+				{
+					stream << " (after";
+					for (size_t i = 0; i < node.Dependencies.size(); i++)
+					{
+						stream << (i ? ", " : " ") << m_Schedule[node.Dependencies[i]].Name;
+					}
+					stream << ")";
+				}
+			}
+			stream << "\n";
+		}
+		return stream.str();
+	}
+
+	void SystemManager::BuildSchedule()
 	{
-		for (const auto& subsystem : m_Systems)
+		const uint32_t systemCount = static_cast<uint32_t>(m_Systems.size());
+		m_Schedule.clear();
+		m_Schedule.resize(systemCount);
+
+		for (uint32_t i = 0; i < systemCount; i++)
+		{
+			SystemScheduleNode& node = m_Schedule[i];
+			node.Name = typeid(*m_Systems[i]).name();
+			node.bMainThread = m_SystemAccess[i].bMainThread;
+			node.bFixedStep = m_SystemAccess[i].bFixedStep;
+
+			// Edges only point from earlier to later registrations, so the graph can't have cycles
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (HasConflict(m_SystemAccess[j], m_SystemAccess[i]))
+				{
+					node.Dependencies.push_back(j);
+					node.Stage = (std::max)(node.Stage, m_Schedule[j].Stage + 1);
+				}
+			}
+		}
+
+		// Declaring access to a system that was never registered is most likely a typo
+		for (uint32_t i = 0; i < systemCount; i++)
 		{
-			subsystem->Tick(deltaTime);
+			const SystemAccess& access = m_SystemAccess[i];
+			for (const auto* types : { &access.Reads, &access.Writes })
+			{
+				for (const std::type_index& type : *types)
+				{
+					bool bRegistered = false;
+					for (const auto& system : m_Systems)
+					{
+						bRegistered |= std::type_index(typeid(*system)) == type;
+					}
+					if (!bRegistered)
+					{
+						LEMON_CORE_WARN("{0} declares access to unregistered system {1}", m_Schedule[i].Name, type.name());
+					}
+				}
+			}
+		}
+
+		m_Stages.clear();
+		for (uint32_t i = 0; i < systemCount; i++)
+		{
+			if (m_Schedule[i].Stage >= m_Stages.size())
+			{
+				m_Stages.resize(m_Schedule[i].Stage + 1);
+			}
+			m_Stages[m_Schedule[i].Stage].push_back(i);
 		}
 	}
 
-}
\ No newline at end of file
+	bool SystemManager::HasConflict(const SystemAccess& first, const SystemAccess& second)
+	{
+		if (first.bExclusive || second.bExclusive)
+		{
+			return true;
+		}
+
+		auto intersects = [](const std::vector<std::type_index>& lhs, const std::vector<std::type_index>& rhs)
+		{
+			for (const std::type_index& type : lhs)
+			{
+				if (std::find(rhs.begin(), rhs.end(), type) != rhs.end())
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+
+		return intersects(first.Writes, second.Reads) || intersects(first.Writes, second.Writes) || intersects(first.Reads, second.Writes);
+	}
+}
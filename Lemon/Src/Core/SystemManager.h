@@ -1,45 +1,100 @@
 #pragma once
+#include <string>
 #include "ISystem.h"
 #include "Log/Log.h"
 
 namespace Lemon
 {
+	class JobSystem;
+	class JobHandle;
+
+	enum class ESystemTickGroup
+	{
+		All,
+		FixedStep,		// only systems registered with SystemAccess::FixedStep
+		VariableStep	// everything else
+	};
+
+	// One system in the resolved tick schedule, indices follow registration order
+	struct SystemScheduleNode
+	{
+		std::string Name;
+		uint32_t Stage = 0;
+		bool bMainThread = false;
+		bool bFixedStep = false;
+		std::vector<uint32_t> Dependencies;
+	};
+
+	// Dense per-type index for system classes, handed out the first time a type is queried or registered
+	class LEMON_API SystemTypeIndex
+	{
+	public:
+		template<typename T>
+		static uint32_t Get()
+		{
+			static const uint32_t index = Next();
+			return index;
+		}
+
+	private:
+		static uint32_t Next();
+	};
+
 	class LEMON_API SystemManager
 	{
 	public:
-		SystemManager() = default;
+		SystemManager();
 		~SystemManager();
 
 		//Register System
 		template <class T>
-		void RegisterSystem(Engine* engine)
+		void RegisterSystem(Engine* engine, SystemAccess access = SystemAccess())
 		{
 			ValidateSystemType<T>();
 			m_Systems.emplace_back(CreateRef<T>(engine));
+			access.Writes.emplace_back(typeid(T));
+			m_SystemAccess.emplace_back(std::move(access));
+
+			const uint32_t typeIndex = SystemTypeIndex::Get<T>();
+			if (typeIndex >= m_SystemLookup.size())
+			{
+				m_SystemLookup.resize(typeIndex + 1, nullptr);
+			}
+			m_SystemLookup[typeIndex] = m_Systems.back().get();
 		}
 
-		// Initialize subsystems
+		// Initialize subsystems and build the tick schedule
 		bool Initialize();
 
 		template<typename T>
 		T* GetSystem() const
 		{
 			ValidateSystemType<T>();
-			for (const auto& system : m_Systems)
-			{
-				if (system)
-				{
-					if (typeid(T) == typeid(*system))
-						return static_cast<T*>(system.get());
-				}
-			}
-			return nullptr;
+			const uint32_t typeIndex = SystemTypeIndex::Get<T>();
+			return typeIndex < m_SystemLookup.size() ? static_cast<T*>(m_SystemLookup[typeIndex]) : nullptr;
 		}
 	
-		// Tick
-		void Tick(float deltaTime = 0.0f);
+		// Tick, stage by stage, systems of one stage run concurrently on the JobSystem
+		void Tick(float deltaTime = 0.0f, ESystemTickGroup group = ESystemTickGroup::All);
+
+		//====Schedule====//
+		const std::vector<SystemScheduleNode>& GetSchedule() const { return m_Schedule; }
+		const std::vector<std::vector<uint32_t>>& GetScheduleStages() const { return m_Stages; }
+		std::string DumpSchedule() const;
+
+	private:
+		void BuildSchedule();
+		static bool HasConflict(const SystemAccess& first, const SystemAccess& second);
 
 	private:
 		std::vector<Ref<ISystem>> m_Systems;
+		std::vector<SystemAccess> m_SystemAccess;
+		// Indexed by SystemTypeIndex, null for types that are not registered
+		std::vector<ISystem*> m_SystemLookup;
+
+		std::vector<SystemScheduleNode> m_Schedule;
+		std::vector<std::vector<uint32_t>> m_Stages;
+		JobSystem* m_JobSystem = nullptr;
+		std::vector<JobHandle> m_StageHandles;
 	};
-}
\ No newline at end of file
+}
@@ -1,5 +1,13 @@
 #include "LemonPCH.h"
 #include "Timer.h"
+#include <thread>
+#include <cmath>
+#include <fstream>
+
+#ifdef LEMON_PLATFORM_WINDOW
+	#include <mmsystem.h>
+	#pragma comment(lib, "winmm.lib") // timeBeginPeriod
+#endif
 
 using namespace std;
 
@@ -12,9 +20,24 @@ namespace Lemon
 		m_LastFrameTime = chrono::high_resolution_clock::now();
 	}
 
-	void Timer::Tick(float deltaTime)
+	Timer::~Timer()
+	{
+		SetFrameRateLimit(0.0);
+
+		if (!m_FrameTimeStatsDumpPath.empty())
+		{
+			ofstream stream(m_FrameTimeStatsDumpPath, ios::out | ios::trunc);
+			stream << GetFrameTimeStatsJson();
+		}
+	}
+
+	void Timer::BeginFrame()
 	{
-		m_GameTime += deltaTime;
+		if (m_FramePacingStats.TargetFrameTimeMs > 0.0)
+		{
+			WaitForTargetFrameTime();
+		}
+
 		// Get time
 		m_LastFrameTime = m_CurrentFrameTime;
 		m_CurrentFrameTime = chrono::high_resolution_clock::now();
@@ -22,7 +45,210 @@ namespace Lemon
 		// Compute durations
 		chrono::duration<double, milli> timeDelta = m_CurrentFrameTime - m_LastFrameTime;
 
-		m_DeltaTimeMs = static_cast<double>(timeDelta.count());
+		const double measuredDeltaMs = static_cast<double>(timeDelta.count());
+
+		// the first delta spans engine initialization, not a frame
+		if (!m_bFirstFrame)
+		{
+			RecordFrameTime(measuredDeltaMs);
+		}
+		m_bFirstFrame = false;
+
+		m_DeltaTimeMs = m_NextDeltaTimeMs >= 0.0 ? m_NextDeltaTimeMs : measuredDeltaMs;
+		m_NextDeltaTimeMs = -1.0;
+
+		if (m_FramePacingStats.TargetFrameTimeMs > 0.0)
+		{
+			FramePacingStats& stats = m_FramePacingStats;
+			stats.LastJitterMs = std::abs(measuredDeltaMs - stats.TargetFrameTimeMs);
+			stats.JitterMs += (stats.LastJitterMs - stats.JitterMs) * 0.05;
+			stats.MaxJitterMs = (std::max)(stats.MaxJitterMs, stats.LastJitterMs);
+		}
+
+		if (!m_bFixedTimestep)
+		{
+			m_GameTime += m_DeltaTimeMs / 1000.0;
+			m_PendingFixedSteps = 0;
+			m_InterpolationAlpha = 1.0f;
+			return;
+		}
+
+		m_Accumulator += m_DeltaTimeMs / 1000.0;
+
+		// Spiral of death: a frame slower than the steps it has to simulate would make the next frame even slower
+		const double maxAccumulated = m_FixedStepSec * m_MaxFixedStepsPerFrame;
+		if (m_Accumulator > maxAccumulated)
+		{
+			m_DroppedTimeSec += m_Accumulator - maxAccumulated;
+			m_Accumulator = maxAccumulated;
+		}
+
+		m_PendingFixedSteps = static_cast<uint32_t>(m_Accumulator / m_FixedStepSec);
+		m_Accumulator -= m_PendingFixedSteps * m_FixedStepSec;
+		m_InterpolationAlpha = static_cast<float>(m_Accumulator / m_FixedStepSec);
+	}
+
+	void Timer::SetFrameRateLimit(double framesPerSecond)
+	{
+		const bool bLimit = framesPerSecond > 0.0;
+		m_FramePacingStats.TargetFrameTimeMs = bLimit ? 1000.0 / framesPerSecond : 0.0;
+
+#ifdef LEMON_PLATFORM_WINDOW
+		// The default scheduler tick of ~15.6 ms is far too coarse to sleep with
+		if (bLimit != m_bHighResolutionSleep)
+		{
+			bLimit ? timeBeginPeriod(1) : timeEndPeriod(1);
+		}
+#endif
+		m_bHighResolutionSleep = bLimit;
+	}
+
+	void Timer::ResetFramePacingStats()
+	{
+		const double targetFrameTimeMs = m_FramePacingStats.TargetFrameTimeMs;
+		m_FramePacingStats = FramePacingStats();
+		m_FramePacingStats.TargetFrameTimeMs = targetFrameTimeMs;
+	}
+
+	void Timer::WaitForTargetFrameTime()
+	{
+		using Clock = chrono::high_resolution_clock;
+		FramePacingStats& stats = m_FramePacingStats;
+
+		// m_CurrentFrameTime is still the start of the previous frame
+		const Clock::time_point target = m_CurrentFrameTime +
+			chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(stats.TargetFrameTimeMs));
+
+		// Coarse part: let the OS sleep until shortly before the target
+		const Clock::time_point wakeUp = target - chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(m_SpinMarginMs));
+		if (Clock::now() < wakeUp)
+		{
+			this_thread::sleep_until(wakeUp);
+
+			const double overshootMs = (std::max)(0.0, chrono::duration<double, milli>(Clock::now() - wakeUp).count());
+			stats.SleepOvershootMs += (overshootMs - stats.SleepOvershootMs) * 0.05;
+			stats.MaxSleepOvershootMs = (std::max)(stats.MaxSleepOvershootMs, overshootMs);
+
+			// Keep enough margin to absorb a typical late wake up, bounded so the spin never eats a whole core
+			m_SpinMarginMs = (std::min)((std::max)(stats.SleepOvershootMs * 2.0 + 0.2, 0.5), 4.0);
+		}
+
+		// Fine part: spin for the tail
+		const Clock::time_point spinStart = Clock::now();
+		while (Clock::now() < target)
+		{
+		}
+		stats.SpinTimeMs = chrono::duration<double, milli>(Clock::now() - spinStart).count();
+	}
+
+	void Timer::RecordFrameTime(double frameTimeMs)
+	{
+		if (m_FrameHistoryCount == FrameHistorySize)
+		{
+			// evict the oldest sample from the histogram
+			m_Histogram[GetHistogramBucket(m_FrameHistory[m_FrameHistoryNext])]--;
+		}
+		else
+		{
+			m_FrameHistoryCount++;
+		}
+
+		m_FrameHistory[m_FrameHistoryNext] = static_cast<float>(frameTimeMs);
+		m_FrameHistoryNext = (m_FrameHistoryNext + 1) % FrameHistorySize;
+		m_Histogram[GetHistogramBucket(frameTimeMs)]++;
+
+		m_TotalFrameCount++;
+		if (frameTimeMs > m_HitchThresholdMs)
+		{
+			m_TotalHitchCount++;
+		}
+	}
+
+	uint32_t Timer::GetHistogramBucket(double frameTimeMs)
+	{
+		if (frameTimeMs < FrameTimeStats::HistogramBaseMs * std::exp2(0.5))
+		{
+			return 0;
+		}
+		const double bucket = std::floor(std::log2(frameTimeMs / FrameTimeStats::HistogramBaseMs) * 2.0);
+		return static_cast<uint32_t>((std::min)(bucket, static_cast<double>(FrameTimeStats::HistogramBuckets - 1)));
 	}
 
-}
\ No newline at end of file
+	FrameTimeStats Timer::GetFrameTimeStats() const
+	{
+		FrameTimeStats stats;
+		stats.FrameCount = m_FrameHistoryCount;
+		stats.HitchThresholdMs = m_HitchThresholdMs;
+		stats.TotalHitchCount = m_TotalHitchCount;
+		stats.TotalFrameCount = m_TotalFrameCount;
+		stats.Histogram = m_Histogram;
+		if (m_FrameHistoryCount == 0)
+		{
+			return stats;
+		}
+
+		const uint32_t count = m_FrameHistoryCount;
+		double sum = 0.0;
+		stats.MinMs = m_FrameHistory[0];
+		stats.MaxMs = m_FrameHistory[0];
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const double frameTimeMs = m_FrameHistory[i];
+			sum += frameTimeMs;
+			stats.MinMs = (std::min)(stats.MinMs, frameTimeMs);
+			stats.MaxMs = (std::max)(stats.MaxMs, frameTimeMs);
+			stats.WindowHitchCount += frameTimeMs > m_HitchThresholdMs ? 1 : 0;
+		}
+		stats.MeanMs = sum / count;
+
+		// nearest-rank percentiles, each selection only partially sorts the scratch copy
+		copy(m_FrameHistory.begin(), m_FrameHistory.begin() + count, m_SortScratch.begin());
+		auto percentile = [this, count](double fraction)
+		{
+			const uint32_t rank = (std::min)(count - 1, static_cast<uint32_t>(std::ceil(fraction * count)) - 1);
+			nth_element(m_SortScratch.begin(), m_SortScratch.begin() + rank, m_SortScratch.begin() + count);
+			return static_cast<double>(m_SortScratch[rank]);
+		};
+		stats.P50Ms = percentile(0.50);
+		stats.P95Ms = percentile(0.95);
+		stats.P99Ms = percentile(0.99);
+
+		return stats;
+	}
+
+	void Timer::ResetFrameTimeStats()
+	{
+		m_FrameHistoryNext = 0;
+		m_FrameHistoryCount = 0;
+		m_Histogram.fill(0);
+		m_TotalHitchCount = 0;
+		m_TotalFrameCount = 0;
+	}
+
+	std::string Timer::GetFrameTimeStatsJson() const
+	{
+		const FrameTimeStats stats = GetFrameTimeStats();
+
+		stringstream stream;
+		stream << "{\n";
+		stream << "\t\"frameCount\": " << stats.FrameCount << ",\n";
+		stream << "\t\"totalFrameCount\": " << stats.TotalFrameCount << ",\n";
+		stream << "\t\"minMs\": " << stats.MinMs << ",\n";
+		stream << "\t\"maxMs\": " << stats.MaxMs << ",\n";
+		stream << "\t\"meanMs\": " << stats.MeanMs << ",\n";
+		stream << "\t\"p50Ms\": " << stats.P50Ms << ",\n";
+		stream << "\t\"p95Ms\": " << stats.P95Ms << ",\n";
+		stream << "\t\"p99Ms\": " << stats.P99Ms << ",\n";
+		stream << "\t\"hitchThresholdMs\": " << stats.HitchThresholdMs << ",\n";
+		stream << "\t\"windowHitchCount\": " << stats.WindowHitchCount << ",\n";
+		stream << "\t\"totalHitchCount\": " << stats.TotalHitchCount << ",\n";
+		stream << "\t\"histogram\": [";
+		for (uint32_t bucket = 0; bucket < FrameTimeStats::HistogramBuckets; bucket++)
+		{
+			stream << (bucket ? ", " : "") << "{\"minMs\": " << FrameTimeStats::GetBucketLowerBoundMs(bucket)
+				<< ", \"count\": " << stats.Histogram[bucket] << "}";
+		}
+		stream << "]\n}\n";
+		return stream.str();
+	}
+}
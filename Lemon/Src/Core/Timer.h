@@ -1,28 +1,148 @@
 #pragma once
 #include "Core.h"
 #include <chrono>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
 #include "ISystem.h"
 
 namespace Lemon
 {
+	struct FramePacingStats
+	{
+		double TargetFrameTimeMs = 0.0;
+		// |frame time - target| of the last paced frame, and its running average
+		double LastJitterMs = 0.0;
+		double JitterMs = 0.0;
+		double MaxJitterMs = 0.0;
+		// How much later than requested the OS sleep returned, running average and worst case
+		double SleepOvershootMs = 0.0;
+		double MaxSleepOvershootMs = 0.0;
+		// Time busy waited for the tail of the last frame
+		double SpinTimeMs = 0.0;
+	};
+
+	// Rolling statistics over the last FrameHistorySize frames
+	struct FrameTimeStats
+	{
+		// Log2 buckets with two buckets per octave starting at HistogramBaseMs, the last one catches everything above
+		static constexpr uint32_t HistogramBuckets = 24;
+		static constexpr double HistogramBaseMs = 0.25;
+		static double GetBucketLowerBoundMs(uint32_t bucket) { return bucket == 0 ? 0.0 : HistogramBaseMs * std::exp2(bucket * 0.5); }
+
+		uint32_t FrameCount = 0;
+		double MinMs = 0.0;
+		double MaxMs = 0.0;
+		double MeanMs = 0.0;
+		double P50Ms = 0.0;
+		double P95Ms = 0.0;
+		double P99Ms = 0.0;
+
+		double HitchThresholdMs = 0.0;
+		// hitches inside the window and since the last reset
+		uint32_t WindowHitchCount = 0;
+		uint64_t TotalHitchCount = 0;
+		uint64_t TotalFrameCount = 0;
+
+		std::array<uint32_t, HistogramBuckets> Histogram = {};
+	};
+
 	class LEMON_API Timer : public ISystem
 	{
 	public:
 		Timer(Engine* engine);
-		~Timer() = default;
+		~Timer();
 
-		void Tick(float deltaTime) override;
+		// Measures the frame, called by Engine at the start of every frame before any system ticks
+		void BeginFrame();
 
 		auto GetDeltaTimeSec()  const { return static_cast<float>(m_DeltaTimeMs / 1000.0); }
+		double GetDeltaTimeMs() const { return m_DeltaTimeMs; }
+
+		// Replay: the next BeginFrame simulates with this delta instead of the measured one.
+		// Frame time statistics and pacing keep using the measured time
+		void SetNextDeltaTimeMs(double deltaTimeMs) { m_NextDeltaTimeMs = deltaTimeMs; }
 
+		// Simulation time, advances by whole fixed steps in fixed timestep mode
 		double GetGameTime() const { return m_GameTime;}
+
+		//====Fixed Timestep====//
+		void SetFixedTimestep(bool bEnable) { m_bFixedTimestep = bEnable; m_Accumulator = 0.0; }
+		bool IsFixedTimestep() const { return m_bFixedTimestep; }
+		void SetFixedStepRate(double stepsPerSecond) { m_FixedStepSec = 1.0 / stepsPerSecond; }
+		float GetFixedStepSec() const { return static_cast<float>(m_FixedStepSec); }
+		// Frames that would need more steps than this drop the excess time instead of falling further behind
+		void SetMaxFixedStepsPerFrame(uint32_t maxSteps) { m_MaxFixedStepsPerFrame = (std::max)(1u, maxSteps); }
+
+		// Number of fixed steps to simulate this frame
+		uint32_t GetPendingFixedSteps() const { return m_PendingFixedSteps; }
+		// Called after each simulated step
+		void AdvanceFixedStep() { m_GameTime += m_FixedStepSec; }
+		// How far rendering is between the last two simulated steps, 1 when not in fixed timestep mode
+		float GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+		// Simulation time thrown away by the spiral-of-death clamp
+		double GetDroppedTimeSec() const { return m_DroppedTimeSec; }
+
+		//====Frame Pacing====//
+		// Cap the frame rate, BeginFrame sleeps and then spins until the target frame time is reached. 0 disables the limiter
+		void SetFrameRateLimit(double framesPerSecond);
+		double GetTargetFrameTimeMs() const { return m_FramePacingStats.TargetFrameTimeMs; }
+		const FramePacingStats& GetFramePacingStats() const { return m_FramePacingStats; }
+		void ResetFramePacingStats();
+
+		//====Frame Time Statistics====//
+		static constexpr uint32_t FrameHistorySize = 1024;
+		// Frames slower than this count as hitches
+		void SetHitchThresholdMs(double thresholdMs) { m_HitchThresholdMs = thresholdMs; }
+		FrameTimeStats GetFrameTimeStats() const;
+		void ResetFrameTimeStats();
+		std::string GetFrameTimeStatsJson() const;
+		// When set, the stats are written to this file when the Timer is destroyed
+		void SetFrameTimeStatsDumpPath(const std::string& filePath) { m_FrameTimeStatsDumpPath = filePath; }
+
+	private:
+		void WaitForTargetFrameTime();
+		void RecordFrameTime(double frameTimeMs);
+		static uint32_t GetHistogramBucket(double frameTimeMs);
+
 	private:
 		// Frame time
 		std::chrono::high_resolution_clock::time_point m_CurrentFrameTime;
 		std::chrono::high_resolution_clock::time_point m_LastFrameTime;
 		
 		double m_DeltaTimeMs = 0.0f;
+		// Negative when the measured delta is used
+		double m_NextDeltaTimeMs = -1.0;
 
 		double m_GameTime = 0.0;
+
+		// Fixed timestep
+		bool m_bFixedTimestep = false;
+		double m_FixedStepSec = 1.0 / 60.0;
+		uint32_t m_MaxFixedStepsPerFrame = 8;
+		double m_Accumulator = 0.0;
+		uint32_t m_PendingFixedSteps = 0;
+		float m_InterpolationAlpha = 1.0f;
+		double m_DroppedTimeSec = 0.0;
+
+		// Frame pacing
+		FramePacingStats m_FramePacingStats;
+		// Wake up this long before the target and spin the rest, adapts to the measured sleep overshoot
+		double m_SpinMarginMs = 2.0;
+		bool m_bHighResolutionSleep = false;
+
+		// Frame time statistics
+		std::array<float, FrameHistorySize> m_FrameHistory = {};
+		uint32_t m_FrameHistoryNext = 0;
+		uint32_t m_FrameHistoryCount = 0;
+		std::array<uint32_t, FrameTimeStats::HistogramBuckets> m_Histogram = {};
+		// scratch for the percentile selection, avoids allocating per query
+		mutable std::array<float, FrameHistorySize> m_SortScratch = {};
+		double m_HitchThresholdMs = 50.0;
+		uint64_t m_TotalHitchCount = 0;
+		uint64_t m_TotalFrameCount = 0;
+		bool m_bFirstFrame = true;
+		std::string m_FrameTimeStatsDumpPath;
 	};
-}
\ No newline at end of file
+}
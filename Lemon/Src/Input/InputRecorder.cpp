@@ -0,0 +1,280 @@
+#include "LemonPCH.h"
+#include "InputRecorder.h"
+#include "Core/Engine.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+
+namespace Lemon
+{
+	namespace
+	{
+		constexpr uint32_t RecordingMagic = 0x4352494C; // "LIRC"
+		constexpr uint32_t RecordingVersion = 2;
+		// magic, version, frame count
+		constexpr std::streamoff FrameCountOffset = sizeof(uint32_t) * 2;
+
+		enum ERecordedSection : uint8_t
+		{
+			Section_Keys				= 1 << 0,
+			Section_KeysPreviousFrame	= 1 << 1,
+			Section_MousePosition		= 1 << 2,
+			Section_MouseDelta			= 1 << 3,
+			Section_MouseWheel			= 1 << 4,
+			// Not a section, the value itself
+			Section_Focused				= 1 << 5,
+			Section_WindowSize			= 1 << 6,
+		};
+
+		using KeyBits = std::array<uint64_t, 2>;
+
+		KeyBits PackKeys(const std::array<bool, 99>& keys)
+		{
+			KeyBits bits = {};
+			for (uint32_t i = 0; i < keys.size(); i++)
+			{
+				if (keys[i])
+				{
+					bits[i / 64] |= uint64_t(1) << (i % 64);
+				}
+			}
+			return bits;
+		}
+
+		void UnpackKeys(const KeyBits& bits, std::array<bool, 99>& keys)
+		{
+			for (uint32_t i = 0; i < keys.size(); i++)
+			{
+				keys[i] = (bits[i / 64] >> (i % 64)) & 1;
+			}
+		}
+
+		template<typename T>
+		void Write(std::ofstream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template<typename T>
+		bool Read(std::ifstream& stream, T& value)
+		{
+			return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+		}
+	}
+
+	InputRecorder::InputRecorder(Engine* engine) : m_Engine(engine)
+	{
+	}
+
+	InputRecorder::~InputRecorder()
+	{
+		Stop();
+	}
+
+	bool InputRecorder::StartRecording(const std::string& filePath)
+	{
+		Stop();
+
+		m_RecordStream.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_RecordStream)
+		{
+			LEMON_CORE_ERROR("Could not open input recording {0}", filePath);
+			return false;
+		}
+
+		Write(m_RecordStream, RecordingMagic);
+		Write(m_RecordStream, RecordingVersion);
+		// Patched by Stop
+		Write(m_RecordStream, uint32_t(0));
+
+		m_bRecording = true;
+		m_FrameIndex = 0;
+		m_PreviousState = InputState();
+		m_WindowWidth = 0;
+		m_WindowHeight = 0;
+		LEMON_CORE_INFO("Recording input to {0}", filePath);
+		return true;
+	}
+
+	bool InputRecorder::StartReplay(const std::string& filePath)
+	{
+		Stop();
+
+		m_ReplayStream.open(filePath, std::ios::in | std::ios::binary);
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		if (!m_ReplayStream || !Read(m_ReplayStream, magic) || !Read(m_ReplayStream, version) || !Read(m_ReplayStream, m_FrameCount)
+			|| magic != RecordingMagic || version != RecordingVersion)
+		{
+			LEMON_CORE_ERROR("Could not read input recording {0}", filePath);
+			m_ReplayStream.close();
+			return false;
+		}
+
+		m_bReplaying = true;
+		m_bReplayFinished = false;
+		m_FrameIndex = 0;
+		m_PreviousState = InputState();
+		m_WindowWidth = 0;
+		m_WindowHeight = 0;
+		m_bHasWindowSize = false;
+		m_Engine->GetSystem<InputSystem>()->SetReplaying(true);
+		LEMON_CORE_INFO("Replaying {0} frames of input from {1}", m_FrameCount, filePath);
+		return true;
+	}
+
+	void InputRecorder::Stop()
+	{
+		if (m_bRecording)
+		{
+			m_RecordStream.seekp(FrameCountOffset);
+			Write(m_RecordStream, m_FrameIndex);
+			m_RecordStream.close();
+			m_bRecording = false;
+			LEMON_CORE_INFO("Recorded {0} frames of input", m_FrameIndex);
+		}
+
+		if (m_bReplaying)
+		{
+			m_ReplayStream.close();
+			m_bReplaying = false;
+			m_Engine->GetSystem<InputSystem>()->SetReplaying(false);
+		}
+	}
+
+	void InputRecorder::BeginReplayFrame()
+	{
+		if (!m_bReplaying)
+		{
+			return;
+		}
+
+		if (m_FrameIndex >= m_FrameCount)
+		{
+			FinishReplay();
+			return;
+		}
+
+		uint8_t sections = 0;
+		double deltaTimeMs = 0.0;
+		if (!Read(m_ReplayStream, sections) || !Read(m_ReplayStream, deltaTimeMs))
+		{
+			LEMON_CORE_ERROR("Input recording ends early at frame {0} of {1}", m_FrameIndex, m_FrameCount);
+			FinishReplay();
+			return;
+		}
+
+		InputState& state = m_PreviousState;
+		KeyBits keyBits;
+		if ((sections & Section_Keys) && Read(m_ReplayStream, keyBits))
+		{
+			UnpackKeys(keyBits, state.Keys);
+		}
+		if ((sections & Section_KeysPreviousFrame) && Read(m_ReplayStream, keyBits))
+		{
+			UnpackKeys(keyBits, state.KeysPreviousFrame);
+		}
+		if (sections & Section_MousePosition)
+		{
+			Read(m_ReplayStream, state.MousePosition.x);
+			Read(m_ReplayStream, state.MousePosition.y);
+		}
+		if (sections & Section_MouseDelta)
+		{
+			Read(m_ReplayStream, state.MouseDelta.x);
+			Read(m_ReplayStream, state.MouseDelta.y);
+		}
+		if (sections & Section_MouseWheel)
+		{
+			Read(m_ReplayStream, state.MouseWheelDelta);
+		}
+		state.bIsFocused = (sections & Section_Focused) != 0;
+
+		if ((sections & Section_WindowSize) && Read(m_ReplayStream, m_WindowWidth) && Read(m_ReplayStream, m_WindowHeight))
+		{
+			// Resize as the recorded window did, OverrideWindowData fills in the size
+			m_bHasWindowSize = true;
+			WindowData windowData = m_Engine->GetWindowData();
+			windowData.Message = 0;
+			windowData.Wparam = 0;
+			windowData.Lparam = 0;
+			m_Engine->SetWindowData(windowData);
+		}
+
+		m_Engine->GetSystem<Timer>()->SetNextDeltaTimeMs(deltaTimeMs);
+		m_Engine->GetSystem<InputSystem>()->SetState(state);
+		m_FrameIndex++;
+	}
+
+	void InputRecorder::RecordFrame()
+	{
+		if (!m_bRecording)
+		{
+			return;
+		}
+
+		const InputState state = m_Engine->GetSystem<InputSystem>()->GetState();
+		const InputState& previous = m_PreviousState;
+		// The first frame writes every section, the replay starts from the same default state
+		const bool bFirstFrame = m_FrameIndex == 0;
+
+		uint8_t sections = state.bIsFocused ? Section_Focused : 0;
+		if (bFirstFrame || state.Keys != previous.Keys) sections |= Section_Keys;
+		if (bFirstFrame || state.KeysPreviousFrame != previous.KeysPreviousFrame) sections |= Section_KeysPreviousFrame;
+		if (bFirstFrame || state.MousePosition != previous.MousePosition) sections |= Section_MousePosition;
+		if (bFirstFrame || state.MouseDelta != previous.MouseDelta) sections |= Section_MouseDelta;
+		if (bFirstFrame || state.MouseWheelDelta != previous.MouseWheelDelta) sections |= Section_MouseWheel;
+		const WindowData& windowData = m_Engine->GetWindowData();
+		if (bFirstFrame || windowData.Width != m_WindowWidth || windowData.Height != m_WindowHeight) sections |= Section_WindowSize;
+
+		Write(m_RecordStream, sections);
+		Write(m_RecordStream, m_Engine->GetSystem<Timer>()->GetDeltaTimeMs());
+		if (sections & Section_Keys)
+		{
+			Write(m_RecordStream, PackKeys(state.Keys));
+		}
+		if (sections & Section_KeysPreviousFrame)
+		{
+			Write(m_RecordStream, PackKeys(state.KeysPreviousFrame));
+		}
+		if (sections & Section_MousePosition)
+		{
+			Write(m_RecordStream, state.MousePosition.x);
+			Write(m_RecordStream, state.MousePosition.y);
+		}
+		if (sections & Section_MouseDelta)
+		{
+			Write(m_RecordStream, state.MouseDelta.x);
+			Write(m_RecordStream, state.MouseDelta.y);
+		}
+		if (sections & Section_MouseWheel)
+		{
+			Write(m_RecordStream, state.MouseWheelDelta);
+		}
+		if (sections & Section_WindowSize)
+		{
+			Write(m_RecordStream, windowData.Width);
+			Write(m_RecordStream, windowData.Height);
+		}
+
+		m_PreviousState = state;
+		m_WindowWidth = windowData.Width;
+		m_WindowHeight = windowData.Height;
+		m_FrameIndex++;
+	}
+
+	void InputRecorder::OverrideWindowData(WindowData& windowData) const
+	{
+		if (m_bReplaying && m_bHasWindowSize)
+		{
+			windowData.Width = m_WindowWidth;
+			windowData.Height = m_WindowHeight;
+		}
+	}
+
+	void InputRecorder::FinishReplay()
+	{
+		LEMON_CORE_INFO("Input replay finished after {0} frames", m_FrameIndex);
+		Stop();
+		m_bReplayFinished = true;
+	}
+}
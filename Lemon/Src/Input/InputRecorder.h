@@ -0,0 +1,70 @@
+#pragma once
+//= INCLUDES ==================
+#include <fstream>
+#include <string>
+#include "Core/Core.h"
+#include "InputSystem.h"
+//=============================
+
+namespace Lemon
+{
+	class Engine;
+	struct WindowData;
+
+	// Records the InputSystem state, the window size and the simulation delta of every frame to a file, and plays them back.
+	// A replay of the same build and scene simulates the same frames regardless of the machine's frame rate.
+	// During a replay the recorded window size is applied through Engine::SetWindowData and overrides the live window's.
+	//
+	// File: header { 'LIRC', version, frameCount }, then per frame { flags, deltaMs, changed sections }.
+	// A section (keys, previous keys, mouse position, ...) is only written when it differs from the previous frame.
+	class LEMON_API InputRecorder
+	{
+	public:
+		InputRecorder(Engine* engine);
+		~InputRecorder();
+
+		bool StartRecording(const std::string& filePath);
+		bool StartReplay(const std::string& filePath);
+		// Finishes the file of a recording, or abandons a replay
+		void Stop();
+
+		bool IsRecording() const { return m_bRecording; }
+		bool IsReplaying() const { return m_bReplaying; }
+		// Set once a replay has played all its frames
+		bool IsReplayFinished() const { return m_bReplayFinished; }
+
+		// Frames recorded or replayed so far, and the frames in the replayed file
+		uint32_t GetFrameIndex() const { return m_FrameIndex; }
+		uint32_t GetFrameCount() const { return m_FrameCount; }
+
+		// Called by Engine::Tick before Timer::BeginFrame, applies the next recorded frame
+		void BeginReplayFrame();
+		// Called by Engine::Tick after Timer::BeginFrame, writes the frame's delta and input
+		void RecordFrame();
+		// Called by Engine::SetWindowData, replaces the live window size with the recorded one while replaying
+		void OverrideWindowData(WindowData& windowData) const;
+
+	private:
+		void FinishReplay();
+
+	private:
+		Engine* m_Engine;
+
+		std::ofstream m_RecordStream;
+		std::ifstream m_ReplayStream;
+
+		bool m_bRecording = false;
+		bool m_bReplaying = false;
+		bool m_bReplayFinished = false;
+
+		uint32_t m_FrameIndex = 0;
+		uint32_t m_FrameCount = 0;
+
+		// Sections are delta encoded against this
+		InputState m_PreviousState;
+		float m_WindowWidth = 0;
+		float m_WindowHeight = 0;
+		// A replay has read the size of the first frame
+		bool m_bHasWindowSize = false;
+	};
+}
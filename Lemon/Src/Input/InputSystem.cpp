@@ -0,0 +1,27 @@
+#include "LemonPCH.h"
+#include "InputSystem.h"
+
+namespace Lemon
+{
+	InputState InputSystem::GetState() const
+	{
+		InputState state;
+		state.Keys = m_Keys;
+		state.KeysPreviousFrame = m_KeysPreviousFrame;
+		state.MousePosition = m_MousePosition;
+		state.MouseDelta = m_MouseDelta;
+		state.MouseWheelDelta = m_MouseWheelDelta;
+		state.bIsFocused = m_bIsFocused;
+		return state;
+	}
+
+	void InputSystem::SetState(const InputState& state)
+	{
+		m_Keys = state.Keys;
+		m_KeysPreviousFrame = state.KeysPreviousFrame;
+		m_MousePosition = state.MousePosition;
+		m_MouseDelta = state.MouseDelta;
+		m_MouseWheelDelta = state.MouseWheelDelta;
+		m_bIsFocused = state.bIsFocused;
+	}
+}
@@ -55,11 +55,22 @@ namespace Lemon
 		Right_Shoulder
 	};
 
+	// Everything InputSystem exposes for a frame, InputRecorder records and replays it
+	struct InputState
+	{
+		std::array<bool, 99> Keys = {};
+		std::array<bool, 99> KeysPreviousFrame = {};
+		glm::vec2 MousePosition = { 0, 0 };
+		glm::vec2 MouseDelta = { 0, 0 };
+		float MouseWheelDelta = 0;
+		bool bIsFocused = true;
+	};
+
 	class LEMON_API InputSystem : public ISystem
 	{
 	public:
 		InputSystem(Engine* engine);
-		~InputSystem() = default;
+		~InputSystem();
 
 		void OnWindowData(WindowData windowData);
 		//= ISubsystem ======================
@@ -79,6 +90,13 @@ namespace Lemon
 		const glm::vec2& GetMouseDelta() const { return m_MouseDelta; }
 
 		bool IsFocused() const { return m_bIsFocused; }
+
+		//====Record / Replay====//
+		InputState GetState() const;
+		void SetState(const InputState& state);
+		// While replaying, window messages no longer update the state, only SetState does
+		void SetReplaying(bool bReplaying) { m_bReplaying = bReplaying; }
+		bool IsReplaying() const { return m_bReplaying; }
 	private:
 		// Keys
 		std::array<bool, 99> m_Keys;
@@ -95,5 +113,8 @@ namespace Lemon
 		bool m_bNewframe = false;
 
 		bool m_bIsFocused = true;
+		bool m_bReplaying = false;
+
+		DelegateHandle m_WindowMessageHandle;
 	};
 }
@@ -0,0 +1,37 @@
+//= INCLUDES =======================
+#include "LemonPCH.h"
+#include "Input/Input.h"
+#ifdef API_INPUT_NULL
+#include "Input/InputSystem.h"
+#include "Core/Engine.h"
+//==================================
+
+namespace Lemon
+{
+	// Headless platforms have no window messages, every key reads as released
+	InputSystem::InputSystem(Engine* engine) : ISystem(engine)
+	{
+		m_Keys.fill(false);
+		m_KeysPreviousFrame.fill(false);
+	}
+
+	InputSystem::~InputSystem()
+	{
+	}
+
+	void InputSystem::OnWindowData(WindowData windowData)
+	{
+	}
+
+	void InputSystem::Tick(float deltaTime)
+	{
+	}
+
+	void InputSystem::EndOneFrame()
+	{
+		m_KeysPreviousFrame = m_Keys;
+		m_MouseDelta = glm::vec2(0, 0);
+	}
+}
+
+#endif
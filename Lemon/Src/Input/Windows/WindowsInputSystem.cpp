@@ -44,12 +44,23 @@ namespace Lemon
 		}
 
 		// Bind delegate
-		m_Engine->OnWindowMessageEvent.AddDynamic(this, &InputSystem::OnWindowData);
+		m_WindowMessageHandle = m_Engine->OnWindowMessageEvent.AddDynamic(this, &InputSystem::OnWindowData);
 	
 	}
+
+	InputSystem::~InputSystem()
+	{
+		m_Engine->OnWindowMessageEvent.Remove(m_WindowMessageHandle);
+	}
 	
 	void InputSystem::OnWindowData(WindowData windowData)
 	{
+		// The recording provides the state, live input must not leak in
+		if (m_bReplaying)
+		{
+			return;
+		}
+
 		HWND windowHandle = static_cast<HWND>(windowData.Handle);
 		m_bIsFocused = windowHandle == ::GetActiveWindow();
 
@@ -17,6 +17,10 @@
 #include "Utils/FileUtils.h"
 
 // Profiler
+#include "Profiler/Profiler.h"
+
+// Memory
+#include "Core/MemoryTracker.h"
 
 #ifdef LEMON_PLATFORM_WINDOW
 	#include <Windows.h>
@@ -1,22 +1,445 @@
 #include "LemonPCH.h"
 #include "Log.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// This ignores all warnings raised inside External headers
+#pragma warning(push, 0)
+#include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#pragma warning(pop)
 
 namespace Lemon
 {
 	std::shared_ptr<spdlog::logger> Logger::s_CoreLogger;
 	std::shared_ptr<spdlog::logger> Logger::s_ClientLogger;
 
-	void Logger::Init()
+	namespace
 	{
+		/**
+		 * Bounded MPSC ring (Vyukov): each slot carries a sequence number telling producers whether it is free
+		 * and the consumer whether it has been published.
+		 */
+		class LogRing
+		{
+		public:
+			static constexpr uint64_t Capacity = 8192;
+
+			LogRing() :m_Slots(new Slot[Capacity])
+			{
+				for (uint64_t i = 0; i < Capacity; i++)
+				{
+					m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+				}
+			}
+
+			LogRecord* BeginPush(uint64_t& outTicket)
+			{
+				uint64_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					Slot& slot = m_Slots[position & (Capacity - 1)];
+					const int64_t difference = static_cast<int64_t>(slot.Sequence.load(std::memory_order_acquire)) - static_cast<int64_t>(position);
+					if (difference == 0)
+					{
+						if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							outTicket = position;
+							return &slot.Record;
+						}
+					}
+					else if (difference < 0)
+					{
+						// full, the consumer has not released this slot yet
+						return nullptr;
+					}
+					else
+					{
+						position = m_EnqueuePosition.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			void EndPush(uint64_t ticket)
+			{
+				m_Slots[ticket & (Capacity - 1)].Sequence.store(ticket + 1, std::memory_order_release);
+			}
+
+			const LogRecord* BeginPop()
+			{
+				Slot& slot = m_Slots[m_DequeuePosition & (Capacity - 1)];
+				if (slot.Sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1)
+				{
+					return nullptr;
+				}
+				return &slot.Record;
+			}
+
+			void EndPop()
+			{
+				m_Slots[m_DequeuePosition & (Capacity - 1)].Sequence.store(m_DequeuePosition + Capacity, std::memory_order_release);
+				m_DequeuePosition++;
+				m_PoppedCount.store(m_DequeuePosition, std::memory_order_release);
+			}
+
+			uint64_t GetPushedCount() const { return m_EnqueuePosition.load(std::memory_order_acquire); }
+			uint64_t GetPoppedCount() const { return m_PoppedCount.load(std::memory_order_acquire); }
+
+		private:
+			struct Slot
+			{
+				std::atomic<uint64_t> Sequence;
+				LogRecord Record;
+			};
+
+			Scope<Slot[]> m_Slots;
+			alignas(64) std::atomic<uint64_t> m_EnqueuePosition = 0;
+			alignas(64) uint64_t m_DequeuePosition = 0;
+			std::atomic<uint64_t> m_PoppedCount = 0;
+		};
+
+		struct LogBackend
+		{
+			~LogBackend() { Stop(); }
+
+			void Stop()
+			{
+				if (!Worker.joinable())
+				{
+					return;
+				}
+				bRunning = false;
+				WakeWorker();
+				Worker.join();
+			}
+
+			// Called after publishing a record or changing bRunning. Pairs with the fence in WorkerLoop:
+			// either the worker sees the change before parking or we see it parked and wake it up
+			void WakeWorker()
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (bWorkerParked.load(std::memory_order_relaxed))
+				{
+					{
+						std::lock_guard<std::mutex> lock(WakeMutex);
+						bWorkerParked = false;
+					}
+					WakeCondition.notify_one();
+				}
+			}
+
+			std::atomic<bool> bInitialized = false;
+			std::atomic<bool> bAsync = false;
+			std::atomic<bool> bRunning = false;
+			// The worker found the ring empty and sleeps until a producer wakes it
+			std::atomic<bool> bWorkerParked = false;
+			std::atomic<uint64_t> DroppedCount = 0;
+
+			Scope<LogRing> Ring;
+			std::thread Worker;
+			std::mutex WakeMutex;
+			std::condition_variable WakeCondition;
+		};
+
+		LogBackend& GetBackend()
+		{
+			static LogBackend s_Backend;
+			return s_Backend;
+		}
+
+		// Scratch record for synchronous logging
+		thread_local LogRecord s_SyncRecord;
+
+		struct LogArg
+		{
+			ELogArgType Type = ELogArgType::Int;
+			union
+			{
+				int64_t Int;
+				uint64_t UInt;
+				double Double;
+				bool Bool;
+				char Char;
+			};
+			std::string_view String;
+		};
+
+		constexpr uint32_t MaxLogArgs = 32;
+
+		template<typename V>
+		V ReadValue(const uint8_t* data)
+		{
+			V value;
+			std::memcpy(&value, data, sizeof(V));
+			return value;
+		}
+
+		// Decodes the payload, returns the format stored in front of the arguments
+		std::string_view DecodeRecord(const LogRecord& record, LogArg* args, uint32_t& outArgCount)
+		{
+			std::string_view format;
+			bool bFormatPending = true;
+			outArgCount = 0;
+
+			uint32_t offset = 0;
+			while (offset < record.PayloadUsed)
+			{
+				LogArg arg;
+				arg.Type = static_cast<ELogArgType>(record.Payload[offset++]);
+				const uint8_t* data = &record.Payload[offset];
+				switch (arg.Type)
+				{
+				case ELogArgType::Int:		arg.Int = ReadValue<int64_t>(data); offset += sizeof(int64_t); break;
+				case ELogArgType::UInt:		arg.UInt = ReadValue<uint64_t>(data); offset += sizeof(uint64_t); break;
+				case ELogArgType::Pointer:	arg.UInt = ReadValue<uint64_t>(data); offset += sizeof(uint64_t); break;
+				case ELogArgType::Double:	arg.Double = ReadValue<double>(data); offset += sizeof(double); break;
+				case ELogArgType::Bool:		arg.Bool = ReadValue<bool>(data); offset += sizeof(bool); break;
+				case ELogArgType::Char:		arg.Char = ReadValue<char>(data); offset += sizeof(char); break;
+				case ELogArgType::String:
+				{
+					const uint16_t length = ReadValue<uint16_t>(data);
+					arg.String = std::string_view(reinterpret_cast<const char*>(data + sizeof(uint16_t)), length);
+					offset += sizeof(uint16_t) + length;
+					break;
+				}
+				}
+
+				if (bFormatPending)
+				{
+					format = arg.String;
+					bFormatPending = false;
+				}
+				else if (outArgCount < MaxLogArgs)
+				{
+					args[outArgCount++] = arg;
+				}
+			}
+			return format;
+		}
+
+		void AppendArg(std::string& out, const LogArg& arg, std::string_view spec)
+		{
+			// supports [.precision][type], enough for the {0:.2f} / {0:x} style used in the engine
+			int precision = -1;
+			char type = 0;
+			size_t i = 0;
+			if (i < spec.size() && spec[i] == '.')
+			{
+				precision = 0;
+				for (i++; i < spec.size() && spec[i] >= '0' && spec[i] <= '9'; i++)
+				{
+					precision = precision * 10 + (spec[i] - '0');
+				}
+			}
+			if (i < spec.size())
+			{
+				type = spec[i];
+			}
+
+			char buffer[64];
+			int length = 0;
+			switch (arg.Type)
+			{
+			case ELogArgType::Int:
+				length = snprintf(buffer, sizeof(buffer), type == 'x' ? "%llx" : type == 'X' ? "%llX" : "%lld", static_cast<long long>(arg.Int));
+				break;
+			case ELogArgType::UInt:
+				length = snprintf(buffer, sizeof(buffer), type == 'x' ? "%llx" : type == 'X' ? "%llX" : "%llu", static_cast<unsigned long long>(arg.UInt));
+				break;
+			case ELogArgType::Pointer:
+				length = snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(arg.UInt));
+				break;
+			case ELogArgType::Double:
+				if (precision >= 0)
+				{
+					length = snprintf(buffer, sizeof(buffer), type == 'e' ? "%.*e" : type == 'g' ? "%.*g" : "%.*f", precision, arg.Double);
+				}
+				else
+				{
+					length = snprintf(buffer, sizeof(buffer), "%g", arg.Double);
+				}
+				break;
+			case ELogArgType::Bool:
+				out += arg.Bool ? "true" : "false";
+				return;
+			case ELogArgType::Char:
+				out += arg.Char;
+				return;
+			case ELogArgType::String:
+				out.append(arg.String.data(), arg.String.size());
+				return;
+			}
+			out.append(buffer, (std::max)(0, (std::min)(length, static_cast<int>(sizeof(buffer)) - 1)));
+		}
+
+		// fmt style "{}", "{N}" and "{N:spec}" substitution
+		void FormatRecord(const LogRecord& record, std::string& out)
+		{
+			LogArg args[MaxLogArgs];
+			uint32_t argCount = 0;
+			const std::string_view format = DecodeRecord(record, args, argCount);
+
+			out.clear();
+			uint32_t nextArg = 0;
+			for (size_t i = 0; i < format.size(); i++)
+			{
+				const char c = format[i];
+				if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+				{
+					out += c;
+					i++;
+					continue;
+				}
+				if (c != '{')
+				{
+					out += c;
+					continue;
+				}
+
+				const size_t close = format.find('}', i);
+				if (close == std::string_view::npos)
+				{
+					out.append(format.substr(i));
+					break;
+				}
+
+				std::string_view field = format.substr(i + 1, close - i - 1);
+				std::string_view spec;
+				const size_t colon = field.find(':');
+				if (colon != std::string_view::npos)
+				{
+					spec = field.substr(colon + 1);
+					field = field.substr(0, colon);
+				}
+
+				uint32_t argIndex = 0;
+				if (field.empty())
+				{
+					argIndex = nextArg++;
+				}
+				else
+				{
+					for (char digit : field)
+					{
+						argIndex = argIndex * 10 + (digit - '0');
+					}
+				}
+
+				if (argIndex < argCount)
+				{
+					AppendArg(out, args[argIndex], spec);
+				}
+				else
+				{
+					out.append(format.substr(i, close - i + 1));
+				}
+				i = close;
+			}
+
+			if (record.bTruncated)
+			{
+				out += " [truncated]";
+			}
+		}
+
+		void WriteRecord(const LogRecord& record, std::string& scratch)
+		{
+			FormatRecord(record, scratch);
+
+			const std::shared_ptr<spdlog::logger>& logger = record.Logger == ELoggerType::Core ? Logger::GetCoreLogger() : Logger::GetClientLogger();
+			if (!logger)
+			{
+				return;
+			}
+
+			switch (record.Level)
+			{
+			case ELogLevel::Trace:	logger->trace("{}", scratch); break;
+			case ELogLevel::Info:	logger->info("{}", scratch); break;
+			case ELogLevel::Warn:	logger->warn("{}", scratch); break;
+			case ELogLevel::Error:	logger->error("{}", scratch); break;
+			case ELogLevel::Fatal:	logger->critical("{}", scratch); break;
+			}
+		}
+
+		void WorkerLoop()
+		{
+			LEMON_MEMORY_SCOPE(Log);
+			LogBackend& backend = GetBackend();
+			std::string scratch;
+			scratch.reserve(512);
+			uint64_t reportedDropped = 0;
+			// Records tend to come in bursts, a few yields before parking save the producers most wakeups
+			constexpr uint32_t MaxIdleSpins = 64;
+			uint32_t idleSpins = 0;
+
+			for (;;)
+			{
+				if (const LogRecord* record = backend.Ring->BeginPop())
+				{
+					WriteRecord(*record, scratch);
+					backend.Ring->EndPop();
+					idleSpins = 0;
+					continue;
+				}
+
+				const uint64_t dropped = backend.DroppedCount.load(std::memory_order_relaxed);
+				if (dropped != reportedDropped && Logger::GetCoreLogger())
+				{
+					Logger::GetCoreLogger()->warn("Log ring full, dropped {} records", dropped - reportedDropped);
+					reportedDropped = dropped;
+				}
+
+				if (!backend.bRunning)
+				{
+					break;
+				}
+
+				if (idleSpins < MaxIdleSpins)
+				{
+					idleSpins++;
+					std::this_thread::yield();
+					continue;
+				}
+
+				// Park until a producer publishes a record, records pushed meanwhile are caught by the second look
+				std::unique_lock<std::mutex> lock(backend.WakeMutex);
+				backend.bWorkerParked = true;
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (backend.Ring->BeginPop() || !backend.bRunning)
+				{
+					backend.bWorkerParked = false;
+					continue;
+				}
+				backend.WakeCondition.wait(lock, [&backend]() { return !backend.bWorkerParked.load(std::memory_order_relaxed); });
+			}
+		}
+	}
+
+	void Logger::Init(ELogMode mode /*= ELogMode::Async*/, const std::string& filePath /*= "Lemon.log"*/, bool bConsole /*= true*/)
+	{
+		LogBackend& backend = GetBackend();
+		if (backend.bInitialized)
+		{
+			Shutdown();
+			spdlog::drop("Lemon");
+			spdlog::drop("APP");
+		}
+
 		std::vector<spdlog::sink_ptr> logSinks;
-		logSinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
-		logSinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("Lemon.log", true));
+		if (bConsole)
+		{
+			logSinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+			logSinks.back()->set_pattern("%^[%T] %n: %v%$");
+		}
+		logSinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(filePath, true));
+		logSinks.back()->set_pattern("[%T] [%l] %n: %v");
 
 		spdlog::set_pattern("%^[%T] %n: %v%$");
-		logSinks[0]->set_pattern("%^[%T] %n: %v%$");
-		logSinks[1]->set_pattern("[%T] [%l] %n: %v");
 		s_CoreLogger = std::make_shared<spdlog::logger>("Lemon", begin(logSinks), end(logSinks));
 		spdlog::register_logger(s_CoreLogger);
 		s_CoreLogger->set_level(spdlog::level::trace);
@@ -27,9 +450,90 @@ namespace Lemon
 		s_ClientLogger->set_level(spdlog::level::trace);
 		s_ClientLogger->flush_on(spdlog::level::trace);
 
+		if (mode == ELogMode::Async)
+		{
+			if (!backend.Ring)
+			{
+				backend.Ring = CreateScope<LogRing>();
+			}
+			backend.bRunning = true;
+			backend.Worker = std::thread(WorkerLoop);
+		}
+		backend.bAsync = mode == ELogMode::Async;
+		backend.bInitialized = true;
+
 		//s_CoreLogger = spdlog::stdout_color_mt("LEMON-ENGINE");
 		//s_CoreLogger->set_level(spdlog::level::trace);
 		//s_ClientLogger = spdlog::stdout_color_mt("APP");
 		//s_ClientLogger->set_level(spdlog::level::trace);
 	}
-}
\ No newline at end of file
+
+	void Logger::Shutdown()
+	{
+		LogBackend& backend = GetBackend();
+		// from here on records are written synchronously so late messages from destructors are not lost
+		backend.bAsync = false;
+		Flush();
+		backend.Stop();
+	}
+
+	void Logger::Flush()
+	{
+		LogBackend& backend = GetBackend();
+		if (backend.Ring && backend.Worker.joinable())
+		{
+			const uint64_t target = backend.Ring->GetPushedCount();
+			while (backend.Ring->GetPoppedCount() < target)
+			{
+				std::this_thread::yield();
+			}
+		}
+		if (s_CoreLogger)
+		{
+			s_CoreLogger->flush();
+		}
+		if (s_ClientLogger)
+		{
+			s_ClientLogger->flush();
+		}
+	}
+
+	uint64_t Logger::GetDroppedCount()
+	{
+		return GetBackend().DroppedCount.load(std::memory_order_relaxed);
+	}
+
+	LogRecord* Logger::BeginRecord(uint64_t& outTicket)
+	{
+		LogBackend& backend = GetBackend();
+		if (!backend.bInitialized)
+		{
+			return nullptr;
+		}
+		if (!backend.bAsync)
+		{
+			outTicket = ~0ull;
+			return &s_SyncRecord;
+		}
+
+		LogRecord* record = backend.Ring->BeginPush(outTicket);
+		if (!record)
+		{
+			backend.DroppedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		return record;
+	}
+
+	void Logger::CommitRecord(uint64_t ticket)
+	{
+		if (ticket == ~0ull)
+		{
+			thread_local std::string s_Scratch;
+			WriteRecord(s_SyncRecord, s_Scratch);
+			return;
+		}
+		LogBackend& backend = GetBackend();
+		backend.Ring->EndPush(ticket);
+		backend.WakeWorker();
+	}
+}
@@ -1,51 +1,126 @@
 #pragma once
 #include "Core/Core.h"
-// This ignores all warnings raised inside External headers
-#pragma warning(push, 0)
-#include <spdlog/spdlog.h>
-#include <spdlog/fmt/ostr.h>
-#pragma warning(pop)
+#include "LogRecord.h"
+
+namespace spdlog
+{
+	class logger;
+}
+
+//====Compile-time level stripping====//
+// Calls below LEMON_LOG_ACTIVE_LEVEL are removed entirely, define it in the build to override the per configuration default
+#define LEMON_LOG_LEVEL_TRACE	0
+#define LEMON_LOG_LEVEL_INFO	1
+#define LEMON_LOG_LEVEL_WARN	2
+#define LEMON_LOG_LEVEL_ERROR	3
+#define LEMON_LOG_LEVEL_FATAL	4
+#define LEMON_LOG_LEVEL_OFF		5
+
+#ifndef LEMON_LOG_ACTIVE_LEVEL
+	#if defined(LEMON_DEBUG)
+		#define LEMON_LOG_ACTIVE_LEVEL LEMON_LOG_LEVEL_TRACE
+	#elif defined(LEMON_RELEASE)
+		#define LEMON_LOG_ACTIVE_LEVEL LEMON_LOG_LEVEL_WARN
+	#else
+		#define LEMON_LOG_ACTIVE_LEVEL LEMON_LOG_LEVEL_ERROR
+	#endif
+#endif
 
 namespace Lemon
 {
+	enum class ELogMode
+	{
+		// Format and write on the calling thread
+		Sync,
+		// Push a binary record into a lock-free ring, a background thread formats and writes it
+		Async
+	};
+
 	class LEMON_API Logger
 	{
 	public:
-		static void Init();
+		static void Init(ELogMode mode = ELogMode::Async, const std::string& filePath = "Lemon.log", bool bConsole = true);
+		// Drains pending records and stops the logging thread, later calls log synchronously
+		static void Shutdown();
+		// Blocks until every record submitted so far has been written
+		static void Flush();
+
+		template<typename Format, typename... Args>
+		static void Log(ELoggerType logger, ELogLevel level, const Format& format, const Args&... args)
+		{
+			uint64_t ticket = 0;
+			LogRecord* record = BeginRecord(ticket);
+			if (!record)
+			{
+				return;
+			}
+
+			LogRecordWriter writer(*record);
+			writer.WriteFormat(format);
+			(writer.WriteArg(args), ...);
+			record->Logger = logger;
+			record->Level = level;
+			CommitRecord(ticket);
 
-		inline static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
-		inline static std::shared_ptr<spdlog::logger>& GetClientLogger() { return s_ClientLogger; }
+			if (level == ELogLevel::Fatal)
+			{
+				Flush();
+			}
+		}
+
+		// Records thrown away because the ring was full
+		static uint64_t GetDroppedCount();
+
+		static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
+		static std::shared_ptr<spdlog::logger>& GetClientLogger() { return s_ClientLogger; }
+
+	private:
+		// nullptr when the logger is not initialized or the ring is full
+		static LogRecord* BeginRecord(uint64_t& outTicket);
+		static void CommitRecord(uint64_t ticket);
 
 	private:
 		static std::shared_ptr<spdlog::logger> s_CoreLogger;
 		static std::shared_ptr<spdlog::logger> s_ClientLogger;
 	};
+}
+
+#if LEMON_LOG_ACTIVE_LEVEL <= LEMON_LOG_LEVEL_TRACE
+	#define LEMON_CORE_TRACE(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Core, ::Lemon::ELogLevel::Trace, __VA_ARGS__)
+	#define LEMON_CLIENT_TRACE(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Client, ::Lemon::ELogLevel::Trace, __VA_ARGS__)
+#else
+	#define LEMON_CORE_TRACE(...)			(void)0
+	#define LEMON_CLIENT_TRACE(...)			(void)0
+#endif
+
+#if LEMON_LOG_ACTIVE_LEVEL <= LEMON_LOG_LEVEL_INFO
+	#define LEMON_CORE_INFO(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Core, ::Lemon::ELogLevel::Info, __VA_ARGS__)
+	#define LEMON_CLIENT_INFO(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Client, ::Lemon::ELogLevel::Info, __VA_ARGS__)
+#else
+	#define LEMON_CORE_INFO(...)			(void)0
+	#define LEMON_CLIENT_INFO(...)			(void)0
+#endif
+
+#if LEMON_LOG_ACTIVE_LEVEL <= LEMON_LOG_LEVEL_WARN
+	#define LEMON_CORE_WARN(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Core, ::Lemon::ELogLevel::Warn, __VA_ARGS__)
+	#define LEMON_CLIENT_WARN(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Client, ::Lemon::ELogLevel::Warn, __VA_ARGS__)
+#else
+	#define LEMON_CORE_WARN(...)			(void)0
+	#define LEMON_CLIENT_WARN(...)			(void)0
+#endif
 
-#if LEMON_DEBUG
-	//define Core Some Macro
-#define LEMON_CORE_TRACE(...)    ::Lemon::Logger::GetCoreLogger()->trace(__VA_ARGS__)
-#define LEMON_CORE_INFO(...)     ::Lemon::Logger::GetCoreLogger()->info(__VA_ARGS__)
-#define LEMON_CORE_WARN(...)     ::Lemon::Logger::GetCoreLogger()->warn(__VA_ARGS__)
-#define LEMON_CORE_ERROR(...)    ::Lemon::Logger::GetCoreLogger()->error(__VA_ARGS__)
-#define LEMON_CORE_FATAL(...)    ::Lemon::Logger::GetCoreLogger()->critical(__VA_ARGS__)
-
-#define LEMON_CLIENT_TRACE(...)          ::Lemon::Logger::GetClientLogger()->trace(__VA_ARGS__)
-#define LEMON_CLIENT_INFO(...)           ::Lemon::Logger::GetClientLogger()->info(__VA_ARGS__)
-#define LEMON_CLIENT_WARN(...)           ::Lemon::Logger::GetClientLogger()->warn(__VA_ARGS__)
-#define LEMON_CLIENT_ERROR(...)          ::Lemon::Logger::GetClientLogger()->error(__VA_ARGS__)
-#define LEMON_CLIENT_FATAL(...)          ::Lemon::Logger::GetClientLogger()->critical(__VA_ARGS__)
+#if LEMON_LOG_ACTIVE_LEVEL <= LEMON_LOG_LEVEL_ERROR
+	#define LEMON_CORE_ERROR(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Core, ::Lemon::ELogLevel::Error, __VA_ARGS__)
+	#define LEMON_CLIENT_ERROR(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Client, ::Lemon::ELogLevel::Error, __VA_ARGS__)
 #else
-#define LEMON_CORE_TRACE(...)    
-#define LEMON_CORE_INFO(...)     
-#define LEMON_CORE_WARN(...)     
-#define LEMON_CORE_ERROR(...)    
-#define LEMON_CORE_FATAL(...)    
-
-#define LEMON_CLIENT_TRACE(...)          
-#define LEMON_CLIENT_INFO(...)           
-#define LEMON_CLIENT_WARN(...)           
-#define LEMON_CLIENT_ERROR(...)          
-#define LEMON_CLIENT_FATAL(...)          
+	#define LEMON_CORE_ERROR(...)			(void)0
+	#define LEMON_CLIENT_ERROR(...)			(void)0
+#endif
 
+#if LEMON_LOG_ACTIVE_LEVEL <= LEMON_LOG_LEVEL_FATAL
+	#define LEMON_CORE_FATAL(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Core, ::Lemon::ELogLevel::Fatal, __VA_ARGS__)
+	#define LEMON_CLIENT_FATAL(...)			::Lemon::Logger::Log(::Lemon::ELoggerType::Client, ::Lemon::ELogLevel::Fatal, __VA_ARGS__)
+#else
+	#define LEMON_CORE_FATAL(...)			(void)0
+	#define LEMON_CLIENT_FATAL(...)			(void)0
 #endif
-}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include "Core/Core.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <type_traits>
+
+namespace Lemon
+{
+	enum class ELogLevel : uint8_t
+	{
+		Trace,
+		Info,
+		Warn,
+		Error,
+		Fatal
+	};
+
+	enum class ELoggerType : uint8_t
+	{
+		Core,
+		Client
+	};
+
+	enum class ELogArgType : uint8_t
+	{
+		Int,
+		UInt,
+		Double,
+		Bool,
+		Char,
+		Pointer,
+		String
+	};
+
+	/**
+	 * One log call. The format and the arguments are stored in binary form (type tag + value,
+	 * strings inline, format first) and only turned into text on the logging thread.
+	 */
+	struct LogRecord
+	{
+		static constexpr uint32_t PayloadSize = 240;
+
+		ELoggerType Logger = ELoggerType::Core;
+		ELogLevel Level = ELogLevel::Info;
+		uint8_t ArgCount = 0;
+		bool bTruncated = false;
+		uint16_t PayloadUsed = 0;
+		uint8_t Payload[PayloadSize];
+	};
+
+	class LogRecordWriter
+	{
+	public:
+		LogRecordWriter(LogRecord& record) :m_Record(record)
+		{
+			m_Record.ArgCount = 0;
+			m_Record.bTruncated = false;
+			m_Record.PayloadUsed = 0;
+		}
+
+		// Always copied, a char array can just as well be a stack buffer that is gone before the record is formatted
+		template<typename T>
+		void WriteFormat(const T& format)
+		{
+			if constexpr (std::is_array_v<T>)
+			{
+				WriteString(format, std::strlen(format), false);
+			}
+			else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+			{
+				WriteString(format.data(), format.size(), false);
+			}
+			else
+			{
+				const char* text = format ? format : "";
+				WriteString(text, std::strlen(text), false);
+			}
+		}
+
+		template<typename T>
+		void WriteArg(const T& value)
+		{
+			using Type = std::decay_t<T>;
+			if constexpr (std::is_same_v<Type, bool>)
+			{
+				WriteValue(ELogArgType::Bool, value);
+			}
+			else if constexpr (std::is_same_v<Type, char>)
+			{
+				WriteValue(ELogArgType::Char, value);
+			}
+			else if constexpr (std::is_enum_v<Type>)
+			{
+				WriteArg(static_cast<std::underlying_type_t<Type>>(value));
+			}
+			else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+			{
+				WriteValue(ELogArgType::Int, static_cast<int64_t>(value));
+			}
+			else if constexpr (std::is_integral_v<Type>)
+			{
+				WriteValue(ELogArgType::UInt, static_cast<uint64_t>(value));
+			}
+			else if constexpr (std::is_floating_point_v<Type>)
+			{
+				WriteValue(ELogArgType::Double, static_cast<double>(value));
+			}
+			else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>)
+			{
+				WriteString(value.data(), value.size(), true);
+			}
+			else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+			{
+				const char* text = value;
+				text = text ? text : "(null)";
+				WriteString(text, std::strlen(text), true);
+			}
+			else if constexpr (std::is_pointer_v<Type>)
+			{
+				WriteValue(ELogArgType::Pointer, reinterpret_cast<uint64_t>(value));
+			}
+			else
+			{
+				// Slow path for types that only know how to stream themselves
+				std::ostringstream stream;
+				stream << value;
+				const std::string text = stream.str();
+				WriteString(text.data(), text.size(), true);
+			}
+		}
+
+	private:
+		template<typename V>
+		void WriteValue(ELogArgType type, V value)
+		{
+			if (m_Record.PayloadUsed + 1 + sizeof(V) > LogRecord::PayloadSize)
+			{
+				m_Record.bTruncated = true;
+				return;
+			}
+			m_Record.Payload[m_Record.PayloadUsed++] = static_cast<uint8_t>(type);
+			std::memcpy(&m_Record.Payload[m_Record.PayloadUsed], &value, sizeof(V));
+			m_Record.PayloadUsed += sizeof(V);
+			m_Record.ArgCount++;
+		}
+
+		void WriteString(const char* text, size_t length, bool bIsArg)
+		{
+			constexpr uint32_t headerSize = 1 + sizeof(uint16_t);
+			if (m_Record.PayloadUsed + headerSize > LogRecord::PayloadSize)
+			{
+				m_Record.bTruncated = true;
+				return;
+			}
+
+			const size_t available = LogRecord::PayloadSize - m_Record.PayloadUsed - headerSize;
+			const uint16_t stored = static_cast<uint16_t>(length < available ? length : available);
+			m_Record.bTruncated |= stored < length;
+
+			m_Record.Payload[m_Record.PayloadUsed++] = static_cast<uint8_t>(ELogArgType::String);
+			std::memcpy(&m_Record.Payload[m_Record.PayloadUsed], &stored, sizeof(uint16_t));
+			m_Record.PayloadUsed += sizeof(uint16_t);
+			std::memcpy(&m_Record.Payload[m_Record.PayloadUsed], text, stored);
+			m_Record.PayloadUsed += stored;
+			m_Record.ArgCount += bIsArg ? 1 : 0;
+		}
+
+	private:
+		LogRecord& m_Record;
+	};
+}
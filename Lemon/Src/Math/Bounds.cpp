@@ -0,0 +1,81 @@
+#include "LemonPCH.h"
+#include "Bounds.h"
+
+namespace Lemon
+{
+	AABB AABB::Transformed(const glm::mat4& transform) const
+	{
+		if (!IsValid())
+		{
+			return AABB();
+		}
+
+		// Arvo: the transformed center plus the extents through the absolute rotation/scale part
+		const glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		const glm::vec3 extents = GetExtents();
+		glm::vec3 newExtents;
+		for (int row = 0; row < 3; row++)
+		{
+			newExtents[row] = std::abs(transform[0][row]) * extents.x
+				+ std::abs(transform[1][row]) * extents.y
+				+ std::abs(transform[2][row]) * extents.z;
+		}
+		return AABB(center - newExtents, center + newExtents);
+	}
+
+	bool AABB::IntersectsRay(const Ray& ray, float maxDistance, float& outDistance) const
+	{
+		const glm::vec3 t1 = (Min - ray.Origin) * ray.InvDirection;
+		const glm::vec3 t2 = (Max - ray.Origin) * ray.InvDirection;
+		const glm::vec3 tNear = (glm::min)(t1, t2);
+		const glm::vec3 tFar = (glm::max)(t1, t2);
+		const float enter = (std::max)((std::max)(tNear.x, tNear.y), (std::max)(tNear.z, 0.0f));
+		const float exit = (std::min)((std::min)(tFar.x, tFar.y), (std::min)(tFar.z, maxDistance));
+		if (enter > exit)
+		{
+			return false;
+		}
+		outDistance = enter;
+		return true;
+	}
+
+	Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection)
+	{
+		// Gribb/Hartmann, rows of the column major glm matrix
+		const glm::mat4 rows = glm::transpose(viewProjection);
+		Frustum frustum;
+		frustum.Planes[Left] = rows[3] + rows[0];
+		frustum.Planes[Right] = rows[3] - rows[0];
+		frustum.Planes[Bottom] = rows[3] + rows[1];
+		frustum.Planes[Top] = rows[3] - rows[1];
+		frustum.Planes[Near] = rows[2];
+		frustum.Planes[Far] = rows[3] - rows[2];
+		for (glm::vec4& plane : frustum.Planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return frustum;
+	}
+
+	EFrustumTest Frustum::Test(const AABB& box) const
+	{
+		const glm::vec3 center = box.GetCenter();
+		const glm::vec3 extents = box.GetExtents();
+		EFrustumTest result = EFrustumTest::Inside;
+		for (const glm::vec4& plane : Planes)
+		{
+			const glm::vec3 normal = glm::vec3(plane);
+			const float distance = glm::dot(normal, center) + plane.w;
+			const float radius = glm::dot(glm::abs(normal), extents);
+			if (distance < -radius)
+			{
+				return EFrustumTest::Outside;
+			}
+			if (distance < radius)
+			{
+				result = EFrustumTest::Intersects;
+			}
+		}
+		return result;
+	}
+}
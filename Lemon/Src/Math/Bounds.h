@@ -0,0 +1,93 @@
+#pragma once
+#include "Core/Core.h"
+#include <glm/glm.hpp>
+#include <cfloat>
+
+namespace Lemon
+{
+	struct Ray
+	{
+		Ray() = default;
+		// direction does not have to be normalized, distances along the ray are then in units of its length
+		Ray(const glm::vec3& origin, const glm::vec3& direction)
+			: Origin(origin), Direction(direction), InvDirection(1.0f / direction) {}
+
+		glm::vec3 Origin = glm::vec3(0.0f);
+		glm::vec3 Direction = glm::vec3(0.0f, 0.0f, 1.0f);
+		// Per axis reciprocal for the slab test, infinite along axes the ray is parallel to
+		glm::vec3 InvDirection = glm::vec3(FLT_MAX, FLT_MAX, 1.0f);
+	};
+
+	// Axis aligned box, default constructed it is empty and merging anything into it yields that
+	struct LEMON_API AABB
+	{
+		AABB() = default;
+		AABB(const glm::vec3& min, const glm::vec3& max)
+			: Min(min), Max(max) {}
+
+		glm::vec3 Min = glm::vec3(FLT_MAX);
+		glm::vec3 Max = glm::vec3(-FLT_MAX);
+
+		bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+		float GetSurfaceArea() const
+		{
+			const glm::vec3 size = Max - Min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		void Merge(const glm::vec3& point)
+		{
+			Min = (glm::min)(Min, point);
+			Max = (glm::max)(Max, point);
+		}
+		void Merge(const AABB& other)
+		{
+			Min = (glm::min)(Min, other.Min);
+			Max = (glm::max)(Max, other.Max);
+		}
+		static AABB Union(const AABB& a, const AABB& b) { return AABB((glm::min)(a.Min, b.Min), (glm::max)(a.Max, b.Max)); }
+
+		AABB Expanded(const glm::vec3& margin) const { return AABB(Min - margin, Max + margin); }
+
+		bool Contains(const AABB& other) const
+		{
+			return Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z
+				&& other.Max.x <= Max.x && other.Max.y <= Max.y && other.Max.z <= Max.z;
+		}
+		bool Overlaps(const AABB& other) const
+		{
+			return Min.x <= other.Max.x && other.Min.x <= Max.x
+				&& Min.y <= other.Max.y && other.Min.y <= Max.y
+				&& Min.z <= other.Max.z && other.Min.z <= Max.z;
+		}
+
+		// Box around this one after transform, tight for affine matrices
+		AABB Transformed(const glm::mat4& transform) const;
+
+		// Slab test, outDistance is where the ray enters the box (0 when it starts inside)
+		bool IntersectsRay(const Ray& ray, float maxDistance, float& outDistance) const;
+	};
+
+	enum class EFrustumTest : uint8_t
+	{
+		Outside,
+		Intersects,
+		Inside,
+	};
+
+	// Six planes facing inwards, ax + by + cz + d >= 0 inside
+	struct LEMON_API Frustum
+	{
+		enum EPlane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+		glm::vec4 Planes[PlaneCount];
+
+		// From projection * view with 0..1 depth, as CameraComponent builds it
+		static Frustum FromViewProjection(const glm::mat4& viewProjection);
+
+		// Conservative: boxes near a corner of the frustum may be reported as intersecting
+		EFrustumTest Test(const AABB& box) const;
+		bool Intersects(const AABB& box) const { return Test(box) != EFrustumTest::Outside; }
+	};
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "Core/Core.h"
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define LEMON_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define LEMON_SIMD_SSE2 1
+#endif
+
+namespace Lemon
+{
+	/**
+	 * The widest float vector the build targets: 8 lanes with AVX2, 4 with SSE2, otherwise a plain float.
+	 * Code written against it runs the same on every width, loops step by SimdLanes::Count.
+	 * MulAdd is never fused so results are bit identical to the separate multiply and add.
+	 */
+#if LEMON_SIMD_AVX2
+	struct SimdLanes
+	{
+		static constexpr uint32_t Count = 8;
+		using Float = __m256;
+		using Int = __m256i;
+		using Mask = __m256;
+
+		static const char* Name() { return "AVX2"; }
+
+		static FORCEINLINE Float Splat(float value) { return _mm256_set1_ps(value); }
+		static FORCEINLINE Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+		static FORCEINLINE Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+		static FORCEINLINE Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+		static FORCEINLINE Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+		static FORCEINLINE Float MulAdd(Float a, Float b, Float c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+		static FORCEINLINE Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+		static FORCEINLINE Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+		static FORCEINLINE Float Reciprocal(Float a) { return _mm256_div_ps(_mm256_set1_ps(1.0f), a); }
+
+		static FORCEINLINE Float Load(const float* source) { return _mm256_loadu_ps(source); }
+		static FORCEINLINE void Store(float* dest, Float value) { _mm256_storeu_ps(dest, value); }
+		// source and dest aligned to Count floats
+		static FORCEINLINE Float LoadAligned(const float* source) { return _mm256_load_ps(source); }
+		static FORCEINLINE void StoreAligned(float* dest, Float value) { _mm256_store_ps(dest, value); }
+		static FORCEINLINE Int LoadInt(const uint32_t* source) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)); }
+		static FORCEINLINE void StoreInt(uint32_t* dest, Int value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), value); }
+
+		// Round to nearest
+		static FORCEINLINE Int ToInt(Float a) { return _mm256_cvtps_epi32(a); }
+		static FORCEINLINE Float ToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+		static FORCEINLINE Int AddInt(Int a, int32_t b) { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+		static FORCEINLINE Mask HasBit(Int a, int32_t bit)
+		{
+			const Int bits = _mm256_set1_epi32(bit);
+			return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, bits), bits));
+		}
+
+		static FORCEINLINE Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+		static FORCEINLINE bool Any(Mask mask) { return _mm256_movemask_ps(mask) != 0; }
+		static FORCEINLINE Float Select(Mask mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+		static FORCEINLINE Int SelectInt(Mask mask, Int a, Int b) { return _mm256_blendv_epi8(b, a, _mm256_castps_si256(mask)); }
+	};
+#elif LEMON_SIMD_SSE2
+	struct SimdLanes
+	{
+		static constexpr uint32_t Count = 4;
+		using Float = __m128;
+		using Int = __m128i;
+		using Mask = __m128;
+
+		static const char* Name() { return "SSE2"; }
+
+		static FORCEINLINE Float Splat(float value) { return _mm_set1_ps(value); }
+		static FORCEINLINE Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+		static FORCEINLINE Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+		static FORCEINLINE Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+		static FORCEINLINE Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+		static FORCEINLINE Float MulAdd(Float a, Float b, Float c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static FORCEINLINE Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+		static FORCEINLINE Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+		static FORCEINLINE Float Reciprocal(Float a) { return _mm_div_ps(_mm_set1_ps(1.0f), a); }
+
+		static FORCEINLINE Float Load(const float* source) { return _mm_loadu_ps(source); }
+		static FORCEINLINE void Store(float* dest, Float value) { _mm_storeu_ps(dest, value); }
+		// source and dest aligned to Count floats
+		static FORCEINLINE Float LoadAligned(const float* source) { return _mm_load_ps(source); }
+		static FORCEINLINE void StoreAligned(float* dest, Float value) { _mm_store_ps(dest, value); }
+		static FORCEINLINE Int LoadInt(const uint32_t* source) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)); }
+		static FORCEINLINE void StoreInt(uint32_t* dest, Int value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), value); }
+
+		// Round to nearest
+		static FORCEINLINE Int ToInt(Float a) { return _mm_cvtps_epi32(a); }
+		static FORCEINLINE Float ToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+		static FORCEINLINE Int AddInt(Int a, int32_t b) { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+		static FORCEINLINE Mask HasBit(Int a, int32_t bit)
+		{
+			const Int bits = _mm_set1_epi32(bit);
+			return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, bits), bits));
+		}
+
+		static FORCEINLINE Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+		static FORCEINLINE bool Any(Mask mask) { return _mm_movemask_ps(mask) != 0; }
+		static FORCEINLINE Float Select(Mask mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+		static FORCEINLINE Int SelectInt(Mask mask, Int a, Int b)
+		{
+			const Int intMask = _mm_castps_si128(mask);
+			return _mm_or_si128(_mm_and_si128(intMask, a), _mm_andnot_si128(intMask, b));
+		}
+	};
+#else
+	struct SimdLanes
+	{
+		static constexpr uint32_t Count = 1;
+		using Float = float;
+		using Int = int32_t;
+		using Mask = bool;
+
+		static const char* Name() { return "Scalar"; }
+
+		static FORCEINLINE Float Splat(float value) { return value; }
+		static FORCEINLINE Float Add(Float a, Float b) { return a + b; }
+		static FORCEINLINE Float Sub(Float a, Float b) { return a - b; }
+		static FORCEINLINE Float Mul(Float a, Float b) { return a * b; }
+		static FORCEINLINE Float Div(Float a, Float b) { return a / b; }
+		static FORCEINLINE Float MulAdd(Float a, Float b, Float c) { return a * b + c; }
+		static FORCEINLINE Float Min(Float a, Float b) { return a < b ? a : b; }
+		static FORCEINLINE Float Max(Float a, Float b) { return a > b ? a : b; }
+		static FORCEINLINE Float Reciprocal(Float a) { return 1.0f / a; }
+
+		static FORCEINLINE Float Load(const float* source) { return *source; }
+		static FORCEINLINE void Store(float* dest, Float value) { *dest = value; }
+		static FORCEINLINE Float LoadAligned(const float* source) { return *source; }
+		static FORCEINLINE void StoreAligned(float* dest, Float value) { *dest = value; }
+		static FORCEINLINE Int LoadInt(const uint32_t* source) { return static_cast<Int>(*source); }
+		static FORCEINLINE void StoreInt(uint32_t* dest, Int value) { *dest = static_cast<uint32_t>(value); }
+
+		static FORCEINLINE Int ToInt(Float a) { return static_cast<int32_t>(std::lrint(a)); }
+		static FORCEINLINE Float ToFloat(Int a) { return static_cast<float>(a); }
+		static FORCEINLINE Int AddInt(Int a, int32_t b) { return a + b; }
+		static FORCEINLINE Mask HasBit(Int a, int32_t bit) { return (a & bit) != 0; }
+
+		static FORCEINLINE Mask And(Mask a, Mask b) { return a && b; }
+		static FORCEINLINE bool Any(Mask mask) { return mask; }
+		static FORCEINLINE Float Select(Mask mask, Float a, Float b) { return mask ? a : b; }
+		static FORCEINLINE Int SelectInt(Mask mask, Int a, Int b) { return mask ? a : b; }
+	};
+#endif
+}
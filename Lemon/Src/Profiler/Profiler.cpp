@@ -0,0 +1,194 @@
+#include "LemonPCH.h"
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <mutex>
+
+namespace Lemon
+{
+	std::atomic<bool> Profiler::s_bCapturing = false;
+
+	namespace
+	{
+		struct ProfilerCapture
+		{
+			std::mutex Mutex;
+			// Buffers are never freed so scopes on exiting threads can't dangle
+			std::vector<Scope<ProfileThreadBuffer>> ThreadBuffers;
+
+			std::vector<std::pair<uint32_t, ProfileEvent>> Events;
+			uint64_t LostEvents = 0;
+			uint32_t FramesLeft = 0;
+			uint64_t FrameBeginNs = 0;
+			std::string FilePath;
+		};
+
+		ProfilerCapture& GetCapture()
+		{
+			static ProfilerCapture s_Capture;
+			return s_Capture;
+		}
+
+		const auto s_ProcessStart = std::chrono::steady_clock::now();
+
+		void WriteJsonString(std::ofstream& stream, const char* text)
+		{
+			stream << '"';
+			for (const char* c = text; c && *c; c++)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					stream << '\\';
+				}
+				stream << *c;
+			}
+			stream << '"';
+		}
+	}
+
+	uint64_t Profiler::GetTimeNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_ProcessStart).count();
+	}
+
+	ProfileThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		static thread_local ProfileThreadBuffer* s_ThreadBuffer = nullptr;
+		if (!s_ThreadBuffer)
+		{
+			ProfilerCapture& capture = GetCapture();
+			std::lock_guard<std::mutex> lock(capture.Mutex);
+			capture.ThreadBuffers.emplace_back(CreateScope<ProfileThreadBuffer>());
+			s_ThreadBuffer = capture.ThreadBuffers.back().get();
+			s_ThreadBuffer->ThreadId = static_cast<uint32_t>(capture.ThreadBuffers.size() - 1);
+		}
+		return *s_ThreadBuffer;
+	}
+
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		ProfileThreadBuffer& buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(GetCapture().Mutex);
+		buffer.ThreadName = name;
+	}
+
+	void Profiler::BeginCapture(uint32_t frameCount, const std::string& filePath)
+	{
+		if (IsCapturing() || frameCount == 0)
+		{
+			LEMON_CORE_WARN("Profiler capture already running or zero frames requested");
+			return;
+		}
+
+		ProfilerCapture& capture = GetCapture();
+		{
+			std::lock_guard<std::mutex> lock(capture.Mutex);
+			// Skip whatever was recorded before this capture
+			for (auto& buffer : capture.ThreadBuffers)
+			{
+				buffer->ReadIndex = buffer->GetHead();
+			}
+			capture.Events.clear();
+			capture.LostEvents = 0;
+			capture.FramesLeft = frameCount;
+			capture.FilePath = filePath;
+		}
+		capture.FrameBeginNs = GetTimeNs();
+		s_bCapturing = true;
+	}
+
+	void Profiler::EndFrame()
+	{
+		if (!IsCapturing())
+		{
+			return;
+		}
+
+		ProfilerCapture& capture = GetCapture();
+		GetThreadBuffer().Push({ "Frame", capture.FrameBeginNs, GetTimeNs(), 0 });
+		capture.FrameBeginNs = GetTimeNs();
+
+		DrainThreadBuffers();
+
+		if (--capture.FramesLeft == 0)
+		{
+			s_bCapturing = false;
+			WriteCapture();
+		}
+	}
+
+	void Profiler::DrainThreadBuffers()
+	{
+		ProfilerCapture& capture = GetCapture();
+		std::lock_guard<std::mutex> lock(capture.Mutex);
+		for (auto& buffer : capture.ThreadBuffers)
+		{
+			const uint64_t head = buffer->GetHead();
+			if (head - buffer->ReadIndex > ProfileThreadBuffer::Capacity)
+			{
+				capture.LostEvents += head - buffer->ReadIndex - ProfileThreadBuffer::Capacity;
+				buffer->ReadIndex = head - ProfileThreadBuffer::Capacity;
+			}
+			const uint64_t begin = buffer->ReadIndex;
+			const size_t firstEvent = capture.Events.size();
+			for (; buffer->ReadIndex < head; buffer->ReadIndex++)
+			{
+				capture.Events.emplace_back(buffer->ThreadId, buffer->GetEvent(buffer->ReadIndex));
+			}
+
+			// The producer keeps running. Event i shares its slot with i + Capacity, which may have been written,
+			// or be half written, while we copied, so everything up to headAfterCopy - Capacity is dropped
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t headAfterCopy = buffer->GetHead();
+			if (headAfterCopy - begin >= ProfileThreadBuffer::Capacity)
+			{
+				const uint64_t overwritten = (std::min)(headAfterCopy - begin - ProfileThreadBuffer::Capacity + 1, head - begin);
+				capture.Events.erase(capture.Events.begin() + firstEvent, capture.Events.begin() + firstEvent + static_cast<size_t>(overwritten));
+				capture.LostEvents += overwritten;
+			}
+		}
+	}
+
+	void Profiler::WriteCapture()
+	{
+		ProfilerCapture& capture = GetCapture();
+		std::lock_guard<std::mutex> lock(capture.Mutex);
+
+		std::ofstream stream(capture.FilePath, std::ios::out | std::ios::trunc);
+		if (!stream)
+		{
+			LEMON_CORE_ERROR("Profiler failed to open {0}", capture.FilePath);
+			return;
+		}
+
+		stream << "{\"traceEvents\":[\n";
+		bool bFirst = true;
+		for (const auto& buffer : capture.ThreadBuffers)
+		{
+			if (buffer->ThreadName.empty())
+			{
+				continue;
+			}
+			stream << (bFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->ThreadId << ",\"args\":{\"name\":";
+			WriteJsonString(stream, buffer->ThreadName.c_str());
+			stream << "}}";
+			bFirst = false;
+		}
+
+		stream.precision(3);
+		stream << std::fixed;
+		for (const auto& [threadId, event] : capture.Events)
+		{
+			stream << (bFirst ? "" : ",\n") << "{\"name\":";
+			WriteJsonString(stream, event.Name);
+			stream << ",\"cat\":\"Lemon\",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadId
+				<< ",\"ts\":" << event.BeginNs / 1000.0 << ",\"dur\":" << (event.EndNs - event.BeginNs) / 1000.0
+				<< ",\"args\":{\"depth\":" << event.Depth << "}}";
+			bFirst = false;
+		}
+		stream << "\n]}\n";
+
+		LEMON_CORE_INFO("Profiler wrote {0} events to {1} ({2} lost)", capture.Events.size(), capture.FilePath, capture.LostEvents);
+		capture.Events.clear();
+	}
+}
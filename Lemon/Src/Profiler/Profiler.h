@@ -0,0 +1,131 @@
+#pragma once
+#include "Core/Core.h"
+#include <atomic>
+#include <string>
+
+namespace Lemon
+{
+	struct ProfileEvent
+	{
+		const char* Name = nullptr;
+		uint64_t BeginNs = 0;
+		uint64_t EndNs = 0;
+		uint32_t Depth = 0;
+	};
+
+	/**
+	 * Single producer ring of finished scopes, written only by its owning thread.
+	 * The capture drains it once per frame, when the writer laps the reader the oldest events are lost.
+	 * The events are only allocated by the first push, a thread that is merely named costs a few bytes.
+	 */
+	class ProfileThreadBuffer
+	{
+	public:
+		static constexpr uint32_t Capacity = 1 << 14;
+
+		ProfileThreadBuffer() = default;
+		~ProfileThreadBuffer() { delete[] m_Events.load(std::memory_order_relaxed); }
+
+		ProfileThreadBuffer(const ProfileThreadBuffer&) = delete;
+		ProfileThreadBuffer& operator=(const ProfileThreadBuffer&) = delete;
+
+		void Push(const ProfileEvent& event)
+		{
+			ProfileEvent* events = m_Events.load(std::memory_order_relaxed);
+			if (!events)
+			{
+				// published by the release on m_Head below
+				events = new ProfileEvent[Capacity];
+				m_Events.store(events, std::memory_order_relaxed);
+			}
+			const uint64_t head = m_Head.load(std::memory_order_relaxed);
+			events[head & (Capacity - 1)] = event;
+			m_Head.store(head + 1, std::memory_order_release);
+		}
+
+		uint64_t GetHead() const { return m_Head.load(std::memory_order_acquire); }
+		// Only valid for indices below a head read before
+		const ProfileEvent& GetEvent(uint64_t index) const { return m_Events.load(std::memory_order_relaxed)[index & (Capacity - 1)]; }
+
+	public:
+		uint32_t ThreadId = 0;
+		std::string ThreadName;
+		uint64_t ReadIndex = 0;
+		// current nesting, only touched by the owning thread
+		uint32_t Depth = 0;
+
+	private:
+		std::atomic<uint64_t> m_Head = 0;
+		std::atomic<ProfileEvent*> m_Events = nullptr;
+	};
+
+	class LEMON_API Profiler
+	{
+	public:
+		// Record the next frameCount frames and write them as a Chrome trace_event JSON to filePath (open in chrome://tracing)
+		static void BeginCapture(uint32_t frameCount, const std::string& filePath);
+		static bool IsCapturing() { return s_bCapturing.load(std::memory_order_relaxed); }
+
+		// Frame boundary, called once per frame by Engine::EndOneFrame
+		static void EndFrame();
+
+		// Shown as the thread name in the trace
+		static void SetThreadName(const std::string& name);
+
+		static uint64_t GetTimeNs();
+		static ProfileThreadBuffer& GetThreadBuffer();
+
+	private:
+		static void DrainThreadBuffers();
+		static void WriteCapture();
+
+	private:
+		static std::atomic<bool> s_bCapturing;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name)
+		{
+			if (!Profiler::IsCapturing())
+			{
+				return;
+			}
+			m_Name = name;
+			m_Buffer = &Profiler::GetThreadBuffer();
+			m_Depth = m_Buffer->Depth++;
+			m_BeginNs = Profiler::GetTimeNs();
+		}
+
+		~ProfileScope()
+		{
+			if (!m_Buffer)
+			{
+				return;
+			}
+			m_Buffer->Depth--;
+			m_Buffer->Push({ m_Name, m_BeginNs, Profiler::GetTimeNs(), m_Depth });
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_Name = nullptr;
+		ProfileThreadBuffer* m_Buffer = nullptr;
+		uint64_t m_BeginNs = 0;
+		uint32_t m_Depth = 0;
+	};
+}
+
+#ifndef LEMON_SHIPPING
+	#define LEMON_PROFILE_CONCAT_IMPL(x, y) x##y
+	#define LEMON_PROFILE_CONCAT(x, y) LEMON_PROFILE_CONCAT_IMPL(x, y)
+	// name must outlive the capture, string literals or strings owned by long living objects
+	#define LEMON_PROFILE_SCOPE(name) ::Lemon::ProfileScope LEMON_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define LEMON_PROFILE_FUNCTION() LEMON_PROFILE_SCOPE(__FUNCTION__)
+#else
+	#define LEMON_PROFILE_SCOPE(name)
+	#define LEMON_PROFILE_FUNCTION()
+#endif
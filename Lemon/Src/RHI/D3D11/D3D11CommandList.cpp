@@ -48,7 +48,7 @@ namespace Lemon
 		}
 	}
 
-	void D3D11CommandList::RHIClearRenderTarget(std::vector<Ref<RHITexture2D>> colorTargets, glm::vec4 backgroundColor,
+	void D3D11CommandList::RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor,
 		Ref<RHITexture2D> depthStencilTarget, float depthClear, float stencilClear)
 	{
 		for (int i = 0; i < colorTargets.size(); i++)
@@ -230,7 +230,7 @@ namespace Lemon
 	}
 
 
-	void D3D11CommandList::SetRenderTarget(std::vector<Ref<RHITexture2D>> colorTargets, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	void D3D11CommandList::SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget /*= nullptr*/)
 	{
 		// render targets
 		void* depthStencil = nullptr;
@@ -382,7 +382,7 @@ namespace Lemon
         );
 	}
 
-	void D3D11CommandList::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, std::vector<Ref<RHITexture2D>> mipTextures)
+	void D3D11CommandList::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures)
 	{
 		m_D3D11RHI->SetMipTexture(targetTex, mipIndex, mipWidth, mipHeight, mipTextures);
 	}
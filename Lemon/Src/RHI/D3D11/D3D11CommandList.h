@@ -23,14 +23,14 @@ namespace Lemon
 		virtual void RHIClearRenderTarget(Ref<RHITextureCube> renderTargets, int renderTargetIndex, glm::vec4 backgroundColor,
 			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0)  override;
 
-		virtual void RHIClearRenderTarget(std::vector<Ref<RHITexture2D>> colorTargets, glm::vec4 backgroundColor,
+		virtual void RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor,
 			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
 
 		virtual void SetRenderTarget(Ref<RHITexture2D> colorTarget,Ref<RHITexture2D> depthTarget = nullptr) override; 
 		
 		virtual void SetRenderTarget(Ref<RHITextureCube> colorTargets, int colorTargetIndex, Ref<RHITexture2D> depthTarget = nullptr) override;
 
-		virtual void SetRenderTarget(std::vector<Ref<RHITexture2D>> colorTargets, Ref<RHITexture2D> depthTarget = nullptr) override;
+		virtual void SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget = nullptr) override;
 
 
 		virtual void SetRenderTarget(Ref<RHISwapChain> swapChain, float depthClear = 1.0f, float stencilClear = 0) override;
@@ -53,7 +53,7 @@ namespace Lemon
 		
 		virtual void SetTexture(uint32_t slot, const Ref<RHITexture>& texture) override;
 
-		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, std::vector<Ref<RHITexture2D>> mipTextures) override;
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) override;
 
 		//=======================================================================================================//
 	private:
@@ -56,7 +56,7 @@ namespace Lemon
 		virtual Ref<RHISamplerState> RHICreateSamplerState(const SamplerStateInitializer& initializer) override;
 		
 		// ====Texture Settings====//
-		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, std::vector<Ref<RHITexture2D>> mipTextures) override;
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) override;
 
 
 
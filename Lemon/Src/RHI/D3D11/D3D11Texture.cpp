@@ -95,7 +95,7 @@ namespace Lemon
 		return nullptr;
 	}
 
-	void D3D11DynamicRHI::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, std::vector<Ref<RHITexture2D>> mipTextures)
+	void D3D11DynamicRHI::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures)
 	{
 		D3D11_BOX sourceRegion;
 		int numMips = targetTex->GetNumMip();
@@ -6,14 +6,33 @@
 #elif LEMON_GRAPHICS_D3D12
 
 #endif
+#include "Null/NullDynamicRHI.h"
+#include "Software/SoftwareDynamicRHI.h"
 
 namespace Lemon
 {
 	// Globals.
 	DynamicRHI* g_DynamicRHI = nullptr;
 
+	static ERHIBackend s_RHIBackend = ERHIBackend::Platform;
+
+	void RHISetBackend(ERHIBackend backend)
+	{
+		if (g_DynamicRHI)
+		{
+			LEMON_CORE_WARN("RHISetBackend: the RHI already exists, only applies after the next RHIInit");
+		}
+		s_RHIBackend = backend;
+	}
+
+	ERHIBackend RHIGetBackend()
+	{
+		return s_RHIBackend;
+	}
+
 	void RHIInit()
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		if (!g_DynamicRHI)
 		{
 			g_DynamicRHI = PlatformCreateDynamicRHI();
@@ -26,7 +45,7 @@ namespace Lemon
 
 	void RHIExit()
 	{
-		if (!g_DynamicRHI)
+		if (g_DynamicRHI)
 		{
 			g_DynamicRHI->Shutdown();
 		}
@@ -37,6 +56,15 @@ namespace Lemon
 
 	DynamicRHI* PlatformCreateDynamicRHI()
 	{
+		if (s_RHIBackend == ERHIBackend::Null)
+		{
+			return new NullDynamicRHI();
+		}
+		if (s_RHIBackend == ERHIBackend::Software)
+		{
+			return new SoftwareDynamicRHI();
+		}
+
 #ifdef LEMON_GRAPHICS_D3D11
 		return new D3D11DynamicRHI();
 #endif
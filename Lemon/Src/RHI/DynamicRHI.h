@@ -1,5 +1,6 @@
 #pragma once
 #include "Core/Core.h"
+#include "Core/MemoryTracker.h"
 #include "RHIDeviceAdapter.h"
 #include "RHI.h"
 #include "RHIResources.h"
@@ -67,7 +68,7 @@ namespace Lemon
 		virtual Ref<RHISamplerState> RHICreateSamplerState(const SamplerStateInitializer& initializer) = 0;
 		
 		// ====Texture Settings====//
-		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, std::vector<Ref<RHITexture2D>> mipTextures) = 0;
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) = 0;
 
 
 		//========Just Debug
@@ -90,56 +91,85 @@ namespace Lemon
 
 	extern LEMON_API DynamicRHI* g_DynamicRHI;
 
+	// Which DynamicRHI PlatformCreateDynamicRHI creates, has to be chosen before RHIInit
+	enum class ERHIBackend : uint8_t
+	{
+		// D3D11 on windows, nothing on headless linux
+		Platform,
+		// No device, commands are only recorded (CPU side benchmarks, command count checks)
+		Null,
+		// No device, draws are rasterized on the CPU (golden images, CPU depth passes)
+		Software
+	};
+
+	LEMON_API void RHISetBackend(ERHIBackend backend);
+	LEMON_API ERHIBackend RHIGetBackend();
+
 	/**
 	*	Each platform that utilizes dynamic RHIs should implement this function
 	*	Called to create the instance of the dynamic RHI.
 	*/
 	DynamicRHI* PlatformCreateDynamicRHI();
 
+	// False when there is no RHI (headless builds on the platform backend), GPU resources can not be created then
+	FORCEINLINE bool IsRHIAvailable()
+	{
+		return g_DynamicRHI != nullptr;
+	}
+
 	//===================================RHI Resource Create Helper function==================================//
 
 	FORCEINLINE Ref<RHICommandList> RHICreateCommandList(Renderer* renderer)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateCommandList(renderer);
 	}
 
 	FORCEINLINE Ref<RHISwapChain> RHICreateSwapChain(void* windowHandle, const uint32_t width, const uint32_t height, const ERHIPixelFormat format)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateSwapChain(windowHandle, width, height, format);
 	}
 
 	FORCEINLINE Ref<RHITexture2D> RHICreateTexture2D(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHIResourceCreateInfo& CreateInfo)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateTexture2D(sizeX, sizeY, format, numMips, createFlags, CreateInfo);
 	}
 
 	FORCEINLINE Ref<RHITextureCube> RHICreateTextureCube(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHITextureCubeCreateInfo& CreateInfo)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateTextureCube(sizeX, sizeY, format, numMips, createFlags, CreateInfo);
 	}
 
 	FORCEINLINE Ref<RHIVertexBuffer> RHICreateVertexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateVertexBuffer(size, usage, createInfo);
 	}
 
 	FORCEINLINE Ref<RHIIndexBuffer> RHICreateIndexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateIndexBuffer(size, usage, createInfo);
 	}
 
 	FORCEINLINE Ref<RHIVertexShader> RHICreateVertexShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateVertexShader(filePath, entryPoint, createInfo);
 	}
 
 	FORCEINLINE Ref<RHIPixelShader> RHICreatePixelShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreatePixelShader(filePath, entryPoint, createInfo);
 	}
 
 	FORCEINLINE Ref<RHIVertexDeclaration> RHICreateVertexDeclaration(Ref<RHIVertexShader> vertexShader, const VertexDeclarationElementList& Elements)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateVertexDeclaration(vertexShader, Elements);
 	}
 
@@ -151,6 +181,7 @@ namespace Lemon
 	//======DepthStencil State======//
 	FORCEINLINE Ref<RHIDepthStencilState> RHICreateDepthStencilState(const DepthStencilStateInitializer& initializer)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateDepthStencilState(initializer);
 	}
 
@@ -158,24 +189,28 @@ namespace Lemon
 	Ref<RHIUniformBufferBase> RHICreateUniformBuffer(const std::string& uniformBufferName)
 	{
 		uint32_t size = GetValidateUniformBufferSize(static_cast<uint32_t>(sizeof(T)));
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateUniformBuffer(size, uniformBufferName);
 	}
 
 	//=====Blend State===============//
 	FORCEINLINE Ref<RHIBlendState> RHICreateBlendState(const BlendStateInitializer& initializer)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateBlendState(initializer);
 	}
 
 	//====RasterizerState====//
 	FORCEINLINE Ref<RHIRasterizerState> RHICreateRasterizerState(const RasterizerStateInitializer& initializer)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateRasterizerState(initializer);
 	}
 
 	//===SamplerState=======//
 	FORCEINLINE Ref<RHISamplerState> RHICreateSamplerState(const SamplerStateInitializer& initializer)
 	{
+		LEMON_MEMORY_SCOPE(RHI);
 		return g_DynamicRHI->RHICreateSamplerState(initializer);
 	}
 
@@ -0,0 +1,180 @@
+#include "LemonPCH.h"
+#include "NullCommandList.h"
+#include "NullDynamicRHI.h"
+#include "RHI/RHISwapChain.h"
+#include <cstring>
+
+namespace Lemon
+{
+	namespace
+	{
+		uint32_t FloatBits(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+	}
+
+	NullCommandList::NullCommandList(NullDynamicRHI* nullRHI, Renderer* renderer)
+		: RHICommandList(renderer)
+		, m_NullRHI(nullRHI)
+	{
+		// Enough for a typical frame, the stream only grows after that
+		m_Commands.reserve(4096);
+	}
+
+	NullRHICommand& NullCommandList::Record(ENullRHICommand type, const void* resource /*= nullptr*/, uint32_t index /*= 0*/)
+	{
+		m_CommandCounts[static_cast<size_t>(type)]++;
+
+		NullRHICommand& command = m_bStreamEnabled ? m_Commands.emplace_back() : m_Scratch;
+		command = {};
+		command.Type = type;
+		command.Index = static_cast<uint8_t>(index);
+		command.Resource = resource;
+		return command;
+	}
+
+	void NullCommandList::ResetRecording()
+	{
+		m_Commands.clear();
+		m_CommandCounts.fill(0);
+		m_PrimitiveCount = 0;
+	}
+
+	void NullCommandList::BeginFrame()
+	{
+		ResetRecording();
+		m_FrameIndex++;
+	}
+
+	//===================================RHI RenderCommand Helper function==================================//
+	void NullCommandList::RHIClearRenderTarget(Ref<RHITexture2D> renderTarget, glm::vec4 backgroundColor, Ref<RHITexture2D> depthStencilTarget /*= nullptr*/, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::ClearRenderTarget, renderTarget.get());
+		command.Flags = 1;
+	}
+
+	void NullCommandList::RHIClearRenderTarget(Ref<RHITextureCube> renderTargets, int renderTargetIndex, glm::vec4 backgroundColor, Ref<RHITexture2D> depthStencilTarget /*= nullptr*/, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::ClearRenderTarget, renderTargets.get(), renderTargetIndex);
+		command.Flags = 1;
+	}
+
+	void NullCommandList::RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor, Ref<RHITexture2D> depthStencilTarget /*= nullptr*/, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::ClearRenderTarget, colorTargets.empty() ? nullptr : colorTargets[0].get());
+		command.Flags = static_cast<uint16_t>(colorTargets.size());
+	}
+
+	void NullCommandList::SetRenderTarget(Ref<RHITexture2D> colorTarget, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetRenderTarget, colorTarget.get());
+		command.Flags = colorTarget ? 1 : 0;
+	}
+
+	void NullCommandList::SetRenderTarget(Ref<RHITextureCube> colorTargets, int colorTargetIndex, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetRenderTarget, colorTargets.get(), colorTargetIndex);
+		command.Flags = 1;
+	}
+
+	void NullCommandList::SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetRenderTarget, colorTargets.empty() ? nullptr : colorTargets[0].get());
+		command.Flags = static_cast<uint16_t>(colorTargets.size());
+	}
+
+	void NullCommandList::SetRenderTarget(Ref<RHISwapChain> swapChain, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetRenderTarget, swapChain.get());
+		command.Flags = 1;
+	}
+
+	void NullCommandList::SetGraphicsPipelineState(const GraphicsPipelineStateInitializer& GraphicsPSOInit)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetGraphicsPipelineState, GraphicsPSOInit.BoundShaderState.VertexShaderRHI.get());
+		command.Flags = static_cast<uint16_t>(GraphicsPSOInit.PrimitiveType);
+	}
+
+	void NullCommandList::SetViewport(const Viewport& viewport)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetViewport);
+		command.Args[0] = FloatBits(viewport.X);
+		command.Args[1] = FloatBits(viewport.Y);
+		command.Args[2] = FloatBits(viewport.Width);
+		command.Args[3] = FloatBits(viewport.Height);
+	}
+
+	void NullCommandList::SetIndexBuffer(const RHIIndexBuffer* indexBuffer)
+	{
+		Record(ENullRHICommand::SetIndexBuffer, indexBuffer);
+	}
+
+	void NullCommandList::SetVertexBuffer(int streamIndex, const RHIVertexBuffer* vertexBuffer)
+	{
+		Record(ENullRHICommand::SetVertexBuffer, vertexBuffer, streamIndex);
+	}
+
+	void NullCommandList::DrawIndexPrimitive(uint32_t VertexOffset, uint32_t IndexOffset, uint32_t NumPrimitives, uint32_t FirstInstance /*= 0*/, uint32_t NumInstances /*= 1*/)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::DrawIndexPrimitive);
+		command.Args[0] = VertexOffset;
+		command.Args[1] = IndexOffset;
+		command.Args[2] = NumPrimitives;
+		command.Args[3] = FirstInstance;
+		command.Args[4] = NumInstances;
+		m_PrimitiveCount += static_cast<uint64_t>(NumPrimitives) * NumInstances;
+	}
+
+	void NullCommandList::Flush()
+	{
+		Record(ENullRHICommand::Flush);
+	}
+
+	void NullCommandList::SetUniformBuffer(uint32_t slot, EUniformBufferUsageScopeType scopeType, const RHIUniformBufferBaseRef& uniformBuffer)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetUniformBuffer, uniformBuffer.get(), slot);
+		command.Flags = scopeType;
+	}
+
+	void NullCommandList::SetSamplerState(uint32_t slot, const Ref<RHISamplerState>& samplerState)
+	{
+		Record(ENullRHICommand::SetSamplerState, samplerState.get(), slot);
+	}
+
+	void NullCommandList::SetTexture(uint32_t slot, const Ref<RHITexture>& texture)
+	{
+		Record(ENullRHICommand::SetTexture, texture.get(), slot);
+	}
+
+	void NullCommandList::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures)
+	{
+		NullRHICommand& command = Record(ENullRHICommand::SetMipTexture, targetTex.get(), mipIndex);
+		command.Flags = static_cast<uint16_t>(mipTextures.size());
+		command.Args[0] = mipWidth;
+		command.Args[1] = mipHeight;
+	}
+	//=======================================================================================================//
+
+	const char* NullCommandList::GetCommandName(ENullRHICommand type)
+	{
+		switch (type)
+		{
+		case ENullRHICommand::ClearRenderTarget:			return "ClearRenderTarget";
+		case ENullRHICommand::SetRenderTarget:				return "SetRenderTarget";
+		case ENullRHICommand::SetGraphicsPipelineState:		return "SetGraphicsPipelineState";
+		case ENullRHICommand::SetViewport:					return "SetViewport";
+		case ENullRHICommand::SetIndexBuffer:				return "SetIndexBuffer";
+		case ENullRHICommand::SetVertexBuffer:				return "SetVertexBuffer";
+		case ENullRHICommand::DrawIndexPrimitive:			return "DrawIndexPrimitive";
+		case ENullRHICommand::SetUniformBuffer:				return "SetUniformBuffer";
+		case ENullRHICommand::SetSamplerState:				return "SetSamplerState";
+		case ENullRHICommand::SetTexture:					return "SetTexture";
+		case ENullRHICommand::SetMipTexture:				return "SetMipTexture";
+		case ENullRHICommand::Flush:						return "Flush";
+		default:											return "Unknown";
+		}
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "Core/Core.h"
+#include "RHI/RHICommandList.h"
+#include <array>
+#include <vector>
+
+namespace Lemon
+{
+	class Renderer;
+	class NullDynamicRHI;
+
+	enum class ENullRHICommand : uint8_t
+	{
+		ClearRenderTarget,
+		SetRenderTarget,
+		SetGraphicsPipelineState,
+		SetViewport,
+		SetIndexBuffer,
+		SetVertexBuffer,
+		DrawIndexPrimitive,
+		SetUniformBuffer,
+		SetSamplerState,
+		SetTexture,
+		SetMipTexture,
+		Flush,
+		Count
+	};
+
+	// One recorded command. Resources are only identified by address, nothing is kept alive by the stream.
+	struct NullRHICommand
+	{
+		ENullRHICommand Type;
+		// Slot, stream or target index
+		uint8_t Index;
+		// Uniform buffer scope, primitive type or number of targets
+		uint16_t Flags;
+		// DrawIndexPrimitive: VertexOffset, IndexOffset, NumPrimitives, FirstInstance, NumInstances
+		// SetViewport: X, Y, Width, Height as float bits
+		uint32_t Args[5];
+		const void* Resource;
+	};
+	static_assert(sizeof(NullRHICommand) <= 32, "NullRHICommand should stay compact");
+
+	// Executes nothing, appends every command to an in-memory stream so the CPU cost of the renderer can be measured
+	// and exact command counts can be checked. The stream covers one frame, it is cleared in BeginFrame.
+	class LEMON_API NullCommandList : public RHICommandList
+	{
+	public:
+		NullCommandList(NullDynamicRHI* nullRHI, Renderer* renderer);
+
+		//===================================RHI RenderCommand Helper function==================================//
+		virtual void BeginFrame() override;
+
+		virtual void RHIClearRenderTarget(Ref<RHITexture2D> renderTarget, glm::vec4 backgroundColor,
+			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void RHIClearRenderTarget(Ref<RHITextureCube> renderTargets, int renderTargetIndex, glm::vec4 backgroundColor,
+			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor,
+			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void SetRenderTarget(Ref<RHITexture2D> colorTarget, Ref<RHITexture2D> depthTarget = nullptr) override;
+
+		virtual void SetRenderTarget(Ref<RHITextureCube> colorTargets, int colorTargetIndex, Ref<RHITexture2D> depthTarget = nullptr) override;
+
+		virtual void SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget = nullptr) override;
+
+		virtual void SetRenderTarget(Ref<RHISwapChain> swapChain, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void SetGraphicsPipelineState(const GraphicsPipelineStateInitializer& GraphicsPSOInit) override;
+
+		virtual void SetViewport(const Viewport& viewport) override;
+
+		virtual void SetIndexBuffer(const RHIIndexBuffer* indexBuffer) override;
+
+		virtual void SetVertexBuffer(int streamIndex, const RHIVertexBuffer* vertexBuffer) override;
+
+		virtual void DrawIndexPrimitive(uint32_t VertexOffset, uint32_t IndexOffset, uint32_t NumPrimitives, uint32_t FirstInstance = 0, uint32_t NumInstances = 1) override;
+
+		virtual void Flush() override;
+
+		virtual void SetUniformBuffer(uint32_t slot, EUniformBufferUsageScopeType scopeType, const RHIUniformBufferBaseRef& uniformBuffer) override;
+
+		virtual void SetSamplerState(uint32_t slot, const Ref<RHISamplerState>& samplerState) override;
+
+		virtual void SetTexture(uint32_t slot, const Ref<RHITexture>& texture) override;
+
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) override;
+
+		//=======================================================================================================//
+
+		//====Recording=====//
+		const std::vector<NullRHICommand>& GetCommands() const { return m_Commands; }
+		uint32_t GetCommandCount(ENullRHICommand type) const { return m_CommandCounts[static_cast<size_t>(type)]; }
+		uint32_t GetCommandCount() const { return static_cast<uint32_t>(m_Commands.size()); }
+		// Every SetRenderTarget starts a new pass
+		uint32_t GetPassCount() const { return GetCommandCount(ENullRHICommand::SetRenderTarget); }
+		uint64_t GetPrimitiveCount() const { return m_PrimitiveCount; }
+		uint32_t GetFrameIndex() const { return m_FrameIndex; }
+
+		// Counting only, for long runs where the stream itself is not needed
+		void SetStreamEnabled(bool bEnable) { m_bStreamEnabled = bEnable; }
+		void ResetRecording();
+
+		static const char* GetCommandName(ENullRHICommand type);
+
+	private:
+		NullRHICommand& Record(ENullRHICommand type, const void* resource = nullptr, uint32_t index = 0);
+
+	private:
+		NullDynamicRHI* m_NullRHI;
+
+		std::vector<NullRHICommand> m_Commands;
+		std::array<uint32_t, static_cast<size_t>(ENullRHICommand::Count)> m_CommandCounts = {};
+		uint64_t m_PrimitiveCount = 0;
+		uint32_t m_FrameIndex = 0;
+		bool m_bStreamEnabled = true;
+
+		// Written to instead of the stream while it is disabled
+		NullRHICommand m_Scratch;
+	};
+}
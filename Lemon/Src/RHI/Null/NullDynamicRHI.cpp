@@ -0,0 +1,127 @@
+#include "LemonPCH.h"
+#include "NullDynamicRHI.h"
+#include "NullCommandList.h"
+#include "NullResources.h"
+#include "Log/Log.h"
+
+namespace Lemon
+{
+	NullDynamicRHI::NullDynamicRHI()
+	{
+	}
+
+	void NullDynamicRHI::Init()
+	{
+		LEMON_CORE_INFO("Create Null RHI, commands are recorded only");
+		AddDeviceAdapter(RHIDeviceAdapter(0, "Null Device", 0, nullptr));
+	}
+
+	void NullDynamicRHI::Shutdown()
+	{
+		m_CommandList = nullptr;
+	}
+
+	template<typename T, typename... Args>
+	Ref<T> NullDynamicRHI::CreateResource(Args&&... args)
+	{
+		m_CreatedResourceCount++;
+		return CreateRef<T>(std::forward<Args>(args)...);
+	}
+
+	//===================Begin RHI Methods ==================//
+	Ref<RHICommandList> NullDynamicRHI::RHICreateCommandList(Renderer* renderer)
+	{
+		Ref<NullCommandList> commandList = CreateRef<NullCommandList>(this, renderer);
+		m_CommandList = commandList.get();
+		return commandList;
+	}
+
+	Ref<RHISwapChain> NullDynamicRHI::RHICreateSwapChain(void* windowHandle, const uint32_t width, const uint32_t height, const ERHIPixelFormat format)
+	{
+		return CreateResource<NullSwapChain>(width, height, format);
+	}
+
+	Ref<RHITexture2D> NullDynamicRHI::RHICreateTexture2D(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHIResourceCreateInfo& CreateInfo)
+	{
+		Ref<RHITexture2D> texture = CreateResource<NullTexture2D>(sizeX, sizeY, numMips, format, createFlags);
+		texture->SetName(CreateInfo.DebugName);
+		return texture;
+	}
+
+	Ref<RHITextureCube> NullDynamicRHI::RHICreateTextureCube(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHITextureCubeCreateInfo& CreateInfo)
+	{
+		Ref<RHITextureCube> texture = CreateResource<NullTextureCube>(sizeX, sizeY, numMips, format, createFlags);
+		texture->SetName(CreateInfo.DebugName);
+		return texture;
+	}
+
+	Ref<RHIVertexBuffer> NullDynamicRHI::RHICreateVertexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo)
+	{
+		return CreateResource<NullVertexBuffer>(size, usage);
+	}
+
+	Ref<RHIIndexBuffer> NullDynamicRHI::RHICreateIndexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo)
+	{
+		return CreateResource<NullIndexBuffer>(size, usage);
+	}
+
+	Ref<RHIUniformBufferBase> NullDynamicRHI::RHICreateUniformBuffer(uint32_t size, const std::string& uniformBufferName)
+	{
+		return CreateResource<NullUniformBuffer>(size, uniformBufferName);
+	}
+
+	Ref<RHIVertexShader> NullDynamicRHI::RHICreateVertexShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo)
+	{
+		// Never compiled, so a missing shader file is not an error here
+		return CreateResource<NullVertexShader>(filePath, entryPoint);
+	}
+
+	Ref<RHIPixelShader> NullDynamicRHI::RHICreatePixelShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo)
+	{
+		return CreateResource<NullPixelShader>(filePath, entryPoint);
+	}
+
+	Ref<RHIVertexDeclaration> NullDynamicRHI::RHICreateVertexDeclaration(Ref<RHIVertexShader> vertexShader, const VertexDeclarationElementList& Elements)
+	{
+		return CreateResource<NullVertexDeclaration>(Elements);
+	}
+
+	Ref<RHIDepthStencilState> NullDynamicRHI::RHICreateDepthStencilState(const DepthStencilStateInitializer& initializer)
+	{
+		return CreateResource<NullDepthStencilState>(initializer);
+	}
+
+	Ref<RHIBlendState> NullDynamicRHI::RHICreateBlendState(const BlendStateInitializer& initializer)
+	{
+		return CreateResource<NullBlendState>(initializer);
+	}
+
+	Ref<RHIRasterizerState> NullDynamicRHI::RHICreateRasterizerState(const RasterizerStateInitializer& initializer)
+	{
+		return CreateResource<NullRasterizerState>(initializer);
+	}
+
+	Ref<RHISamplerState> NullDynamicRHI::RHICreateSamplerState(const SamplerStateInitializer& initializer)
+	{
+		return CreateResource<NullSamplerState>(initializer);
+	}
+
+	void NullDynamicRHI::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures)
+	{
+		// Goes through the command list so it shows up in the recording
+		if (m_CommandList)
+		{
+			m_CommandList->SetMipTexture(targetTex, mipIndex, mipWidth, mipHeight, mipTextures);
+		}
+	}
+
+	void NullDynamicRHI::RHIClearRenderTarget(Ref<RHISwapChain> swapChain, glm::vec4 backgroundColor)
+	{
+	}
+	//===================End RHI Methods ==================//
+
+	NullDynamicRHI* GetNullDynamicRHI()
+	{
+		return dynamic_cast<NullDynamicRHI*>(g_DynamicRHI);
+	}
+}
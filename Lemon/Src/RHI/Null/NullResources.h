@@ -0,0 +1,205 @@
+#pragma once
+#include "Core/Core.h"
+#include "RHI/RHI.h"
+#include "RHI/RHIResources.h"
+#include "RHI/RHISwapChain.h"
+#include <vector>
+
+namespace Lemon
+{
+	// CPU side stand-ins for GPU resources, they only remember their description.
+	// Buffers keep a shadow copy so Lock/UnLock behave like the real thing.
+
+	//==========================Textures==========================//
+	class NullTexture2D : public RHITexture2D
+	{
+	public:
+		NullTexture2D(uint32_t sizeX, uint32_t sizeY, uint32_t numMips, ERHIPixelFormat textureFormat, uint32_t createFlags)
+			: RHITexture2D(sizeX, sizeY, numMips, textureFormat)
+			, m_CreateFlags(createFlags)
+		{}
+
+		uint32_t GetCreateFlags() const { return m_CreateFlags; }
+
+		//=========RHI Resource====================
+		virtual void* GetNativeResource() override final { return this; }
+		virtual void* GetNativeShaderResourceView() override final { return this; }
+		virtual void* GetNativeRenderTargetView(int index) override final { return this; }
+		virtual void* GetNativeDepthStencilView() override final { return this; }
+		//=========================================
+
+	private:
+		uint32_t m_CreateFlags;
+	};
+
+	class NullTextureCube : public RHITextureCube
+	{
+	public:
+		NullTextureCube(uint32_t sizeX, uint32_t sizeY, uint32_t numMips, ERHIPixelFormat textureFormat, uint32_t createFlags)
+			: RHITextureCube(sizeX, sizeY, numMips, textureFormat)
+			, m_CreateFlags(createFlags)
+		{}
+
+		uint32_t GetCreateFlags() const { return m_CreateFlags; }
+
+		//=========RHI Resource====================
+		virtual void* GetNativeResource() override final { return this; }
+		virtual void* GetNativeShaderResourceView() override final { return this; }
+		virtual void* GetNativeRenderTargetView(int index) override final { return this; }
+		virtual void* GetNativeDepthStencilView() override final { return this; }
+		//=========================================
+
+	private:
+		uint32_t m_CreateFlags;
+	};
+
+	//==========================Buffers==========================//
+	class NullVertexBuffer : public RHIVertexBuffer
+	{
+	public:
+		NullVertexBuffer(uint32_t size, uint32_t usage)
+			: RHIVertexBuffer(size, usage)
+		{}
+
+		// The shadow copy is only allocated once somebody actually writes to the buffer
+		virtual void* Lock() const override { m_Data.resize(GetSize()); return m_Data.data(); }
+		virtual bool UnLock() const override { return true; }
+
+	private:
+		mutable std::vector<uint8_t> m_Data;
+	};
+
+	class NullIndexBuffer : public RHIIndexBuffer
+	{
+	public:
+		NullIndexBuffer(uint32_t size, uint32_t usage)
+			: RHIIndexBuffer(size, usage)
+		{}
+
+		virtual void* Lock() const override { m_Data.resize(GetSize()); return m_Data.data(); }
+		virtual bool UnLock() const override { return true; }
+
+	private:
+		mutable std::vector<uint8_t> m_Data;
+	};
+
+	class NullUniformBuffer : public RHIUniformBufferBase
+	{
+	public:
+		NullUniformBuffer(uint32_t size, const std::string& name)
+			: RHIUniformBufferBase(size)
+			, m_Data(size)
+			, m_Name(name)
+		{}
+
+		virtual void* Lock() const override { return m_Data.data(); }
+		virtual bool UnLock() const override { return true; }
+
+		const std::string& GetName() const { return m_Name; }
+
+	private:
+		mutable std::vector<uint8_t> m_Data;
+		std::string m_Name;
+	};
+
+	//==========================Shaders==========================//
+	class NullVertexShader : public RHIVertexShader
+	{
+	public:
+		NullVertexShader(const std::string& filePath, const std::string& entryPoint)
+			: m_FilePath(filePath)
+			, m_EntryPoint(entryPoint)
+		{}
+
+		const std::string& GetFilePath() const { return m_FilePath; }
+		const std::string& GetEntryPoint() const { return m_EntryPoint; }
+
+	private:
+		std::string m_FilePath;
+		std::string m_EntryPoint;
+	};
+
+	class NullPixelShader : public RHIPixelShader
+	{
+	public:
+		NullPixelShader(const std::string& filePath, const std::string& entryPoint)
+			: m_FilePath(filePath)
+			, m_EntryPoint(entryPoint)
+		{}
+
+		const std::string& GetFilePath() const { return m_FilePath; }
+		const std::string& GetEntryPoint() const { return m_EntryPoint; }
+
+	private:
+		std::string m_FilePath;
+		std::string m_EntryPoint;
+	};
+
+	class NullVertexDeclaration : public RHIVertexDeclaration
+	{
+	public:
+		NullVertexDeclaration(const VertexDeclarationElementList& elements)
+			: m_Elements(elements)
+		{
+			for (uint16_t& stride : m_StreamStrides)
+			{
+				stride = 0;
+			}
+			for (const RHIVertexElement& element : m_Elements)
+			{
+				if (element.StreamIndex < MaxVertexElementCount)
+				{
+					m_StreamStrides[element.StreamIndex] = element.Stride;
+				}
+			}
+		}
+
+		virtual bool GetInitializer(VertexDeclarationElementList& Init) override { Init = m_Elements; return true; }
+
+	private:
+		VertexDeclarationElementList m_Elements;
+	};
+
+	//==========================States==========================//
+	class NullSamplerState : public RHISamplerState
+	{
+	public:
+		NullSamplerState(const SamplerStateInitializer& Init) : RHISamplerState(Init) {}
+	};
+
+	class NullRasterizerState : public RHIRasterizerState
+	{
+	public:
+		NullRasterizerState(const RasterizerStateInitializer& Init) : RHIRasterizerState(Init) {}
+	};
+
+	class NullBlendState : public RHIBlendState
+	{
+	public:
+		NullBlendState(const BlendStateInitializer& Init) : RHIBlendState(Init) {}
+	};
+
+	class NullDepthStencilState : public RHIDepthStencilState
+	{
+	public:
+		NullDepthStencilState(const DepthStencilStateInitializer& Init) : RHIDepthStencilState(Init) {}
+	};
+
+	//==========================SwapChain==========================//
+	class NullSwapChain : public RHISwapChain
+	{
+	public:
+		NullSwapChain(uint32_t width, uint32_t height, ERHIPixelFormat pixelFormat)
+			: RHISwapChain(width, height, pixelFormat)
+		{}
+
+		virtual bool Present() override { return true; }
+		virtual bool ReSize(uint32_t width, uint32_t height) override { m_Width = width; m_Height = height; return true; }
+
+		//=========RHI Resource====================
+		virtual void* GetRHISwapChain() override { return this; }
+		virtual void* GetRHIRenderTargetView() override { return this; }
+		virtual void* GetRHIDepthStencilView() override { return this; }
+		//=========================================
+	};
+}
@@ -1,9 +1,11 @@
 #pragma once
 #include "Core/Core.h"
+#include "Core/MemoryTracker.h"
 #include "RenderCore/Containers/ResourceArray.h"
 #include "RHIDefinitions.h"
 #include <map>
 #include <array>
+#include <cfloat>
 
 #include <glm/vec4.hpp>
 
@@ -16,7 +18,7 @@ namespace Lemon
 
 	struct TextureMipData
 	{
-		std::vector<std::byte> TextureData;
+		TaggedVector<std::byte, EMemoryTag::TextureData> TextureData;
 	};
 
 	struct TextureRawData
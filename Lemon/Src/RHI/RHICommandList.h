@@ -22,16 +22,19 @@ namespace Lemon
 
 
 		//===================================RHI RenderCommand Helper function==================================//
+		// Called by the Renderer before it records anything for a new frame
+		virtual void BeginFrame() {}
+
 		virtual void RHIClearRenderTarget(Ref<RHITexture2D> renderTarget, glm::vec4 backgroundColor,
 			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) = 0;
 		virtual void RHIClearRenderTarget(Ref<RHITextureCube> renderTargets, int renderTargetIndex, glm::vec4 backgroundColor,
 			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) = 0;
-		virtual void RHIClearRenderTarget(std::vector<Ref<RHITexture2D>> colorTargets, glm::vec4 backgroundColor,
+		virtual void RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor,
 			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) = 0;
 
 		virtual void SetRenderTarget(Ref<RHITexture2D> colorTarget, Ref<RHITexture2D> depthTarget = nullptr) = 0;
 		virtual void SetRenderTarget(Ref<RHITextureCube> colorTargets, int colorTargetIndex, Ref<RHITexture2D> depthTarget = nullptr) = 0;
-		virtual void SetRenderTarget(std::vector<Ref<RHITexture2D>> colorTargets, Ref<RHITexture2D> depthTarget = nullptr) = 0;
+		virtual void SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget = nullptr) = 0;
 
 		virtual void SetRenderTarget(Ref<RHISwapChain> swapChain, float depthClear = 1.0f, float stencilClear = 0) = 0;
 
@@ -58,7 +61,7 @@ namespace Lemon
 		// Texture
 		virtual void SetTexture(uint32_t slot, const Ref<RHITexture>& texture) = 0;	
 		
-		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, std::vector<Ref<RHITexture2D>> mipTextures) = 0;
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) = 0;
 
 		//=======================================================================================================//
 	private:
@@ -4,6 +4,7 @@
 #include "RHIDefinitions.h"
 #include <string>
 #include <array>
+#include <vector>
 
 namespace Lemon
 {
@@ -442,5 +443,39 @@ namespace Lemon
 	typedef Ref<RHIVertexBuffer> RHIVertexBufferRef;
 	typedef Ref<RHIUniformBufferBase> RHIUniformBufferBaseRef;
 
+	/**
+	 * Non-owning view of a contiguous list, used by the RHI calls that take several resources at once.
+	 * The caller keeps the storage alive for the duration of the call, so the renderer is free to build
+	 * the list on the frame arena, in a std::vector or in a plain array.
+	 */
+	template<typename T>
+	class RHIArrayView
+	{
+	public:
+		RHIArrayView() = default;
+		RHIArrayView(const T* data, uint32_t count) :m_Data(data), m_Count(count) {}
+
+		template<typename Allocator>
+		RHIArrayView(const std::vector<T, Allocator>& container) :m_Data(container.data()), m_Count(static_cast<uint32_t>(container.size())) {}
+
+		template<size_t N>
+		RHIArrayView(const std::array<T, N>& container) :m_Data(container.data()), m_Count(static_cast<uint32_t>(N)) {}
+
+		const T* data() const { return m_Data; }
+		uint32_t size() const { return m_Count; }
+		bool empty() const { return m_Count == 0; }
+
+		const T& operator[](uint32_t index) const { return m_Data[index]; }
+
+		const T* begin() const { return m_Data; }
+		const T* end() const { return m_Data + m_Count; }
+
+	private:
+		const T* m_Data = nullptr;
+		uint32_t m_Count = 0;
+	};
+
+	typedef RHIArrayView<Ref<RHITexture2D>> RHITexture2DArrayView;
+
 	
 }
\ No newline at end of file
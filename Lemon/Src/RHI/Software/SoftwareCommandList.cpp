@@ -0,0 +1,411 @@
+#include "LemonPCH.h"
+#include "SoftwareCommandList.h"
+#include "SoftwareDynamicRHI.h"
+#include "SoftwareResources.h"
+#include "Renderer/SceneUniformBuffers.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace Lemon
+{
+	namespace
+	{
+		// Slots SceneUniformBuffers::Allocate binds its buffers to
+		constexpr uint32_t ViewUniformSlot = 0;
+		constexpr uint32_t ObjectUniformSlot = 1;
+		constexpr uint32_t LightUniformSlot = 2;
+		// Depth the sky vertex shaders pin their output to
+		constexpr float SkyDepth = 0.9999f;
+
+		// Column major, same memory layout as glm::mat4
+		struct Float4x4
+		{
+			float M[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+		};
+
+		struct Float4
+		{
+			float V[4];
+		};
+
+		FORCEINLINE void Transform(const Float4x4& matrix, const float (&vector)[4], float (&result)[4])
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				result[row] = matrix.M[row] * vector[0] + matrix.M[4 + row] * vector[1] + matrix.M[8 + row] * vector[2] + matrix.M[12 + row] * vector[3];
+			}
+		}
+
+		Float4x4 Multiply(const Float4x4& lhs, const Float4x4& rhs)
+		{
+			Float4x4 result;
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					float sum = 0.0f;
+					for (int k = 0; k < 4; k++)
+					{
+						sum += lhs.M[k * 4 + row] * rhs.M[column * 4 + k];
+					}
+					result.M[column * 4 + row] = sum;
+				}
+			}
+			return result;
+		}
+
+		void Normalize3(float (&vector)[4])
+		{
+			const float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+			if (length > 0.0f)
+			{
+				vector[0] /= length;
+				vector[1] /= length;
+				vector[2] /= length;
+			}
+		}
+
+		// Reads one float attribute of a vertex, components it does not have keep their value
+		bool FetchAttribute(const SoftwareVertexBuffer* stream, const RHIVertexElement& element, uint32_t vertexIndex, float (&value)[4])
+		{
+			uint32_t components = 0;
+			switch (element.Type)
+			{
+			case VET_Float1: components = 1; break;
+			case VET_Float2: components = 2; break;
+			case VET_Float3: components = 3; break;
+			case VET_Float4: components = 4; break;
+			default: return false;
+			}
+
+			const size_t offset = static_cast<size_t>(vertexIndex) * element.Stride + element.Offset;
+			if (!stream || offset + components * sizeof(float) > stream->GetSize())
+			{
+				return false;
+			}
+			std::memcpy(value, stream->GetData() + offset, components * sizeof(float));
+			return true;
+		}
+
+		FORCEINLINE SoftwareSurface* GetSurface(const Ref<RHITexture2D>& texture)
+		{
+			return texture ? &static_cast<SoftwareTexture2D*>(texture.get())->GetSurface() : nullptr;
+		}
+
+		FORCEINLINE uint32_t PackColor(const glm::vec4& color)
+		{
+			return SoftwareSurface::PackColor(color.x, color.y, color.z, color.w);
+		}
+	}
+
+	SoftwareCommandList::SoftwareCommandList(SoftwareDynamicRHI* softwareRHI, Renderer* renderer)
+		: RHICommandList(renderer)
+		, m_SoftwareRHI(softwareRHI)
+	{
+		m_PipelineState.PrimitiveType = PT_TriangleList;
+	}
+
+	void SoftwareCommandList::BeginFrame()
+	{
+		m_Stats = {};
+		m_Rasterizer.ResetStats();
+	}
+
+	//===================================RHI RenderCommand Helper function==================================//
+	void SoftwareCommandList::RHIClearRenderTarget(Ref<RHITexture2D> renderTarget, glm::vec4 backgroundColor, Ref<RHITexture2D> depthStencilTarget /*= nullptr*/, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		if (SoftwareSurface* surface = GetSurface(renderTarget))
+		{
+			surface->ClearColor(PackColor(backgroundColor));
+		}
+		if (SoftwareSurface* depthSurface = GetSurface(depthStencilTarget))
+		{
+			depthSurface->ClearDepth(depthClear);
+		}
+	}
+
+	void SoftwareCommandList::RHIClearRenderTarget(Ref<RHITextureCube> renderTargets, int renderTargetIndex, glm::vec4 backgroundColor, Ref<RHITexture2D> depthStencilTarget /*= nullptr*/, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		SoftwareSurface* surface = renderTargets ? static_cast<SoftwareTextureCube*>(renderTargets.get())->GetSurface(renderTargetIndex) : nullptr;
+		if (surface)
+		{
+			surface->ClearColor(PackColor(backgroundColor));
+		}
+		if (SoftwareSurface* depthSurface = GetSurface(depthStencilTarget))
+		{
+			depthSurface->ClearDepth(depthClear);
+		}
+	}
+
+	void SoftwareCommandList::RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor, Ref<RHITexture2D> depthStencilTarget /*= nullptr*/, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		const uint32_t packedColor = PackColor(backgroundColor);
+		for (const Ref<RHITexture2D>& colorTarget : colorTargets)
+		{
+			if (SoftwareSurface* surface = GetSurface(colorTarget))
+			{
+				surface->ClearColor(packedColor);
+			}
+		}
+		if (SoftwareSurface* depthSurface = GetSurface(depthStencilTarget))
+		{
+			depthSurface->ClearDepth(depthClear);
+		}
+	}
+
+	void SoftwareCommandList::SetRenderTarget(Ref<RHITexture2D> colorTarget, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	{
+		SoftwareSurface* colorSurface = GetSurface(colorTarget);
+		m_Rasterizer.SetRenderTargets(&colorSurface, colorSurface ? 1 : 0, GetSurface(depthTarget));
+		m_BoundTargets = { colorTarget, depthTarget };
+	}
+
+	void SoftwareCommandList::SetRenderTarget(Ref<RHITextureCube> colorTargets, int colorTargetIndex, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	{
+		SoftwareSurface* colorSurface = colorTargets ? static_cast<SoftwareTextureCube*>(colorTargets.get())->GetSurface(colorTargetIndex) : nullptr;
+		m_Rasterizer.SetRenderTargets(&colorSurface, colorSurface ? 1 : 0, GetSurface(depthTarget));
+		m_BoundTargets = { colorTargets, depthTarget };
+	}
+
+	void SoftwareCommandList::SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget /*= nullptr*/)
+	{
+		SoftwareSurface* colorSurfaces[SoftwareRasterizer::MaxColorTargets] = {};
+		uint32_t numColorSurfaces = 0;
+		m_BoundTargets.assign(colorTargets.begin(), colorTargets.end());
+		m_BoundTargets.emplace_back(depthTarget);
+		for (const Ref<RHITexture2D>& colorTarget : colorTargets)
+		{
+			if (numColorSurfaces < SoftwareRasterizer::MaxColorTargets)
+			{
+				colorSurfaces[numColorSurfaces++] = GetSurface(colorTarget);
+			}
+		}
+		m_Rasterizer.SetRenderTargets(colorSurfaces, numColorSurfaces, GetSurface(depthTarget));
+	}
+
+	void SoftwareCommandList::SetRenderTarget(Ref<RHISwapChain> swapChain, float depthClear /*= 1.0f*/, float stencilClear /*= 0*/)
+	{
+		m_BoundTargets = { swapChain };
+		if (!swapChain)
+		{
+			m_Rasterizer.SetRenderTargets(nullptr, 0, nullptr);
+			return;
+		}
+
+		// Same as the D3D11 command list: binding the back buffer clears it
+		SoftwareSurface* backBuffer = &static_cast<SoftwareSwapChain*>(swapChain.get())->GetBackBuffer();
+		backBuffer->ClearColor(SoftwareSurface::PackColor(1.0f, 0.0f, 0.0f, 1.0f));
+		backBuffer->ClearDepth(depthClear);
+		m_Rasterizer.SetRenderTargets(&backBuffer, 1, backBuffer);
+	}
+
+	void SoftwareCommandList::SetGraphicsPipelineState(const GraphicsPipelineStateInitializer& GraphicsPSOInit)
+	{
+		m_PipelineState = GraphicsPSOInit;
+
+		if (const auto* rasterizerState = static_cast<const SoftwareRasterizerState*>(GraphicsPSOInit.RasterizerState.get()))
+		{
+			m_RasterState.CullMode = rasterizerState->GetInitializer().CullMode;
+		}
+		if (const auto* depthStencilState = static_cast<const SoftwareDepthStencilState*>(GraphicsPSOInit.DepthStencilState.get()))
+		{
+			m_RasterState.DepthTest = depthStencilState->GetInitializer().DepthTest;
+			m_RasterState.bDepthWrite = depthStencilState->GetInitializer().bEnableDepthWrite;
+		}
+		if (const auto* blendState = static_cast<const SoftwareBlendState*>(GraphicsPSOInit.BlendState.get()))
+		{
+			m_RasterState.bColorWrite = blendState->GetInitializer().RenderTargets[0].ColorWriteMask != CW_NONE;
+		}
+	}
+
+	void SoftwareCommandList::SetViewport(const Viewport& viewport)
+	{
+		m_Rasterizer.SetViewport(viewport.X, viewport.Y, viewport.Width, viewport.Height, viewport.DepthMin, viewport.DepthMax);
+	}
+
+	void SoftwareCommandList::SetIndexBuffer(const RHIIndexBuffer* indexBuffer)
+	{
+		m_IndexBuffer = static_cast<const SoftwareIndexBuffer*>(indexBuffer);
+	}
+
+	void SoftwareCommandList::SetVertexBuffer(int streamIndex, const RHIVertexBuffer* vertexBuffer)
+	{
+		if (streamIndex >= 0 && streamIndex < static_cast<int>(m_VertexBuffers.size()))
+		{
+			m_VertexBuffers[streamIndex] = static_cast<const SoftwareVertexBuffer*>(vertexBuffer);
+		}
+	}
+
+	void SoftwareCommandList::DrawIndexPrimitive(uint32_t VertexOffset, uint32_t IndexOffset, uint32_t NumPrimitives, uint32_t FirstInstance /*= 0*/, uint32_t NumInstances /*= 1*/)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		const auto* declaration = static_cast<const SoftwareVertexDeclaration*>(m_PipelineState.BoundShaderState.VertexDeclarationRHI.get());
+		const auto* pixelShader = static_cast<const SoftwarePixelShader*>(m_PipelineState.BoundShaderState.PixelShaderRHI.get());
+		// Without a pixel shader only depth is written
+		const ESoftwareShadingModel shadingModel = pixelShader ? pixelShader->GetShadingModel() : ESoftwareShadingModel::DepthOnly;
+
+		const RHIVertexElement* positionElement = declaration ? declaration->FindElement(0) : nullptr;
+		const SoftwareVertexBuffer* positionStream = positionElement && positionElement->StreamIndex < MaxVertexElementCount
+			? m_VertexBuffers[positionElement->StreamIndex] : nullptr;
+		if (m_PipelineState.PrimitiveType != PT_TriangleList || shadingModel == ESoftwareShadingModel::Unsupported
+			|| !positionStream || positionElement->Stride == 0 || !m_IndexBuffer)
+		{
+			m_Stats.SkippedDrawCount++;
+			return;
+		}
+		m_Stats.DrawCount++;
+
+		auto findStream = [this](const RHIVertexElement* element) -> const SoftwareVertexBuffer*
+		{
+			return element && element->StreamIndex < MaxVertexElementCount ? m_VertexBuffers[element->StreamIndex] : nullptr;
+		};
+		const RHIVertexElement* colorElement = declaration->FindElement(1);
+		const RHIVertexElement* normalElement = declaration->FindElement(2);
+		const SoftwareVertexBuffer* colorStream = findStream(colorElement);
+		const SoftwareVertexBuffer* normalStream = findStream(normalElement);
+
+		//====Uniforms====//
+		Float4x4 viewProjection, localToWorld, normalToWorld;
+		Float4 albedo = { { 1.0f, 1.0f, 1.0f, 1.0f } };
+		Float4 ambientColor = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+		Float4 lightDirection = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+		Float4 lightColor = { { 1.0f, 1.0f, 1.0f, 1.0f } };
+		if (const SoftwareUniformBuffer* view = m_UniformBuffers[ViewUniformSlot])
+		{
+			view->Read(offsetof(ViewUniformParameters, ViewProjectionMatrix), viewProjection);
+			view->Read(offsetof(ViewUniformParameters, AmbientColor), ambientColor);
+		}
+		if (const SoftwareUniformBuffer* object = m_UniformBuffers[ObjectUniformSlot])
+		{
+			object->Read(offsetof(ObjectUniformParameters, LocalToWorldMatrix), localToWorld);
+			object->Read(offsetof(ObjectUniformParameters, WorldToWorldTransposeMatrix), normalToWorld);
+			object->Read(offsetof(ObjectUniformParameters, Albedo), albedo);
+		}
+		if (const SoftwareUniformBuffer* light = m_UniformBuffers[LightUniformSlot])
+		{
+			light->Read(offsetof(LightUniformParameters, DirectionalLightDir), lightDirection);
+			light->Read(offsetof(LightUniformParameters, DirectionalLightColor), lightColor);
+		}
+		// w = 0 means there is no directional light
+		const bool bHasLight = lightDirection.V[3] > 0.0f;
+		Normalize3(lightDirection.V);
+		const Float4x4 localToClip = Multiply(viewProjection, localToWorld);
+
+		//====Vertex stage====//
+		const uint32_t vertexCount = positionStream->GetSize() / positionElement->Stride;
+		m_Vertices.resize(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			SoftwareVertex& vertex = m_Vertices[i];
+
+			float position[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			if (!FetchAttribute(positionStream, *positionElement, i, position))
+			{
+				// w = 0 is rejected by the rasterizer
+				position[3] = 0.0f;
+			}
+			Transform(localToClip, position, vertex.Position);
+
+			float* color = vertex.Color;
+			switch (shadingModel)
+			{
+			case ESoftwareShadingModel::Lit:
+			{
+				float normal[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+				if (normalElement)
+				{
+					FetchAttribute(normalStream, *normalElement, i, normal);
+				}
+				normal[3] = 0.0f;
+				float worldNormal[4];
+				Transform(normalToWorld, normal, worldNormal);
+				Normalize3(worldNormal);
+
+				const float lambert = bHasLight
+					? (std::max)(worldNormal[0] * lightDirection.V[0] + worldNormal[1] * lightDirection.V[1] + worldNormal[2] * lightDirection.V[2], 0.0f)
+					: 0.0f;
+				for (int channel = 0; channel < 3; channel++)
+				{
+					color[channel] = albedo.V[channel] * (ambientColor.V[channel] + lightColor.V[channel] * lambert);
+				}
+				color[3] = albedo.V[3];
+				break;
+			}
+			case ESoftwareShadingModel::VertexColor:
+			{
+				float vertexColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+				if (colorElement)
+				{
+					FetchAttribute(colorStream, *colorElement, i, vertexColor);
+				}
+				std::memcpy(color, vertexColor, sizeof(vertexColor));
+				break;
+			}
+			case ESoftwareShadingModel::Sky:
+				vertex.Position[2] = vertex.Position[3] * SkyDepth;
+				std::memcpy(color, ambientColor.V, sizeof(ambientColor.V));
+				color[3] = 1.0f;
+				break;
+			default:
+				color[0] = color[1] = color[2] = color[3] = 0.0f;
+				break;
+			}
+		}
+		m_Stats.VertexCount += vertexCount;
+
+		//====Primitive assembly====//
+		// Instances carry no per instance data in this engine, so only the first one is drawn
+		const uint32_t availableIndices = m_IndexBuffer->GetSize() / sizeof(uint32_t);
+		const uint32_t numIndices = IndexOffset < availableIndices ? (std::min)(NumPrimitives * 3, (availableIndices - IndexOffset) / 3 * 3) : 0;
+		const uint8_t* indexData = m_IndexBuffer->GetData() + static_cast<size_t>(IndexOffset) * sizeof(uint32_t);
+
+		m_Indices.resize(numIndices);
+		std::memcpy(m_Indices.data(), indexData, numIndices * sizeof(uint32_t));
+		uint32_t numTriangles = 0;
+		for (uint32_t i = 0; i < numIndices; i += 3)
+		{
+			const uint32_t i0 = m_Indices[i] + VertexOffset;
+			const uint32_t i1 = m_Indices[i + 1] + VertexOffset;
+			const uint32_t i2 = m_Indices[i + 2] + VertexOffset;
+			if (i0 < vertexCount && i1 < vertexCount && i2 < vertexCount)
+			{
+				m_Indices[numTriangles * 3] = i0;
+				m_Indices[numTriangles * 3 + 1] = i1;
+				m_Indices[numTriangles * 3 + 2] = i2;
+				numTriangles++;
+			}
+		}
+
+		SoftwareRasterState rasterState = m_RasterState;
+		rasterState.bColorWrite = rasterState.bColorWrite && shadingModel != ESoftwareShadingModel::DepthOnly;
+		m_Rasterizer.DrawTriangles(m_Vertices.data(), m_Indices.data(), numTriangles, rasterState);
+	}
+
+	void SoftwareCommandList::Flush()
+	{
+		// Every command has already executed
+	}
+
+	void SoftwareCommandList::SetUniformBuffer(uint32_t slot, EUniformBufferUsageScopeType scopeType, const RHIUniformBufferBaseRef& uniformBuffer)
+	{
+		if (slot < MaxUniformBufferSlots)
+		{
+			m_UniformBuffers[slot] = static_cast<const SoftwareUniformBuffer*>(uniformBuffer.get());
+		}
+	}
+
+	void SoftwareCommandList::SetSamplerState(uint32_t slot, const Ref<RHISamplerState>& samplerState)
+	{
+	}
+
+	void SoftwareCommandList::SetTexture(uint32_t slot, const Ref<RHITexture>& texture)
+	{
+		// Fixed function shading never samples
+	}
+
+	void SoftwareCommandList::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures)
+	{
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Core/Core.h"
+#include "RHI/RHICommandList.h"
+#include "SoftwareRasterizer.h"
+#include <array>
+#include <vector>
+
+namespace Lemon
+{
+	class Renderer;
+	class SoftwareDynamicRHI;
+	class SoftwareUniformBuffer;
+	class SoftwareVertexBuffer;
+	class SoftwareIndexBuffer;
+
+	// Executes every command immediately on the CPU. Draws run a fixed function vertex stage
+	// (view projection * local to world, per vertex lighting) and hand the triangles to the SoftwareRasterizer.
+	class LEMON_API SoftwareCommandList : public RHICommandList
+	{
+	public:
+		struct Stats
+		{
+			uint32_t DrawCount = 0;
+			// Line lists and shaders that need textures
+			uint32_t SkippedDrawCount = 0;
+			uint64_t VertexCount = 0;
+		};
+
+	public:
+		SoftwareCommandList(SoftwareDynamicRHI* softwareRHI, Renderer* renderer);
+
+		//===================================RHI RenderCommand Helper function==================================//
+		virtual void BeginFrame() override;
+
+		virtual void RHIClearRenderTarget(Ref<RHITexture2D> renderTarget, glm::vec4 backgroundColor,
+			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void RHIClearRenderTarget(Ref<RHITextureCube> renderTargets, int renderTargetIndex, glm::vec4 backgroundColor,
+			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void RHIClearRenderTarget(RHITexture2DArrayView colorTargets, glm::vec4 backgroundColor,
+			Ref<RHITexture2D> depthStencilTarget = nullptr, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void SetRenderTarget(Ref<RHITexture2D> colorTarget, Ref<RHITexture2D> depthTarget = nullptr) override;
+
+		virtual void SetRenderTarget(Ref<RHITextureCube> colorTargets, int colorTargetIndex, Ref<RHITexture2D> depthTarget = nullptr) override;
+
+		virtual void SetRenderTarget(RHITexture2DArrayView colorTargets, Ref<RHITexture2D> depthTarget = nullptr) override;
+
+		virtual void SetRenderTarget(Ref<RHISwapChain> swapChain, float depthClear = 1.0f, float stencilClear = 0) override;
+
+		virtual void SetGraphicsPipelineState(const GraphicsPipelineStateInitializer& GraphicsPSOInit) override;
+
+		virtual void SetViewport(const Viewport& viewport) override;
+
+		virtual void SetIndexBuffer(const RHIIndexBuffer* indexBuffer) override;
+
+		virtual void SetVertexBuffer(int streamIndex, const RHIVertexBuffer* vertexBuffer) override;
+
+		virtual void DrawIndexPrimitive(uint32_t VertexOffset, uint32_t IndexOffset, uint32_t NumPrimitives, uint32_t FirstInstance = 0, uint32_t NumInstances = 1) override;
+
+		virtual void Flush() override;
+
+		virtual void SetUniformBuffer(uint32_t slot, EUniformBufferUsageScopeType scopeType, const RHIUniformBufferBaseRef& uniformBuffer) override;
+
+		virtual void SetSamplerState(uint32_t slot, const Ref<RHISamplerState>& samplerState) override;
+
+		virtual void SetTexture(uint32_t slot, const Ref<RHITexture>& texture) override;
+
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) override;
+
+		//=======================================================================================================//
+
+		SoftwareRasterizer& GetRasterizer() { return m_Rasterizer; }
+		// Counted since BeginFrame
+		const Stats& GetStats() const { return m_Stats; }
+
+	private:
+		static constexpr uint32_t MaxUniformBufferSlots = 16;
+
+		SoftwareDynamicRHI* m_SoftwareRHI;
+		SoftwareRasterizer m_Rasterizer;
+
+		GraphicsPipelineStateInitializer m_PipelineState;
+		// States are sticky like on the device, a pipeline without one keeps the previous
+		SoftwareRasterState m_RasterState;
+
+		const SoftwareIndexBuffer* m_IndexBuffer = nullptr;
+		std::array<const SoftwareVertexBuffer*, MaxVertexElementCount> m_VertexBuffers = {};
+		std::array<const SoftwareUniformBuffer*, MaxUniformBufferSlots> m_UniformBuffers = {};
+
+		// The rasterizer only points at the surfaces, hold the bound targets like the device does
+		std::vector<std::shared_ptr<void>> m_BoundTargets;
+
+		// Reused between draws
+		std::vector<SoftwareVertex> m_Vertices;
+		std::vector<uint32_t> m_Indices;
+
+		Stats m_Stats;
+	};
+}
@@ -0,0 +1,166 @@
+#include "LemonPCH.h"
+#include "SoftwareDynamicRHI.h"
+#include "SoftwareCommandList.h"
+#include "SoftwareResources.h"
+#include "Core/Engine.h"
+#include "Core/JobSystem.h"
+#include "Renderer/Renderer.h"
+#include "RenderCore/Containers/ResourceArray.h"
+#include "Log/Log.h"
+
+namespace Lemon
+{
+	namespace
+	{
+		// Buffers are created from a resource array, copy what it holds
+		const void* GetInitialData(const RHIResourceCreateInfo& createInfo, uint32_t size)
+		{
+			if (!createInfo.ResourceArray || createInfo.ResourceArray->GetResourceDataSize() < size)
+			{
+				return nullptr;
+			}
+			return createInfo.ResourceArray->GetResourceData();
+		}
+
+		ESoftwareShadingModel FindShadingModel(const std::string& filePath)
+		{
+			auto contains = [&filePath](const char* name) { return filePath.find(name) != std::string::npos; };
+
+			if (contains("DepthOnly"))
+			{
+				return ESoftwareShadingModel::DepthOnly;
+			}
+			if (contains("Sky") || contains("EnvironmentCube"))
+			{
+				return ESoftwareShadingModel::Sky;
+			}
+			if (contains("SimpleColor"))
+			{
+				return ESoftwareShadingModel::VertexColor;
+			}
+			// Cube map baking and full screen passes only make sense with textures
+			if (contains("Compute") || contains("Equirectangular") || contains("FullScreen") || contains("Lighting"))
+			{
+				return ESoftwareShadingModel::Unsupported;
+			}
+			return ESoftwareShadingModel::Lit;
+		}
+	}
+
+	SoftwareDynamicRHI::SoftwareDynamicRHI()
+	{
+	}
+
+	void SoftwareDynamicRHI::Init()
+	{
+		LEMON_CORE_INFO("Create Software RHI, {0} rasterizer", SoftwareRasterizer::GetInstructionSet());
+		AddDeviceAdapter(RHIDeviceAdapter(0, "Software Rasterizer", 0, nullptr));
+	}
+
+	void SoftwareDynamicRHI::Shutdown()
+	{
+		m_CommandList = nullptr;
+	}
+
+	//===================Begin RHI Methods ==================//
+	Ref<RHICommandList> SoftwareDynamicRHI::RHICreateCommandList(Renderer* renderer)
+	{
+		Ref<SoftwareCommandList> commandList = CreateRef<SoftwareCommandList>(this, renderer);
+		// Tiles are rasterized on the engine's workers when there are any
+		if (renderer && renderer->GetEngine())
+		{
+			commandList->GetRasterizer().SetJobSystem(renderer->GetEngine()->GetSystem<JobSystem>());
+		}
+		m_CommandList = commandList.get();
+		return commandList;
+	}
+
+	Ref<RHISwapChain> SoftwareDynamicRHI::RHICreateSwapChain(void* windowHandle, const uint32_t width, const uint32_t height, const ERHIPixelFormat format)
+	{
+		return CreateRef<SoftwareSwapChain>(width, height, format);
+	}
+
+	Ref<RHITexture2D> SoftwareDynamicRHI::RHICreateTexture2D(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHIResourceCreateInfo& CreateInfo)
+	{
+		Ref<RHITexture2D> texture = CreateRef<SoftwareTexture2D>(sizeX, sizeY, numMips, format, createFlags);
+		texture->SetName(CreateInfo.DebugName);
+		return texture;
+	}
+
+	Ref<RHITextureCube> SoftwareDynamicRHI::RHICreateTextureCube(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHITextureCubeCreateInfo& CreateInfo)
+	{
+		Ref<RHITextureCube> texture = CreateRef<SoftwareTextureCube>(sizeX, sizeY, numMips, format, createFlags);
+		texture->SetName(CreateInfo.DebugName);
+		return texture;
+	}
+
+	Ref<RHIVertexBuffer> SoftwareDynamicRHI::RHICreateVertexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo)
+	{
+		return CreateRef<SoftwareVertexBuffer>(size, usage, GetInitialData(createInfo, size));
+	}
+
+	Ref<RHIIndexBuffer> SoftwareDynamicRHI::RHICreateIndexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo)
+	{
+		return CreateRef<SoftwareIndexBuffer>(size, usage, GetInitialData(createInfo, size));
+	}
+
+	Ref<RHIUniformBufferBase> SoftwareDynamicRHI::RHICreateUniformBuffer(uint32_t size, const std::string& uniformBufferName)
+	{
+		return CreateRef<SoftwareUniformBuffer>(size);
+	}
+
+	Ref<RHIVertexShader> SoftwareDynamicRHI::RHICreateVertexShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo)
+	{
+		return CreateRef<SoftwareVertexShader>(filePath);
+	}
+
+	Ref<RHIPixelShader> SoftwareDynamicRHI::RHICreatePixelShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo)
+	{
+		return CreateRef<SoftwarePixelShader>(filePath, FindShadingModel(filePath));
+	}
+
+	Ref<RHIVertexDeclaration> SoftwareDynamicRHI::RHICreateVertexDeclaration(Ref<RHIVertexShader> vertexShader, const VertexDeclarationElementList& Elements)
+	{
+		return CreateRef<SoftwareVertexDeclaration>(Elements);
+	}
+
+	Ref<RHIDepthStencilState> SoftwareDynamicRHI::RHICreateDepthStencilState(const DepthStencilStateInitializer& initializer)
+	{
+		return CreateRef<SoftwareDepthStencilState>(initializer);
+	}
+
+	Ref<RHIBlendState> SoftwareDynamicRHI::RHICreateBlendState(const BlendStateInitializer& initializer)
+	{
+		return CreateRef<SoftwareBlendState>(initializer);
+	}
+
+	Ref<RHIRasterizerState> SoftwareDynamicRHI::RHICreateRasterizerState(const RasterizerStateInitializer& initializer)
+	{
+		return CreateRef<SoftwareRasterizerState>(initializer);
+	}
+
+	Ref<RHISamplerState> SoftwareDynamicRHI::RHICreateSamplerState(const SamplerStateInitializer& initializer)
+	{
+		return CreateRef<SoftwareSamplerState>(initializer);
+	}
+
+	void SoftwareDynamicRHI::SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures)
+	{
+		// Textures are not sampled, so their mips do not matter
+	}
+
+	void SoftwareDynamicRHI::RHIClearRenderTarget(Ref<RHISwapChain> swapChain, glm::vec4 backgroundColor)
+	{
+		if (swapChain)
+		{
+			static_cast<SoftwareSwapChain*>(swapChain.get())->GetBackBuffer().ClearColor(
+				SoftwareSurface::PackColor(backgroundColor.x, backgroundColor.y, backgroundColor.z, backgroundColor.w));
+		}
+	}
+	//===================End RHI Methods ==================//
+
+	SoftwareDynamicRHI* GetSoftwareDynamicRHI()
+	{
+		return dynamic_cast<SoftwareDynamicRHI*>(g_DynamicRHI);
+	}
+}
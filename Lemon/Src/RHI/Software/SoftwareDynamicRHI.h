@@ -0,0 +1,69 @@
+#pragma once
+#include "RHI/DynamicRHI.h"
+#include "RHI/RHIDefinitions.h"
+
+namespace Lemon
+{
+	class Renderer;
+	class SoftwareCommandList;
+
+	// RHI that renders on the CPU: render targets are SoftwareSurfaces and draws go through the tiled SoftwareRasterizer.
+	// Meant for golden image tests and CPU depth passes without a GPU, not for speed.
+	// Selected with RHISetBackend(ERHIBackend::Software) before the Renderer initializes.
+	class SoftwareDynamicRHI : public DynamicRHI
+	{
+	public:
+		SoftwareDynamicRHI();
+
+		virtual void Init() override;
+
+		virtual void Shutdown() override;
+
+		//===================Begin RHI Methods ==================//
+		virtual Ref<RHICommandList> RHICreateCommandList(Renderer* renderer) override;
+
+		virtual Ref<RHISwapChain> RHICreateSwapChain(void* windowHandle, const uint32_t width, const uint32_t height, const ERHIPixelFormat format) override;
+
+		virtual Ref<RHITexture2D> RHICreateTexture2D(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHIResourceCreateInfo& CreateInfo) override;
+
+		virtual Ref<RHITextureCube> RHICreateTextureCube(uint32_t sizeX, uint32_t sizeY, ERHIPixelFormat format, uint32_t numMips, uint32_t createFlags, RHITextureCubeCreateInfo& CreateInfo) override;
+
+		virtual Ref<RHIVertexBuffer> RHICreateVertexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo) override;
+
+		virtual Ref<RHIIndexBuffer> RHICreateIndexBuffer(uint32_t size, uint32_t usage, RHIResourceCreateInfo& createInfo) override;
+
+		virtual Ref<RHIUniformBufferBase> RHICreateUniformBuffer(uint32_t size, const std::string& uniformBufferName) override;
+
+		virtual Ref<RHIVertexShader> RHICreateVertexShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo) override;
+
+		virtual Ref<RHIPixelShader> RHICreatePixelShader(const std::string& filePath, const std::string& entryPoint, RHIShaderCreateInfo& createInfo) override;
+
+		virtual Ref<RHIVertexDeclaration> RHICreateVertexDeclaration(Ref<RHIVertexShader> vertexShader, const VertexDeclarationElementList& Elements) override;
+
+		// ====STATE======
+		virtual Ref<RHIDepthStencilState> RHICreateDepthStencilState(const DepthStencilStateInitializer& initializer) override;
+
+		virtual Ref<RHIBlendState> RHICreateBlendState(const BlendStateInitializer& initializer) override;
+
+		virtual Ref<RHIRasterizerState> RHICreateRasterizerState(const RasterizerStateInitializer& initializer) override;
+
+		virtual Ref<RHISamplerState> RHICreateSamplerState(const SamplerStateInitializer& initializer) override;
+
+		// ====Texture Settings====//
+		virtual void SetMipTexture(Ref<RHITextureCube> targetTex, int mipIndex, int mipWidth, int mipHeight, RHITexture2DArrayView mipTextures) override;
+
+		//========Just Debug
+		virtual void RHIClearRenderTarget(Ref<RHISwapChain> swapChain, glm::vec4 backgroundColor) override;
+
+		//===================End RHI Methods ==================//
+
+		// The command list handed to the Renderer, null until it asked for one
+		SoftwareCommandList* GetCommandList() const { return m_CommandList; }
+
+	private:
+		SoftwareCommandList* m_CommandList = nullptr;
+	};
+
+	// Software RHI if that is the active one
+	SoftwareDynamicRHI* GetSoftwareDynamicRHI();
+}
@@ -0,0 +1,628 @@
+#include "LemonPCH.h"
+#include "SoftwareRasterizer.h"
+#include "Core/JobSystem.h"
+#include "Math/SimdLanes.h"
+#include <cmath>
+#include <fstream>
+
+namespace Lemon
+{
+	namespace
+	{
+		// Vertices are snapped to this grid so shared edges produce bit identical edge functions
+		constexpr float SubPixelScale = 256.0f;
+		// Clip space guard band, only triangles reaching further out than this are clipped in x and y
+		constexpr float GuardBand = 8.0f;
+		// Below this many triangles a draw is not worth the scheduling cost
+		constexpr uint32_t ParallelTriangleThreshold = 64;
+		// Triangle clipped against all six planes
+		constexpr uint32_t MaxClippedVertices = 9;
+
+		//====================Span====================//
+		// One horizontal run of pixels evaluated together. SimdLanes never fuses multiply-add so that
+		// two triangles sharing an edge always agree on which side a pixel center is.
+#if LEMON_SIMD_AVX2
+		struct Span : SimdLanes
+		{
+			static constexpr uint32_t Lanes = Count;
+
+			static FORCEINLINE Float PixelCenters() { return _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f); }
+
+			static FORCEINLINE Mask Compare(Float a, Float b, ECompareFunction function)
+			{
+				switch (function)
+				{
+				case CF_Less:			return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+				case CF_LessEqual:		return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+				case CF_Greater:		return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+				case CF_GreaterEqual:	return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+				case CF_Equal:			return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+				case CF_NotEqual:		return _mm256_cmp_ps(a, b, _CMP_NEQ_OQ);
+				case CF_Never:			return _mm256_setzero_ps();
+				default:				return _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				}
+			}
+
+			static FORCEINLINE Int PackColor(Float r, Float g, Float b, Float a)
+			{
+				const Float zero = _mm256_setzero_ps();
+				const Float one = _mm256_set1_ps(1.0f);
+				const Float scale = _mm256_set1_ps(255.0f);
+				const Float half = _mm256_set1_ps(0.5f);
+				// max first, it returns zero for NaN
+				auto toByte = [&](Float channel) { return _mm256_cvttps_epi32(MulAdd(_mm256_min_ps(_mm256_max_ps(channel, zero), one), scale, half)); };
+				return _mm256_or_si256(
+					_mm256_or_si256(toByte(r), _mm256_slli_epi32(toByte(g), 8)),
+					_mm256_or_si256(_mm256_slli_epi32(toByte(b), 16), _mm256_slli_epi32(toByte(a), 24)));
+			}
+		};
+#elif LEMON_SIMD_SSE2
+		struct Span : SimdLanes
+		{
+			static constexpr uint32_t Lanes = Count;
+
+			static FORCEINLINE Float PixelCenters() { return _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f); }
+
+			static FORCEINLINE Mask Compare(Float a, Float b, ECompareFunction function)
+			{
+				switch (function)
+				{
+				case CF_Less:			return _mm_cmplt_ps(a, b);
+				case CF_LessEqual:		return _mm_cmple_ps(a, b);
+				case CF_Greater:		return _mm_cmpgt_ps(a, b);
+				case CF_GreaterEqual:	return _mm_cmpge_ps(a, b);
+				case CF_Equal:			return _mm_cmpeq_ps(a, b);
+				case CF_NotEqual:		return _mm_and_ps(_mm_cmpneq_ps(a, b), _mm_cmpord_ps(a, b));
+				case CF_Never:			return _mm_setzero_ps();
+				default:				return _mm_castsi128_ps(_mm_set1_epi32(-1));
+				}
+			}
+
+			static FORCEINLINE Int PackColor(Float r, Float g, Float b, Float a)
+			{
+				const Float zero = _mm_setzero_ps();
+				const Float one = _mm_set1_ps(1.0f);
+				const Float scale = _mm_set1_ps(255.0f);
+				const Float half = _mm_set1_ps(0.5f);
+				// max first, it returns zero for NaN
+				auto toByte = [&](Float channel) { return _mm_cvttps_epi32(MulAdd(_mm_min_ps(_mm_max_ps(channel, zero), one), scale, half)); };
+				return _mm_or_si128(
+					_mm_or_si128(toByte(r), _mm_slli_epi32(toByte(g), 8)),
+					_mm_or_si128(_mm_slli_epi32(toByte(b), 16), _mm_slli_epi32(toByte(a), 24)));
+			}
+		};
+#else
+		struct Span : SimdLanes
+		{
+			static constexpr uint32_t Lanes = Count;
+
+			static FORCEINLINE Float PixelCenters() { return 0.5f; }
+
+			static FORCEINLINE Mask Compare(Float a, Float b, ECompareFunction function)
+			{
+				switch (function)
+				{
+				case CF_Less:			return a < b;
+				case CF_LessEqual:		return a <= b;
+				case CF_Greater:		return a > b;
+				case CF_GreaterEqual:	return a >= b;
+				case CF_Equal:			return a == b;
+				case CF_NotEqual:		return a < b || a > b;
+				case CF_Never:			return false;
+				default:				return true;
+				}
+			}
+
+			static FORCEINLINE Int PackColor(Float r, Float g, Float b, Float a) { return static_cast<Int>(SoftwareSurface::PackColor(r, g, b, a)); }
+		};
+#endif
+		static_assert(SoftwareRasterizer::TileSize % Span::Lanes == 0, "A span must never cross a tile");
+		static_assert(SoftwareSurface::RowAlignment % Span::Lanes == 0, "A span must never cross a row");
+
+		// Signed distances to the clip volume planes, inside when >= 0
+		FORCEINLINE float ClipDistance(const SoftwareVertex& vertex, uint32_t plane)
+		{
+			const float* p = vertex.Position;
+			switch (plane)
+			{
+			case 0: return p[2];					// near, depth is [0, 1]
+			case 1: return p[3] - p[2];				// far
+			case 2: return GuardBand * p[3] + p[0];
+			case 3: return GuardBand * p[3] - p[0];
+			case 4: return GuardBand * p[3] + p[1];
+			default: return GuardBand * p[3] - p[1];
+			}
+		}
+
+		SoftwareVertex LerpVertex(const SoftwareVertex& a, const SoftwareVertex& b, float t)
+		{
+			SoftwareVertex result;
+			for (int i = 0; i < 4; i++)
+			{
+				result.Position[i] = a.Position[i] + (b.Position[i] - a.Position[i]) * t;
+				result.Color[i] = a.Color[i] + (b.Color[i] - a.Color[i]) * t;
+			}
+			return result;
+		}
+	}
+
+	//====================SoftwareSurface====================//
+	void SoftwareSurface::Allocate(uint32_t width, uint32_t height, bool bColor, bool bDepth)
+	{
+		Width = width;
+		Height = height;
+		Pitch = (width + RowAlignment - 1) / RowAlignment * RowAlignment;
+
+		const size_t pixelCount = static_cast<size_t>(Pitch) * height;
+		Color.assign(bColor ? pixelCount : 0, 0u);
+		Depth.assign(bDepth ? pixelCount : 0, 1.0f);
+	}
+
+	void SoftwareSurface::ClearColor(uint32_t packedColor)
+	{
+		std::fill(Color.begin(), Color.end(), packedColor);
+	}
+
+	void SoftwareSurface::ClearDepth(float depth)
+	{
+		std::fill(Depth.begin(), Depth.end(), depth);
+	}
+
+	bool SoftwareSurface::WritePPM(const std::string& filePath) const
+	{
+		if (!HasColor())
+		{
+			return false;
+		}
+		std::ofstream file(filePath, std::ios::out | std::ios::binary);
+		if (!file)
+		{
+			LEMON_CORE_ERROR("Can not write {0}", filePath);
+			return false;
+		}
+
+		file << "P6\n" << Width << " " << Height << "\n255\n";
+		std::vector<char> row(static_cast<size_t>(Width) * 3);
+		for (uint32_t y = 0; y < Height; y++)
+		{
+			for (uint32_t x = 0; x < Width; x++)
+			{
+				const uint32_t color = ReadColor(x, y);
+				row[x * 3] = static_cast<char>(color & 0xff);
+				row[x * 3 + 1] = static_cast<char>((color >> 8) & 0xff);
+				row[x * 3 + 2] = static_cast<char>((color >> 16) & 0xff);
+			}
+			file.write(row.data(), row.size());
+		}
+		return file.good();
+	}
+
+	uint32_t SoftwareSurface::PackColor(float r, float g, float b, float a)
+	{
+		auto toByte = [](float channel) { return static_cast<uint32_t>((std::min)((std::max)(channel, 0.0f), 1.0f) * 255.0f + 0.5f); };
+		return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+	}
+
+	//====================SoftwareRasterizer====================//
+	const char* SoftwareRasterizer::GetInstructionSet()
+	{
+		return Span::Name();
+	}
+
+	void SoftwareRasterizer::SetRenderTargets(SoftwareSurface* const* colorTargets, uint32_t numColorTargets, SoftwareSurface* depthTarget)
+	{
+		m_NumColorTargets = 0;
+		for (uint32_t i = 0; i < numColorTargets && i < MaxColorTargets; i++)
+		{
+			if (colorTargets[i] && colorTargets[i]->HasColor())
+			{
+				m_ColorTargets[m_NumColorTargets++] = colorTargets[i];
+			}
+		}
+		m_DepthTarget = depthTarget && depthTarget->HasDepth() ? depthTarget : nullptr;
+		UpdateBounds();
+	}
+
+	void SoftwareRasterizer::SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth)
+	{
+		m_Viewport[0] = x;
+		m_Viewport[1] = y;
+		m_Viewport[2] = width;
+		m_Viewport[3] = height;
+		m_Viewport[4] = minDepth;
+		m_Viewport[5] = maxDepth;
+		UpdateBounds();
+	}
+
+	void SoftwareRasterizer::UpdateBounds()
+	{
+		int32_t width = INT32_MAX;
+		int32_t height = INT32_MAX;
+		bool bHasTarget = false;
+		auto clampToSurface = [&](const SoftwareSurface* surface)
+		{
+			width = (std::min)(width, static_cast<int32_t>(surface->Width));
+			height = (std::min)(height, static_cast<int32_t>(surface->Height));
+			bHasTarget = true;
+		};
+		for (uint32_t i = 0; i < m_NumColorTargets; i++)
+		{
+			clampToSurface(m_ColorTargets[i]);
+		}
+		if (m_DepthTarget)
+		{
+			clampToSurface(m_DepthTarget);
+		}
+		if (!bHasTarget)
+		{
+			width = height = 0;
+		}
+
+		m_BoundsMinX = (std::max)(static_cast<int32_t>(std::ceil(m_Viewport[0] - 0.5f)), 0);
+		m_BoundsMinY = (std::max)(static_cast<int32_t>(std::ceil(m_Viewport[1] - 0.5f)), 0);
+		m_BoundsMaxX = (std::min)(static_cast<int32_t>(std::ceil(m_Viewport[0] + m_Viewport[2] - 0.5f)), width);
+		m_BoundsMaxY = (std::min)(static_cast<int32_t>(std::ceil(m_Viewport[1] + m_Viewport[3] - 0.5f)), height);
+
+		// The grid starts at pixel 0 so tile origins stay span aligned
+		m_NumTilesX = m_BoundsMaxX > 0 ? (m_BoundsMaxX + TileSize - 1) / TileSize : 0;
+		m_NumTilesY = m_BoundsMaxY > 0 ? (m_BoundsMaxY + TileSize - 1) / TileSize : 0;
+		if (m_TileBins.size() < static_cast<size_t>(m_NumTilesX) * m_NumTilesY)
+		{
+			m_TileBins.resize(static_cast<size_t>(m_NumTilesX) * m_NumTilesY);
+		}
+	}
+
+	void SoftwareRasterizer::DrawTriangles(const SoftwareVertex* vertices, const uint32_t* indices, uint32_t numTriangles, const SoftwareRasterState& state)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		m_Stats.TrianglesSubmitted += numTriangles;
+		if (numTriangles == 0 || m_BoundsMinX >= m_BoundsMaxX || m_BoundsMinY >= m_BoundsMaxY)
+		{
+			return;
+		}
+
+		//====Setup====//
+		m_Triangles.clear();
+		for (uint32_t i = 0; i < numTriangles; i++)
+		{
+			ClipAndSetup(vertices[indices[i * 3]], vertices[indices[i * 3 + 1]], vertices[indices[i * 3 + 2]], state);
+		}
+		m_Stats.TrianglesRasterized += m_Triangles.size();
+		if (m_Triangles.empty())
+		{
+			return;
+		}
+
+		//====Binning====//
+		// In submission order, so each tile still sees its triangles in draw order
+		m_ActiveTiles.clear();
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_Triangles.size()); i++)
+		{
+			const RasterTriangle& triangle = m_Triangles[i];
+			for (int32_t tileY = triangle.MinY / static_cast<int32_t>(TileSize); tileY <= triangle.MaxY / static_cast<int32_t>(TileSize); tileY++)
+			{
+				for (int32_t tileX = triangle.MinX / static_cast<int32_t>(TileSize); tileX <= triangle.MaxX / static_cast<int32_t>(TileSize); tileX++)
+				{
+					const uint32_t tileIndex = tileY * m_NumTilesX + tileX;
+					std::vector<uint32_t>& bin = m_TileBins[tileIndex];
+					if (bin.empty())
+					{
+						m_ActiveTiles.push_back(tileIndex);
+					}
+					bin.push_back(i);
+				}
+			}
+		}
+		m_Stats.TilesRasterized += m_ActiveTiles.size();
+
+		//====Raster====//
+		const uint32_t numActiveTiles = static_cast<uint32_t>(m_ActiveTiles.size());
+		if (m_JobSystem && numActiveTiles > 1 && m_Triangles.size() >= ParallelTriangleThreshold)
+		{
+			JobHandle handle = m_JobSystem->ParallelFor(numActiveTiles, 1, [this, &state](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; i++)
+					{
+						RasterizeTile(m_ActiveTiles[i], state);
+					}
+				});
+			m_JobSystem->Wait(handle);
+		}
+		else
+		{
+			for (uint32_t tileIndex : m_ActiveTiles)
+			{
+				RasterizeTile(tileIndex, state);
+			}
+		}
+
+		for (uint32_t tileIndex : m_ActiveTiles)
+		{
+			m_TileBins[tileIndex].clear();
+		}
+	}
+
+	void SoftwareRasterizer::ClipAndSetup(const SoftwareVertex& v0, const SoftwareVertex& v1, const SoftwareVertex& v2, const SoftwareRasterState& state)
+	{
+		const SoftwareVertex* triangle[3] = { &v0, &v1, &v2 };
+
+		uint32_t outsideMask = 0;
+		for (uint32_t plane = 0; plane < 6; plane++)
+		{
+			uint32_t outsideCount = 0;
+			for (const SoftwareVertex* vertex : triangle)
+			{
+				outsideCount += ClipDistance(*vertex, plane) < 0.0f ? 1 : 0;
+			}
+			if (outsideCount == 3)
+			{
+				return;
+			}
+			if (outsideCount > 0)
+			{
+				outsideMask |= 1u << plane;
+			}
+		}
+
+		if (outsideMask == 0)
+		{
+			SetupTriangle(triangle, state);
+			return;
+		}
+
+		// Sutherland-Hodgman against the planes the triangle crosses, then fan the polygon back into triangles
+		SoftwareVertex polygons[2][MaxClippedVertices];
+		uint32_t count = 3;
+		polygons[0][0] = v0;
+		polygons[0][1] = v1;
+		polygons[0][2] = v2;
+		uint32_t current = 0;
+
+		for (uint32_t plane = 0; plane < 6 && count >= 3; plane++)
+		{
+			if ((outsideMask & (1u << plane)) == 0)
+			{
+				continue;
+			}
+			const SoftwareVertex* input = polygons[current];
+			SoftwareVertex* output = polygons[current ^ 1];
+			uint32_t outputCount = 0;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const SoftwareVertex& a = input[i];
+				const SoftwareVertex& b = input[(i + 1) % count];
+				const float distanceA = ClipDistance(a, plane);
+				const float distanceB = ClipDistance(b, plane);
+				if (distanceA >= 0.0f)
+				{
+					output[outputCount++] = a;
+				}
+				if ((distanceA >= 0.0f) != (distanceB >= 0.0f) && outputCount < MaxClippedVertices)
+				{
+					output[outputCount++] = LerpVertex(a, b, distanceA / (distanceA - distanceB));
+				}
+			}
+			count = outputCount;
+			current ^= 1;
+		}
+
+		for (uint32_t i = 1; i + 1 < count; i++)
+		{
+			const SoftwareVertex* fan[3] = { &polygons[current][0], &polygons[current][i], &polygons[current][i + 1] };
+			SetupTriangle(fan, state);
+		}
+	}
+
+	void SoftwareRasterizer::SetupTriangle(const SoftwareVertex* vertices[3], const SoftwareRasterState& state)
+	{
+		float screenX[3], screenY[3], depth[3], invW[3];
+		for (int i = 0; i < 3; i++)
+		{
+			const float* position = vertices[i]->Position;
+			if (!(position[3] > 0.0f))
+			{
+				return;
+			}
+			invW[i] = 1.0f / position[3];
+			const float ndcX = position[0] * invW[i];
+			const float ndcY = position[1] * invW[i];
+			const float ndcZ = position[2] * invW[i];
+			// Render target y points down
+			screenX[i] = std::round((m_Viewport[0] + (ndcX * 0.5f + 0.5f) * m_Viewport[2]) * SubPixelScale) / SubPixelScale;
+			screenY[i] = std::round((m_Viewport[1] + (0.5f - ndcY * 0.5f) * m_Viewport[3]) * SubPixelScale) / SubPixelScale;
+			depth[i] = m_Viewport[4] + ndcZ * (m_Viewport[5] - m_Viewport[4]);
+		}
+
+		float area = (screenX[1] - screenX[0]) * (screenY[2] - screenY[0]) - (screenX[2] - screenX[0]) * (screenY[1] - screenY[0]);
+		if (!(std::abs(area) > 0.0f))
+		{
+			return;
+		}
+
+		// Counter clockwise on the render target is the front face, matching the D3D11 rasterizer state
+		const bool bFrontFace = area < 0.0f;
+		if ((state.CullMode == RCM_Back && !bFrontFace) || (state.CullMode == RCM_Front && bFrontFace))
+		{
+			return;
+		}
+
+		// Reorder so the area is positive and every edge function is positive inside
+		int order[3] = { 0, 1, 2 };
+		if (area < 0.0f)
+		{
+			std::swap(order[1], order[2]);
+			area = -area;
+		}
+
+		RasterTriangle& triangle = m_Triangles.emplace_back();
+		for (int edge = 0; edge < 3; edge++)
+		{
+			// Edge opposite to vertex 'edge', so its function is that vertex's barycentric weight times the area
+			const int a = order[(edge + 1) % 3];
+			const int b = order[(edge + 2) % 3];
+			const float stepX = screenY[a] - screenY[b];
+			const float stepY = screenX[b] - screenX[a];
+			triangle.Edge[edge][0] = stepX;
+			triangle.Edge[edge][1] = stepY;
+			triangle.Edge[edge][2] = screenX[a] * screenY[b] - screenY[a] * screenX[b];
+			// Exactly one of the two triangles sharing an edge sees it this way round, so it owns the pixels on it
+			triangle.bInclusive[edge] = stepX > 0.0f || (stepX == 0.0f && stepY > 0.0f);
+		}
+
+		const float invArea = 1.0f / area;
+		auto setupPlane = [&](float (&plane)[3], float value0, float value1, float value2)
+		{
+			const float values[3] = { value0, value1, value2 };
+			for (int component = 0; component < 3; component++)
+			{
+				plane[component] = (values[order[0]] * triangle.Edge[0][component]
+					+ values[order[1]] * triangle.Edge[1][component]
+					+ values[order[2]] * triangle.Edge[2][component]) * invArea;
+			}
+		};
+		setupPlane(triangle.Depth, depth[0], depth[1], depth[2]);
+		setupPlane(triangle.InvW, invW[0], invW[1], invW[2]);
+		for (int channel = 0; channel < 4; channel++)
+		{
+			setupPlane(triangle.Color[channel],
+				vertices[0]->Color[channel] * invW[0],
+				vertices[1]->Color[channel] * invW[1],
+				vertices[2]->Color[channel] * invW[2]);
+		}
+
+		const float minX = (std::min)({ screenX[0], screenX[1], screenX[2] });
+		const float maxX = (std::max)({ screenX[0], screenX[1], screenX[2] });
+		const float minY = (std::min)({ screenY[0], screenY[1], screenY[2] });
+		const float maxY = (std::max)({ screenY[0], screenY[1], screenY[2] });
+		triangle.MinX = (std::max)(static_cast<int32_t>(std::floor(minX)), m_BoundsMinX);
+		triangle.MinY = (std::max)(static_cast<int32_t>(std::floor(minY)), m_BoundsMinY);
+		triangle.MaxX = (std::min)(static_cast<int32_t>(std::floor(maxX)), m_BoundsMaxX - 1);
+		triangle.MaxY = (std::min)(static_cast<int32_t>(std::floor(maxY)), m_BoundsMaxY - 1);
+		if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+		{
+			m_Triangles.pop_back();
+		}
+	}
+
+	void SoftwareRasterizer::RasterizeTile(uint32_t tileIndex, const SoftwareRasterState& state) const
+	{
+		using Float = Span::Float;
+		using Mask = Span::Mask;
+
+		const int32_t tileX = static_cast<int32_t>(tileIndex % m_NumTilesX * TileSize);
+		const int32_t tileY = static_cast<int32_t>(tileIndex / m_NumTilesX * TileSize);
+		const int32_t tileMaxX = (std::min)(tileX + static_cast<int32_t>(TileSize), m_BoundsMaxX) - 1;
+		const int32_t tileMaxY = (std::min)(tileY + static_cast<int32_t>(TileSize), m_BoundsMaxY) - 1;
+
+		const bool bDepthTest = m_DepthTarget && state.DepthTest != CF_Always;
+		const bool bDepthWrite = m_DepthTarget && state.bDepthWrite;
+		const bool bColorWrite = state.bColorWrite && m_NumColorTargets > 0;
+
+		// Depth is clamped to the viewport range like the hardware does
+		const Float depthMin = Span::Splat((std::min)(m_Viewport[4], m_Viewport[5]));
+		const Float depthMax = Span::Splat((std::max)(m_Viewport[4], m_Viewport[5]));
+		const Float pixelCenters = Span::PixelCenters();
+		const Float zero = Span::Splat(0.0f);
+
+		for (uint32_t triangleIndex : m_TileBins[tileIndex])
+		{
+			const RasterTriangle& triangle = m_Triangles[triangleIndex];
+			const int32_t minX = (std::max)(triangle.MinX, tileX);
+			const int32_t minY = (std::max)(triangle.MinY, tileY);
+			const int32_t maxX = (std::min)(triangle.MaxX, tileMaxX);
+			const int32_t maxY = (std::min)(triangle.MaxY, tileMaxY);
+			if (minX > maxX || minY > maxY)
+			{
+				continue;
+			}
+
+			// Pixels of the first and last span outside [minX, maxX] are masked off
+			const int32_t firstSpanX = tileX + ((minX - tileX) & ~static_cast<int32_t>(Span::Lanes - 1));
+			const Float spanMinX = Span::Splat(static_cast<float>(minX));
+			const Float spanMaxX = Span::Splat(static_cast<float>(maxX) + 1.0f);
+
+			Float edgeStepX[3];
+			ECompareFunction edgeTest[3];
+			for (int edge = 0; edge < 3; edge++)
+			{
+				edgeStepX[edge] = Span::Splat(triangle.Edge[edge][0]);
+				edgeTest[edge] = triangle.bInclusive[edge] ? CF_GreaterEqual : CF_Greater;
+			}
+			const Float depthStepX = Span::Splat(triangle.Depth[0]);
+			const Float invWStepX = Span::Splat(triangle.InvW[0]);
+			Float colorStepX[4];
+			for (int channel = 0; channel < 4; channel++)
+			{
+				colorStepX[channel] = Span::Splat(triangle.Color[channel][0]);
+			}
+
+			for (int32_t y = minY; y <= maxY; y++)
+			{
+				const float pixelY = static_cast<float>(y) + 0.5f;
+				Float edgeRow[3];
+				for (int edge = 0; edge < 3; edge++)
+				{
+					edgeRow[edge] = Span::Splat(triangle.Edge[edge][1] * pixelY + triangle.Edge[edge][2]);
+				}
+				const Float depthRow = Span::Splat(triangle.Depth[1] * pixelY + triangle.Depth[2]);
+				float* depthPixels = m_DepthTarget ? m_DepthTarget->Depth.data() + static_cast<size_t>(y) * m_DepthTarget->Pitch : nullptr;
+
+				for (int32_t x = firstSpanX; x <= maxX; x += Span::Lanes)
+				{
+					const Float pixelX = Span::Add(Span::Splat(static_cast<float>(x)), pixelCenters);
+
+					Mask coverage = Span::And(Span::Compare(pixelX, spanMinX, CF_GreaterEqual), Span::Compare(pixelX, spanMaxX, CF_Less));
+					for (int edge = 0; edge < 3; edge++)
+					{
+						coverage = Span::And(coverage, Span::Compare(Span::MulAdd(edgeStepX[edge], pixelX, edgeRow[edge]), zero, edgeTest[edge]));
+					}
+					if (!Span::Any(coverage))
+					{
+						continue;
+					}
+
+					if (depthPixels)
+					{
+						const Float depth = Span::Min(Span::Max(Span::MulAdd(depthStepX, pixelX, depthRow), depthMin), depthMax);
+						const Float previousDepth = Span::Load(depthPixels + x);
+						if (bDepthTest)
+						{
+							coverage = Span::And(coverage, Span::Compare(depth, previousDepth, state.DepthTest));
+							if (!Span::Any(coverage))
+							{
+								continue;
+							}
+						}
+						if (bDepthWrite)
+						{
+							Span::Store(depthPixels + x, Span::Select(coverage, depth, previousDepth));
+						}
+					}
+
+					if (!bColorWrite)
+					{
+						continue;
+					}
+
+					// Perspective correct: color / w and 1 / w are linear in screen space
+					const Float w = Span::Reciprocal(Span::MulAdd(invWStepX, pixelX, Span::Splat(triangle.InvW[1] * pixelY + triangle.InvW[2])));
+					Float color[4];
+					for (int channel = 0; channel < 4; channel++)
+					{
+						const Float colorRow = Span::Splat(triangle.Color[channel][1] * pixelY + triangle.Color[channel][2]);
+						color[channel] = Span::Mul(Span::MulAdd(colorStepX[channel], pixelX, colorRow), w);
+					}
+					const Span::Int packedColor = Span::PackColor(color[0], color[1], color[2], color[3]);
+
+					for (uint32_t target = 0; target < m_NumColorTargets; target++)
+					{
+						SoftwareSurface* surface = m_ColorTargets[target];
+						uint32_t* pixels = surface->Color.data() + static_cast<size_t>(y) * surface->Pitch + x;
+						Span::StoreInt(pixels, Span::SelectInt(coverage, packedColor, Span::LoadInt(pixels)));
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "Core/Core.h"
+#include "RHI/RHI.h"
+#include <string>
+#include <vector>
+
+namespace Lemon
+{
+	class JobSystem;
+
+	// CPU side render target. Color is RGBA8 with R in the lowest byte, depth is float.
+	// Rows are padded to whole SIMD spans so a span never reaches into the next row.
+	struct LEMON_API SoftwareSurface
+	{
+		static constexpr uint32_t RowAlignment = 8;
+
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		// In pixels
+		uint32_t Pitch = 0;
+		std::vector<uint32_t> Color;
+		std::vector<float> Depth;
+
+		void Allocate(uint32_t width, uint32_t height, bool bColor, bool bDepth);
+
+		bool HasColor() const { return !Color.empty(); }
+		bool HasDepth() const { return !Depth.empty(); }
+
+		void ClearColor(uint32_t packedColor);
+		void ClearDepth(float depth);
+
+		uint32_t ReadColor(uint32_t x, uint32_t y) const { return Color[y * Pitch + x]; }
+		float ReadDepth(uint32_t x, uint32_t y) const { return Depth[y * Pitch + x]; }
+
+		// Binary PPM of the color, alpha is dropped. For golden image comparisons.
+		bool WritePPM(const std::string& filePath) const;
+
+		static uint32_t PackColor(float r, float g, float b, float a);
+	};
+
+	// Output of the vertex stage, clip space position and the color interpolated across the triangle
+	struct SoftwareVertex
+	{
+		float Position[4];
+		float Color[4];
+	};
+
+	struct SoftwareRasterState
+	{
+		ERasterizerCullMode CullMode = RCM_Back;
+		ECompareFunction DepthTest = CF_LessEqual;
+		bool bDepthWrite = true;
+		bool bColorWrite = true;
+	};
+
+	// Tiled triangle rasterizer. A draw is set up and binned into screen tiles on the calling thread,
+	// the tiles are then rasterized in parallel, each one owns its pixels so no synchronization is needed.
+	// Coverage, depth and color are evaluated for a whole SIMD span of pixels at once (8 with AVX2, 4 with SSE2).
+	class LEMON_API SoftwareRasterizer
+	{
+	public:
+		static constexpr uint32_t TileSize = 64;
+		static constexpr uint32_t MaxColorTargets = MaxSimultaneousRenderTargets;
+
+		struct Stats
+		{
+			uint64_t TrianglesSubmitted = 0;
+			// Survived clipping and culling
+			uint64_t TrianglesRasterized = 0;
+			uint64_t TilesRasterized = 0;
+		};
+
+	public:
+		// Without a job system every tile is rasterized on the calling thread
+		void SetJobSystem(JobSystem* jobSystem) { m_JobSystem = jobSystem; }
+
+		void SetRenderTargets(SoftwareSurface* const* colorTargets, uint32_t numColorTargets, SoftwareSurface* depthTarget);
+		void SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth);
+
+		// Triangle list, three indices per triangle
+		void DrawTriangles(const SoftwareVertex* vertices, const uint32_t* indices, uint32_t numTriangles, const SoftwareRasterState& state);
+
+		const Stats& GetStats() const { return m_Stats; }
+		void ResetStats() { m_Stats = {}; }
+
+		// Which instruction set the span loops were compiled for
+		static const char* GetInstructionSet();
+
+	private:
+		// Screen space triangle, every interpolant is a plane: value = X * px + Y * py + Z
+		struct RasterTriangle
+		{
+			float Edge[3][3];
+			float Depth[3];
+			float InvW[3];
+			// Color divided by w, so it can be interpolated linearly in screen space
+			float Color[4][3];
+			int32_t MinX, MinY, MaxX, MaxY;
+			// Edges that own the pixels exactly on them
+			bool bInclusive[3];
+		};
+
+		void UpdateBounds();
+		void ClipAndSetup(const SoftwareVertex& v0, const SoftwareVertex& v1, const SoftwareVertex& v2, const SoftwareRasterState& state);
+		void SetupTriangle(const SoftwareVertex* vertices[3], const SoftwareRasterState& state);
+		void RasterizeTile(uint32_t tileIndex, const SoftwareRasterState& state) const;
+
+	private:
+		JobSystem* m_JobSystem = nullptr;
+
+		SoftwareSurface* m_ColorTargets[MaxColorTargets] = {};
+		uint32_t m_NumColorTargets = 0;
+		SoftwareSurface* m_DepthTarget = nullptr;
+
+		float m_Viewport[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+		// Pixels that may be written, viewport clamped to the smallest bound target, max is exclusive
+		int32_t m_BoundsMinX = 0;
+		int32_t m_BoundsMinY = 0;
+		int32_t m_BoundsMaxX = 0;
+		int32_t m_BoundsMaxY = 0;
+		uint32_t m_NumTilesX = 0;
+		uint32_t m_NumTilesY = 0;
+
+		// Reused between draws
+		std::vector<RasterTriangle> m_Triangles;
+		std::vector<std::vector<uint32_t>> m_TileBins;
+		std::vector<uint32_t> m_ActiveTiles;
+
+		Stats m_Stats;
+	};
+}
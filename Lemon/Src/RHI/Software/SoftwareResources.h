@@ -0,0 +1,297 @@
+#pragma once
+#include "Core/Core.h"
+#include "RHI/RHI.h"
+#include "RHI/RHIResources.h"
+#include "RHI/RHISwapChain.h"
+#include "SoftwareRasterizer.h"
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace Lemon
+{
+	// CPU resources of the software RHI. Render targets own a SoftwareSurface the rasterizer draws into,
+	// buffers keep their contents so draws can fetch vertices and read uniforms directly.
+
+	inline bool IsSoftwareDepthFormat(ERHIPixelFormat format)
+	{
+		return format == RHI_PF_D32_Float || format == RHI_PF_D32_Float_S8X24_Uint;
+	}
+
+	//==========================Textures==========================//
+	class SoftwareTexture2D : public RHITexture2D
+	{
+	public:
+		SoftwareTexture2D(uint32_t sizeX, uint32_t sizeY, uint32_t numMips, ERHIPixelFormat textureFormat, uint32_t createFlags)
+			: RHITexture2D(sizeX, sizeY, numMips, textureFormat)
+		{
+			// Only targets get storage, sampled textures are never read by the fixed function shading
+			if (createFlags & (RHI_TexCreate_RenderTargetable | RHI_TexCreate_DepthStencilTargetable))
+			{
+				const bool bDepth = IsSoftwareDepthFormat(textureFormat);
+				m_Surface.Allocate(sizeX, sizeY, !bDepth, bDepth);
+			}
+		}
+
+		SoftwareSurface& GetSurface() { return m_Surface; }
+		const SoftwareSurface& GetSurface() const { return m_Surface; }
+
+		//=========RHI Resource====================
+		virtual void* GetNativeResource() override final { return this; }
+		virtual void* GetNativeShaderResourceView() override final { return this; }
+		virtual void* GetNativeRenderTargetView(int index) override final { return this; }
+		virtual void* GetNativeDepthStencilView() override final { return this; }
+		//=========================================
+
+	private:
+		SoftwareSurface m_Surface;
+	};
+
+	class SoftwareTextureCube : public RHITextureCube
+	{
+	public:
+		static constexpr uint32_t FaceCount = 6;
+
+		SoftwareTextureCube(uint32_t sizeX, uint32_t sizeY, uint32_t numMips, ERHIPixelFormat textureFormat, uint32_t createFlags)
+			: RHITextureCube(sizeX, sizeY, numMips, textureFormat)
+		{
+			if (createFlags & RHI_TexCreate_RenderTargetable)
+			{
+				for (SoftwareSurface& face : m_Faces)
+				{
+					face.Allocate(sizeX, sizeY, true, false);
+				}
+			}
+		}
+
+		SoftwareSurface* GetSurface(int face) { return face >= 0 && face < static_cast<int>(FaceCount) ? &m_Faces[face] : nullptr; }
+
+		//=========RHI Resource====================
+		virtual void* GetNativeResource() override final { return this; }
+		virtual void* GetNativeShaderResourceView() override final { return this; }
+		virtual void* GetNativeRenderTargetView(int index) override final { return this; }
+		virtual void* GetNativeDepthStencilView() override final { return this; }
+		//=========================================
+
+	private:
+		std::array<SoftwareSurface, FaceCount> m_Faces;
+	};
+
+	//==========================Buffers==========================//
+	class SoftwareVertexBuffer : public RHIVertexBuffer
+	{
+	public:
+		SoftwareVertexBuffer(uint32_t size, uint32_t usage, const void* initialData)
+			: RHIVertexBuffer(size, usage)
+			, m_Data(size)
+		{
+			if (initialData)
+			{
+				std::memcpy(m_Data.data(), initialData, size);
+			}
+		}
+
+		virtual void* Lock() const override { return m_Data.data(); }
+		virtual bool UnLock() const override { return true; }
+
+		const uint8_t* GetData() const { return m_Data.data(); }
+
+	private:
+		mutable std::vector<uint8_t> m_Data;
+	};
+
+	class SoftwareIndexBuffer : public RHIIndexBuffer
+	{
+	public:
+		SoftwareIndexBuffer(uint32_t size, uint32_t usage, const void* initialData)
+			: RHIIndexBuffer(size, usage)
+			, m_Data(size)
+		{
+			if (initialData)
+			{
+				std::memcpy(m_Data.data(), initialData, size);
+			}
+		}
+
+		virtual void* Lock() const override { return m_Data.data(); }
+		virtual bool UnLock() const override { return true; }
+
+		const uint8_t* GetData() const { return m_Data.data(); }
+
+	private:
+		mutable std::vector<uint8_t> m_Data;
+	};
+
+	class SoftwareUniformBuffer : public RHIUniformBufferBase
+	{
+	public:
+		SoftwareUniformBuffer(uint32_t size)
+			: RHIUniformBufferBase(size)
+			, m_Data(size)
+		{}
+
+		virtual void* Lock() const override { return m_Data.data(); }
+		virtual bool UnLock() const override { return true; }
+
+		// False when the buffer is too small, value is left untouched then
+		template<typename T>
+		bool Read(size_t offset, T& value) const
+		{
+			if (offset + sizeof(T) > m_Data.size())
+			{
+				return false;
+			}
+			std::memcpy(&value, m_Data.data() + offset, sizeof(T));
+			return true;
+		}
+
+	private:
+		mutable std::vector<uint8_t> m_Data;
+	};
+
+	//==========================Shaders==========================//
+	// HLSL is never compiled here, each shader file is mapped to the closest fixed function behaviour instead
+	enum class ESoftwareShadingModel : uint8_t
+	{
+		// Albedo lit by the directional light, per vertex
+		Lit,
+		// Interpolated vertex color
+		VertexColor,
+		// Depth only, no color writes
+		DepthOnly,
+		// Ambient color pinned to the far plane
+		Sky,
+		// Needs texture sampling or compute, the draw is skipped
+		Unsupported
+	};
+
+	class SoftwareVertexShader : public RHIVertexShader
+	{
+	public:
+		SoftwareVertexShader(const std::string& filePath)
+			: m_FilePath(filePath)
+		{}
+
+		const std::string& GetFilePath() const { return m_FilePath; }
+
+	private:
+		std::string m_FilePath;
+	};
+
+	class SoftwarePixelShader : public RHIPixelShader
+	{
+	public:
+		SoftwarePixelShader(const std::string& filePath, ESoftwareShadingModel shadingModel)
+			: m_FilePath(filePath)
+			, m_ShadingModel(shadingModel)
+		{}
+
+		const std::string& GetFilePath() const { return m_FilePath; }
+		ESoftwareShadingModel GetShadingModel() const { return m_ShadingModel; }
+
+	private:
+		std::string m_FilePath;
+		ESoftwareShadingModel m_ShadingModel;
+	};
+
+	class SoftwareVertexDeclaration : public RHIVertexDeclaration
+	{
+	public:
+		SoftwareVertexDeclaration(const VertexDeclarationElementList& elements)
+			: m_Elements(elements)
+		{
+			for (uint16_t& stride : m_StreamStrides)
+			{
+				stride = 0;
+			}
+			for (const RHIVertexElement& element : m_Elements)
+			{
+				if (element.StreamIndex < MaxVertexElementCount)
+				{
+					m_StreamStrides[element.StreamIndex] = element.Stride;
+				}
+			}
+		}
+
+		virtual bool GetInitializer(VertexDeclarationElementList& Init) override { Init = m_Elements; return true; }
+
+		// Null if the declaration has no element for that shader attribute
+		const RHIVertexElement* FindElement(uint8_t attributeIndex) const
+		{
+			for (const RHIVertexElement& element : m_Elements)
+			{
+				if (element.AttributeIndex == attributeIndex)
+				{
+					return &element;
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		VertexDeclarationElementList m_Elements;
+	};
+
+	//==========================States==========================//
+	class SoftwareSamplerState : public RHISamplerState
+	{
+	public:
+		SoftwareSamplerState(const SamplerStateInitializer& Init) : RHISamplerState(Init) {}
+	};
+
+	class SoftwareRasterizerState : public RHIRasterizerState
+	{
+	public:
+		SoftwareRasterizerState(const RasterizerStateInitializer& Init) : RHIRasterizerState(Init) {}
+
+		const RasterizerStateInitializer& GetInitializer() const { return m_RasterizerInitializer; }
+	};
+
+	class SoftwareBlendState : public RHIBlendState
+	{
+	public:
+		SoftwareBlendState(const BlendStateInitializer& Init) : RHIBlendState(Init) {}
+
+		const BlendStateInitializer& GetInitializer() const { return m_BlendStateInitializer; }
+	};
+
+	class SoftwareDepthStencilState : public RHIDepthStencilState
+	{
+	public:
+		SoftwareDepthStencilState(const DepthStencilStateInitializer& Init) : RHIDepthStencilState(Init) {}
+
+		const DepthStencilStateInitializer& GetInitializer() const { return m_DepthStencilStateInitializer; }
+	};
+
+	//==========================SwapChain==========================//
+	class SoftwareSwapChain : public RHISwapChain
+	{
+	public:
+		SoftwareSwapChain(uint32_t width, uint32_t height, ERHIPixelFormat pixelFormat)
+			: RHISwapChain(width, height, pixelFormat)
+		{
+			m_BackBuffer.Allocate(width, height, true, true);
+		}
+
+		// Nothing to show the frame on, the back buffer stays readable instead
+		virtual bool Present() override { return true; }
+		virtual bool ReSize(uint32_t width, uint32_t height) override
+		{
+			m_Width = width;
+			m_Height = height;
+			m_BackBuffer.Allocate(width, height, true, true);
+			return true;
+		}
+
+		SoftwareSurface& GetBackBuffer() { return m_BackBuffer; }
+
+		//=========RHI Resource====================
+		virtual void* GetRHISwapChain() override { return this; }
+		virtual void* GetRHIRenderTargetView() override { return this; }
+		virtual void* GetRHIDepthStencilView() override { return this; }
+		//=========================================
+
+	private:
+		SoftwareSurface m_BackBuffer;
+	};
+}
@@ -32,9 +32,9 @@ namespace Lemon
 		const auto gridSpacing = 1.0f;
 		const auto translation = glm::vec3
 		(
-			static_cast<int>(camera.m_Entity.GetComponent<TransformComponent>().Position.x / gridSpacing) * gridSpacing,
+			static_cast<int>(camera.m_Entity.GetComponent<TransformComponent>().GetPosition().x / gridSpacing) * gridSpacing,
 			0.0f,
-			static_cast<int>(camera.m_Entity.GetComponent<TransformComponent>().Position.z / gridSpacing) * gridSpacing
+			static_cast<int>(camera.m_Entity.GetComponent<TransformComponent>().GetPosition().z / gridSpacing) * gridSpacing
 		);
 		outTranslation = translation;
 		outScale = glm::vec3(gridSpacing, gridSpacing, gridSpacing);
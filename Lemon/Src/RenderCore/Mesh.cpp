@@ -6,8 +6,14 @@ namespace Lemon
 {
 	void Mesh::BuileMesh(const std::vector<StandardMeshVertex>& vertices, const std::vector<uint32_t>& indices)
 	{
-		m_Vertices = vertices;
-		m_Indices = indices;
+		m_Vertices.assign(vertices.begin(), vertices.end());
+		m_Indices.assign(indices.begin(), indices.end());
+
+		m_LocalBounds = AABB();
+		for (const StandardMeshVertex& vertex : vertices)
+		{
+			m_LocalBounds.Merge(vertex.Position);
+		}
 	}
 
 	void Mesh::CreateRHIBuffers()
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include "Material.h"
+#include "Math/Bounds.h"
 #include "RHI/RHI.h"
 #include "RHI/DynamicRHI.h"
 #include "RHI/RHIResources.h"
@@ -43,6 +44,8 @@ namespace Lemon
 		const std::shared_ptr<RHIPixelShader>& GetPixelShader() const { return m_PixelShader; }
 		const std::shared_ptr<RHIVertexDeclaration>& GetVertexDeclaration() const { return  m_VertexDeclaration; }
 		uint32_t GetIndexCount() const {return (uint32_t)m_Indices.size(); }
+		// Box around the vertex positions in mesh space, set by BuileMesh
+		const AABB& GetLocalBounds() const { return m_LocalBounds; }
 
 		const std::shared_ptr<Material>& GetMaterial() const { return m_RenderMaterial; }
 		std::shared_ptr<Material>& GetMaterial() { return m_RenderMaterial; }
@@ -69,8 +72,9 @@ namespace Lemon
 		*/
 		
 	protected:
-		std::vector<StandardMeshVertex> m_Vertices;
-		std::vector<uint32_t> m_Indices;
+		TaggedVector<StandardMeshVertex, EMemoryTag::MeshData> m_Vertices;
+		TaggedVector<uint32_t, EMemoryTag::MeshData> m_Indices;
+		AABB m_LocalBounds;
 		/*
 		// Render State
 		Ref<RHIBlendState> m_BlendState = nullptr;
@@ -10,6 +10,7 @@
 #include "RenderCore/PixelShaderUtils.h"
 
 //------------------Components------------------//
+#include "World/Components/EnvironmentComponent.h"
 #include "World/Components/TransformComponent.h"
 #include "World/Components/StaticMeshComponent.h"
 
@@ -18,6 +19,8 @@ namespace Lemon
 
 	void DeferredShadingRenderer::Render(Ref<RHICommandList> RHICmdList)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		// Pre Depth Pass
 		PreDepthPass(RHICmdList);
 		// GBuffer Geometry Pass
@@ -28,6 +31,8 @@ namespace Lemon
 	}
 	void DeferredShadingRenderer::PreDepthPass(Ref<RHICommandList> RHICmdList)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		if (!SceneRenderStates::Get() || !SceneShaderMap::Get())
 			return;
 
@@ -56,13 +61,13 @@ namespace Lemon
 		/*
 			consider EnvironmentEntity to snap transform to camera transform
 		*/
-		for (int i = 0; i < Render->environmentEntitys.size(); i++)
+		const glm::vec3 cameraPosition = mainCameraEntity.GetComponent<TransformComponent>().GetPosition();
+		Render->GetEngine()->GetSystem<World>()->ParallelEach<EnvironmentComponent, TransformComponent>([&cameraPosition](EnvironmentComponent&, TransformComponent& envTransform)
 		{
-			Entity& envEntity = Render->environmentEntitys[i];
-			envEntity.GetComponent<TransformComponent>().Position = mainCameraEntity.GetComponent<TransformComponent>().Position;
-			envEntity.GetComponent<TransformComponent>().Rotation = glm::vec3(0, 0, 0);
-			envEntity.GetComponent<TransformComponent>().Scale = glm::vec3(1, 1, 1);
-		}
+			envTransform.SetPosition(cameraPosition);
+			envTransform.SetRotation(glm::vec3(0, 0, 0));
+			envTransform.SetScale(glm::vec3(1, 1, 1));
+		});
 
 		for (int i = 0; i < Render->normalEntitys.size(); i++)
 		{
@@ -82,13 +87,16 @@ namespace Lemon
 
 	void DeferredShadingRenderer::GBufferGeometryPass(Ref<RHICommandList> RHICmdList)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		if (!SceneRenderStates::Get() || !SceneShaderMap::Get())
 			return;
 
 		// Set Render Target
 		RHICmdList->SetViewport(m_ViewInfo.ViewSize);
 		Renderer* Render = Renderer::Get();
-		std::vector<Ref<RHITexture2D>> ColorRenderTargets;
+		FrameVector<Ref<RHITexture2D>> ColorRenderTargets;
+		ColorRenderTargets.reserve(4);
 
 		// reset
 		RHICmdList->SetTexture(0, nullptr);
@@ -138,6 +146,8 @@ namespace Lemon
 
 	void DeferredShadingRenderer::GBufferLightingPass(Ref<RHICommandList> RHICmdList)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		if (!SceneRenderStates::Get() || !SceneShaderMap::Get())
 			return;
 
@@ -3,6 +3,7 @@
 #include "Renderer.h"
 #include "Core/Engine.h"
 #include "World/World.h"
+#include "World/Components/EnvironmentComponent.h"
 
 #include "World/Components/TransformComponent.h"
 #include "World/Components/StaticMeshComponent.h"
@@ -12,10 +13,12 @@ namespace Lemon
 {
 	void ForwardShadingRenderer::Render(Ref<RHICommandList> RHICmdList)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		// Set Render Target
 		RHICmdList->SetViewport(m_ViewInfo.ViewSize);
 		Renderer* Render = Renderer::Get();
-		if (Render->GetEngine()->bShowImGuiEditor)
+		if (Render->GetEngine()->bShowImGuiEditor || !Render->GetSwapChain())
 		{
 			RHICmdList->SetRenderTarget(Render->GetSceneRenderTargets()->GetSceneColorTexture(), Render->GetSceneRenderTargets()->GetSceneDepthTexture());
 			RHICmdList->RHIClearRenderTarget(Render->GetSceneRenderTargets()->GetSceneColorTexture(), glm::vec4(0.1f, 0.4f, 0.7f, 1.0f),
@@ -36,13 +39,13 @@ namespace Lemon
 		/*
 			consider EnvironmentEntity to snap transform to camera transform
 		*/
-		for (int i = 0; i < Render->environmentEntitys.size(); i++)
+		const glm::vec3 cameraPosition = mainCameraEntity.GetComponent<TransformComponent>().GetPosition();
+		Render->m_World->ParallelEach<EnvironmentComponent, TransformComponent>([&cameraPosition](EnvironmentComponent&, TransformComponent& envTransform)
 		{
-			Entity& envEntity = Render->environmentEntitys[i];
-			envEntity.GetComponent<TransformComponent>().Position = mainCameraEntity.GetComponent<TransformComponent>().Position;
-			envEntity.GetComponent<TransformComponent>().Rotation = glm::vec3(0, 0, 0);
-			envEntity.GetComponent<TransformComponent>().Scale = glm::vec3(1, 1, 1);
-		}
+			envTransform.SetPosition(cameraPosition);
+			envTransform.SetRotation(glm::vec3(0, 0, 0));
+			envTransform.SetScale(glm::vec3(1, 1, 1));
+		});
 
 		for (int i = 0; i < Render->normalEntitys.size(); i++)
 		{
@@ -53,15 +53,30 @@ namespace Lemon
 		// Init RHI
 		RHIInit();
 
-		m_RHISwapChain = RHICreateSwapChain(windowData.Handle,
-			static_cast<uint32_t>(m_Viewport.Width),
-			static_cast<uint32_t>(m_Viewport.Height),
-			RHI_PF_R8G8B8A8_Unorm);
+		if (!IsRHIAvailable())
+		{
+			// Simulation keeps running, the renderer just never ticks
+			LEMON_CORE_WARN("No RHI available on this platform, rendering is disabled");
+			return true;
+		}
 
-		if (!m_RHISwapChain)
+		if (m_Engine->IsHeadless())
 		{
-			LEMON_CORE_ERROR("Failed to create swap chain");
-			return false;
+			// Nothing to present to, frames only end up in the SceneRenderTargets
+			LEMON_CORE_INFO("Headless mode, rendering offscreen only");
+		}
+		else
+		{
+			m_RHISwapChain = RHICreateSwapChain(windowData.Handle,
+				static_cast<uint32_t>(m_Viewport.Width),
+				static_cast<uint32_t>(m_Viewport.Height),
+				RHI_PF_R8G8B8A8_Unorm);
+
+			if (!m_RHISwapChain)
+			{
+				LEMON_CORE_ERROR("Failed to create swap chain");
+				return false;
+			}
 		}
 
 		// Create RHICommandList
@@ -166,9 +181,21 @@ namespace Lemon
 			UniformBuffer->ObjectUniformBuffer->UniformBuffer());
 
 		ObjectUniformParameters parameters;
-		parameters.LocalToWorldMatrix = transformComp.GetTransform();
-		parameters.WorldToWorldMatrix = glm::inverse(transformComp.GetTransform());
-		parameters.WorldToWorldTransposeMatrix = glm::transpose(parameters.WorldToWorldMatrix);
+		// in fixed timestep mode draw in between the last two simulated steps
+		const float interpolationAlpha = Renderer::Get()->GetEngine()->GetTimer()->GetInterpolationAlpha();
+		if (transformComp.IsInterpolated(interpolationAlpha))
+		{
+			parameters.LocalToWorldMatrix = transformComp.GetInterpolatedTransform(interpolationAlpha);
+			parameters.WorldToWorldMatrix = glm::inverse(parameters.LocalToWorldMatrix);
+			parameters.WorldToWorldTransposeMatrix = glm::transpose(parameters.WorldToWorldMatrix);
+		}
+		else
+		{
+			// Still, World::UpdateTransforms already built the matrices
+			parameters.LocalToWorldMatrix = transformComp.GetLocalToWorldMatrix();
+			parameters.WorldToWorldMatrix = transformComp.GetWorldToLocalMatrix();
+			parameters.WorldToWorldTransposeMatrix = transformComp.GetWorldToLocalTransposeMatrix();
+		}
 
 		parameters.Color = glm::vec4(1.0f, 1.0f, 0.0f, 1.0f);
 
@@ -256,9 +283,9 @@ namespace Lemon
 			UniformBuffer->ObjectUniformBuffer->UniformBuffer());
 
 		ObjectUniformParameters parameters;
-		parameters.LocalToWorldMatrix = transformComp.GetTransform();
-		parameters.WorldToWorldMatrix = glm::inverse(transformComp.GetTransform());
-		parameters.WorldToWorldTransposeMatrix = glm::transpose(parameters.WorldToWorldMatrix);
+		parameters.LocalToWorldMatrix = transformComp.GetLocalToWorldMatrix();
+		parameters.WorldToWorldMatrix = transformComp.GetWorldToLocalMatrix();
+		parameters.WorldToWorldTransposeMatrix = transformComp.GetWorldToLocalTransposeMatrix();
 
 		parameters.Color = glm::vec4(1.0f, 1.0f, 0.0f, 1.0f);
 
@@ -345,8 +372,11 @@ namespace Lemon
 	{
 		m_Viewport.Width = (float)newWidth;
 		m_Viewport.Height = (float)newHeight;
-		
-		m_SceneRenderTargets->OnResize(newWidth, newHeight, this);
+
+		if (m_SceneRenderTargets)
+		{
+			m_SceneRenderTargets->OnResize(newWidth, newHeight, this);
+		}
 
 		if(m_World->GetMainCamera())
 		{
@@ -355,34 +385,17 @@ namespace Lemon
 	}
 	void Renderer::Tick(float deltaTime)
 	{
-		std::vector<Entity> entitys = m_World->GetAllEntities();
-		
-		// classify the entity types
-		gizmoDebugEntitys.clear();
-		environmentEntitys.clear();
-		normalEntitys.clear();
-		lightEntitys.clear();
+		LEMON_PROFILE_FUNCTION();
 
-		for(int i = 0;i < entitys.size(); i++)
+		if (!IsRenderingEnabled())
 		{
-			if(entitys[i].IsGizmo())
-			{
-				gizmoDebugEntitys.emplace_back(entitys[i]);
-			}
-			else if(entitys[i].HasComponent<EnvironmentComponent>())
-			{
-				environmentEntitys.emplace_back(entitys[i]);
-			}
-			else if(entitys[i].HasComponent<DirectionalLightComponent>())
-			{
-				lightEntitys.emplace_back(entitys[i]);
-			}
-			else
-			{
-				normalEntitys.emplace_back(entitys[i]);
-			}
+			return;
 		}
 
+		m_RHICommandList->BeginFrame();
+
+		ClassifyEntitys();
+
 		PreRender(deltaTime);
 
 		ViewInfo viewinfo;
@@ -400,6 +413,54 @@ namespace Lemon
 		m_ShadingRenderer->Render(m_RHICommandList);
 	}
 
+	void Renderer::ClassifyEntitys()
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		// last frame's vectors point into the previous frame arena, start over instead of clearing them
+		gizmoDebugEntitys = FrameVector<Entity>();
+		environmentEntitys = FrameVector<Entity>();
+		normalEntitys = FrameVector<Entity>();
+		lightEntitys = FrameVector<Entity>();
+
+		// Only entities with a mesh are drawn, walk the packed renderable group instead of every entity.
+		// Chunks classify in parallel, merged in chunk order the lists come out the same on any thread count
+		struct ClassifiedEntitys
+		{
+			FrameVector<Entity> Gizmos;
+			FrameVector<Entity> Normals;
+		};
+		ClassifiedEntitys classified = m_World->ParallelReduce<TransformComponent, StaticMeshComponent>(ClassifiedEntitys(),
+			[this](ClassifiedEntitys& partial, entt::entity handle, TransformComponent&, StaticMeshComponent&)
+			{
+				Entity entity(handle, m_World);
+				if (entity.IsGizmo())
+				{
+					partial.Gizmos.emplace_back(entity);
+				}
+				else if (!entity.HasComponent<EnvironmentComponent>())
+				{
+					partial.Normals.emplace_back(entity);
+				}
+			},
+			[](ClassifiedEntitys& result, ClassifiedEntitys& partial)
+			{
+				result.Gizmos.insert(result.Gizmos.end(), partial.Gizmos.begin(), partial.Gizmos.end());
+				result.Normals.insert(result.Normals.end(), partial.Normals.begin(), partial.Normals.end());
+			});
+		gizmoDebugEntitys = std::move(classified.Gizmos);
+		normalEntitys = std::move(classified.Normals);
+
+		m_World->Each<EnvironmentComponent>([this](entt::entity handle, EnvironmentComponent&)
+		{
+			environmentEntitys.emplace_back(handle, m_World);
+		});
+		m_World->Each<DirectionalLightComponent>([this](entt::entity handle, DirectionalLightComponent&)
+		{
+			lightEntitys.emplace_back(handle, m_World);
+		});
+	}
+
 	void Renderer::PreRender(float deltaTime)
 	{
 		// EquirectangularToCubeMap if exist
@@ -448,13 +509,12 @@ namespace Lemon
 
 		TransformComponent& transformComp = mainCameraEntity.GetComponent<TransformComponent>();
 		CameraComponent& mainCameraComp = mainCameraEntity.GetComponent<CameraComponent>();
-		glm::mat4 cameraTransform = transformComp.GetTransform();
 		parameters.ViewMatrix = mainCameraComp.GetViewMatrix(); //glm::inverse(transformComp.GetTransform());
-		parameters.InverseViewMatrix = glm::inverse(parameters.ViewMatrix);
+		parameters.InverseViewMatrix = transformComp.GetLocalToWorldMatrix();
 		parameters.ProjectionMatrix = mainCameraComp.GetProjectionMatrix();
 		parameters.InverseProjectionMatrix = glm::inverse(parameters.ProjectionMatrix);
 		parameters.ViewProjectionMatrix = parameters.ProjectionMatrix * parameters.ViewMatrix;
-		parameters.CameraWorldPosition = glm::vec4(transformComp.Position, 1.0f);
+		parameters.CameraWorldPosition = glm::vec4(transformComp.GetWorldPosition(), 1.0f);
 		//glm::vec4 debugPoint1 = parameters.ViewMatrix * glm::vec4(-0.5f, 0.5f, 1.0f, 1.0f);
 		//glm::vec4 debugPoint = parameters.ProjectionMatrix * debugPoint1;
 		
@@ -462,7 +522,7 @@ namespace Lemon
 		UniformBuffer->ViewUniformBuffer->UpdateUniformBufferImmediate(parameters);
 	}
 
-	void Renderer::UpdateLightUniformBuffer(Ref<RHICommandList> RHICmdList, const std::vector<Entity>& lightEntitys)
+	void Renderer::UpdateLightUniformBuffer(Ref<RHICommandList> RHICmdList, const FrameVector<Entity>& lightEntitys)
 	{
 		SceneUniformBuffers* UniformBuffer = SceneUniformBuffers::Get();
 		if (!UniformBuffer || !Renderer::Get())
@@ -575,8 +635,10 @@ namespace Lemon
 		m_RHICommandList->SetTexture(0, EnvEquirectangularTex);
 	}
 
-	void Renderer::PreComputeIBL(std::vector<Entity>& environmentEntitys)
+	void Renderer::PreComputeIBL(FrameVector<Entity>& environmentEntitys)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		/*
 		// Set Render Target
 		m_RHICommandList->SetViewport(m_Viewport);
@@ -649,7 +711,8 @@ namespace Lemon
 			{
 				unsigned int mipWidth = PreFilterSizeX * std::pow(0.5, mip);
 				unsigned int mipHeight = PreFilterSizeY * std::pow(0.5, mip);
-				std::vector<Ref<RHITexture2D>> tempPrefilterTexures;
+				FrameVector<Ref<RHITexture2D>> tempPrefilterTexures;
+				tempPrefilterTexures.reserve(6);
 				RHIResourceCreateInfo createInfo;
 				tempPrefilterTexures.emplace_back(RHICreateTexture2D(mipWidth, mipHeight, tempPrefilterFormat, 1,
 					RHI_TexCreate_ShaderResource | RHI_TexCreate_RenderTargetable, createInfo));
@@ -1,6 +1,7 @@
 #pragma once
 #include "Core/Core.h"
 #include "Core/ISystem.h"
+#include "Core/FrameAllocator.h"
 
 #include <glm/glm.hpp>
 
@@ -47,14 +48,21 @@ namespace Lemon
 
 		bool Initialize() override;
 		void Tick(float deltaTime) override;
+		EMemoryTag GetMemoryTag() const override { return EMemoryTag::Renderer; }
 
 		void PreRender(float deltaTime);
 
+		// Sorts the entities into the gizmo/environment/light/normal lists the passes draw from, frame memory
+		void ClassifyEntitys();
+		const FrameVector<Entity>& GetNormalEntitys() const { return normalEntitys; }
+
 		void OnResize(uint32_t newWidth, uint32_t newHeight);
 		
 		Engine* GetEngine() { return m_Engine; }
 		//====SwapChain=============================//
 		const auto& GetSwapChain() const { return m_RHISwapChain; }
+		// False when there is no RHI, the swap chain is optional (headless renders offscreen)
+		bool IsRenderingEnabled() const { return m_RHICommandList != nullptr; }
 
 		Ref<SceneRenderTargets> GetSceneRenderTargets() const { return m_SceneRenderTargets; }
 		Ref<SceneRenderStates> GetSceneRenderStates() const {return m_SceneRenderStates;}
@@ -71,7 +79,7 @@ namespace Lemon
 		static void DrawSky(Ref<RHICommandList> RHICmdList, Entity entity, GraphicsPipelineStateInitializer PSOInitializer = {});
 		//ConstantBuffer Update
 		static void UpdateViewUniformBuffer(Ref<RHICommandList> RHICmdList, Entity mainCameraEntity);
-		static void UpdateLightUniformBuffer(Ref<RHICommandList> RHICmdList, const std::vector<Entity>& lightEntitys);
+		static void UpdateLightUniformBuffer(Ref<RHICommandList> RHICmdList, const FrameVector<Entity>& lightEntitys);
 		static void DrawFullScreenQuad(Ref<RHICommandList> RHICmdList, FullScreenUniformParameters fullScreenParameter,
 			std::vector<std::shared_ptr<RHITexture>> Textures = std::vector<std::shared_ptr<RHITexture>>());
 
@@ -82,7 +90,7 @@ namespace Lemon
 
 
 		
-		void PreComputeIBL(std::vector<Entity>& environment);
+		void PreComputeIBL(FrameVector<Entity>& environment);
 
 		void EnvEquirectangularToCubeMap(EnvironmentComponent& envComp);
 		// ====IBL=======
@@ -114,11 +122,11 @@ namespace Lemon
 		Ref<RHIIndexBuffer> simpleIndexBuffer;
 		Ref<RHIVertexDeclaration> vertexDeclaration;
 
-		// ---------classfiy entitys
-		std::vector<Entity> gizmoDebugEntitys;
-		std::vector<Entity> environmentEntitys;
-		std::vector<Entity> normalEntitys;
-		std::vector<Entity> lightEntitys;
+		// ---------classfiy entitys, rebuilt in frame memory every Tick
+		FrameVector<Entity> gizmoDebugEntitys;
+		FrameVector<Entity> environmentEntitys;
+		FrameVector<Entity> normalEntitys;
+		FrameVector<Entity> lightEntitys;
 
 		// Render Shading Path
 		Ref<SceneRenderer> m_ShadingRenderer = nullptr;
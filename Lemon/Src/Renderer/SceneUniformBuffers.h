@@ -1,4 +1,5 @@
-﻿#include "Core/Core.h"
+﻿#pragma once
+#include "Core/Core.h"
 #include "RHI/RHI.h"
 #include <glm/glm.hpp>
 #include "RHI/RHIResources.h"
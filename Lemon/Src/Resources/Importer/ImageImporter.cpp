@@ -47,6 +47,8 @@ namespace Lemon
 	}
 	bool ImageImporter::LoadImage(const std::string& filePath, TextureInfoData& OutTextureRawData, bool bGenerateMipmaps /* = false */)
 	{
+		LEMON_PROFILE_FUNCTION();
+
 		if (!FileUtils::PathExists(filePath))
 		{
 			LEMON_CORE_ERROR("Path \"{0}\" is invalid.", filePath.c_str());
@@ -117,7 +119,7 @@ namespace Lemon
 		return true;
 	}
 
-	bool ImageImporter::FillImageData(std::vector<std::byte>* data, void* ImageData, uint32_t width, uint32_t height, uint32_t channels, uint32_t perChannelBytes) const
+	bool ImageImporter::FillImageData(TaggedVector<std::byte, EMemoryTag::TextureData>* data, void* ImageData, uint32_t width, uint32_t height, uint32_t channels, uint32_t perChannelBytes) const
 	{
 		if (!data || width == 0 || height == 0 || channels == 0)
 		{
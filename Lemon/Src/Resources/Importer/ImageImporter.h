@@ -14,7 +14,7 @@ namespace Lemon
 
 		bool LoadImage(const std::string& filePath, TextureInfoData& OutTextureRawData, bool bGenerateMipmaps = false);
 	private:
-		bool FillImageData(std::vector<std::byte>* data, void* ImageData, uint32_t width, uint32_t height, uint32_t channels, uint32_t perChannelBytes) const;
+		bool FillImageData(TaggedVector<std::byte, EMemoryTag::TextureData>* data, void* ImageData, uint32_t width, uint32_t height, uint32_t channels, uint32_t perChannelBytes) const;
 
 	private:
 		Engine* m_Engine = nullptr;
@@ -38,6 +38,7 @@ namespace Lemon
 		~ResourceSystem() = default;
 
 		virtual bool Initialize() override;
+		EMemoryTag GetMemoryTag() const override { return EMemoryTag::Resources; }
 
 		void AddDataDirectory(AssetType type, const std::string& directory);
 		std::string GetAssetDataDirectory(AssetType type);
@@ -2,6 +2,8 @@
 #include <fstream>
 #include "FileUtils.h"
 #include <filesystem>
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
@@ -10,7 +12,7 @@ namespace Lemon
 	std::string FileUtils::ReadFile(const std::string& filepath)
 	{
 		std::string result;
-		std::ifstream in(filepath, std::ios::in, std::ios::binary);
+		std::ifstream in(filepath, std::ios::in | std::ios::binary);
 		if (in)
 		{
 			in.seekg(0, std::ios::end);
@@ -50,24 +52,43 @@ namespace Lemon
 	std::wstring FileUtils::StringToWstring(const std::string& str /*= CP_ACP*/)
 	{
 		std::wstring wstr;
+#ifdef LEMON_PLATFORM_WINDOW
 		int len = MultiByteToWideChar(0, 0, str.c_str(), (int)strlen(str.c_str()), NULL, 0);
 		wchar_t* m_wchar = new wchar_t[len + 1];
 		MultiByteToWideChar(0, 0, str.c_str(), (int)strlen(str.c_str()), m_wchar, len);
 		m_wchar[len] = '\0';
 		wstr = m_wchar;
-		delete m_wchar;
+		delete[] m_wchar;
+#else
+		// Current C locale, same as CP_ACP on windows
+		const size_t len = std::mbstowcs(nullptr, str.c_str(), 0);
+		if (len != static_cast<size_t>(-1))
+		{
+			wstr.resize(len);
+			std::mbstowcs(&wstr[0], str.c_str(), len);
+		}
+#endif
 		return wstr;
 	}
 
 	std::string FileUtils::WstringToString(const std::wstring& wstr /*= CP_ACP*/)
 	{
 		std::string str;
+#ifdef LEMON_PLATFORM_WINDOW
 		int len = WideCharToMultiByte(0, 0, wstr.c_str(), (int)wcslen(wstr.c_str()), NULL, 0, NULL, NULL);
 		char* m_char = new char[len + 1];
 		WideCharToMultiByte(0, 0, wstr.c_str(), (int)wcslen(wstr.c_str()), m_char, len, NULL, NULL);
 		m_char[len] = '\0';
 		str = m_char;
-		delete m_char;
+		delete[] m_char;
+#else
+		const size_t len = std::wcstombs(nullptr, wstr.c_str(), 0);
+		if (len != static_cast<size_t>(-1))
+		{
+			str.resize(len);
+			std::wcstombs(&str[0], wstr.c_str(), len);
+		}
+#endif
 		return str;
 	}
 }
\ No newline at end of file
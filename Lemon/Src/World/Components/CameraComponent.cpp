@@ -72,7 +72,7 @@ namespace Lemon
 		return FovScale * atan(tan(m_PerspectiveFOVHorizontalRadian / 2.0f) * (m_ViewportSizeY / m_ViewportSizeX));
 	}
 
-	const glm::mat4& CameraComponent::GetViewMatrix() const
+	glm::mat4 CameraComponent::GetViewMatrix() const
 	{
 		if (m_Entity)
 		{
@@ -80,7 +80,7 @@ namespace Lemon
 
 			//return glm::lookAtLH(transform.Position, transform.Position + transform.GetForwardVector(), transform.GetUpVector());
 
-			return glm::inverse(m_Entity.GetComponent<TransformComponent>().GetTransform());
+			return transform.GetWorldToLocalMatrix();
 		}
 
 		return glm::mat4(1.0f);
@@ -89,7 +89,7 @@ namespace Lemon
 	glm::vec3 CameraComponent::GetPosition() const
 	{
 		const TransformComponent& camera = m_Entity.GetComponent<TransformComponent>();
-		return camera.Position;
+		return camera.GetWorldPosition();
 	}
 
 	glm::vec3 CameraComponent::GetForwardVector() const
@@ -129,9 +129,10 @@ namespace Lemon
 			glm::vec2 mouseDelta = inputSystem->GetMouseDelta() * mouseSensitivity;
 			// Compute rotation
 			TransformComponent& transformComp = m_Entity.GetComponent<TransformComponent>();
-			transformComp.Rotation += glm::vec3(mouseDelta.y, mouseDelta.x, 0);
+			glm::vec3 rotation = transformComp.GetRotation() + glm::vec3(mouseDelta.y, mouseDelta.x, 0);
 			// Clamp rotation along the x-axis
-			transformComp.Rotation.x = glm::clamp(transformComp.Rotation.x, -90.0f, 90.0f);
+			rotation.x = glm::clamp(rotation.x, -90.0f, 90.0f);
+			transformComp.SetRotation(rotation);
 			
 			// Keyboard movement
 			glm::vec3 direction = { 0,0,0 };
@@ -155,7 +156,7 @@ namespace Lemon
 			// Translate for as long as there is speed
 			if (m_MovementSpeed != glm::vec3(0, 0, 0));
 			{
-				transformComp.Position += m_MovementSpeed * deltaTime;
+				transformComp.SetPosition(transformComp.GetPosition() + m_MovementSpeed * deltaTime);
 			}
 		}
 
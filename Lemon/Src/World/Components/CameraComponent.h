@@ -37,7 +37,7 @@ namespace Lemon
 
 		//=Getter
         const glm::mat4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
-		const glm::mat4& GetViewMatrix() const;
+		glm::mat4 GetViewMatrix() const;
 
 		glm::vec3 GetForwardVector() const;
 		glm::vec3 GetRightVector() const;
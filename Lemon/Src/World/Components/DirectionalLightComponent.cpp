@@ -10,7 +10,7 @@ namespace Lemon
     {
         if(m_Entity && m_Entity.HasComponent<TransformComponent>())
         {
-            glm::quat rotation = glm::quat(glm::radians(m_Entity.GetComponent<TransformComponent>().Rotation));
+            glm::quat rotation = glm::quat(glm::radians(m_Entity.GetComponent<TransformComponent>().GetRotation()));
             glm::vec3 dir = glm::rotate(rotation, glm::vec3(1.0f, 0.0f, 0.0f));
             return glm::normalize(dir);
         }
@@ -0,0 +1,49 @@
+#pragma once
+#include "Core/Core.h"
+#include "IComponent.h"
+
+namespace Lemon
+{
+	// Parent and children of an entity, the children form a linked list through their own HierarchyComponent
+	// so attaching never allocates. Only World::SetParent and World::DestroyEntity change the links
+	class LEMON_API HierarchyComponent : public IComponent
+	{
+		friend class World;
+		friend class TransformHierarchy;
+	public:
+		// A null Entity for roots
+		Entity GetParent() const { return MakeEntity(m_Parent); }
+		Entity GetFirstChild() const { return MakeEntity(m_FirstChild); }
+		Entity GetNextSibling() const { return MakeEntity(m_NextSibling); }
+		uint32_t GetChildCount() const { return m_ChildCount; }
+
+		// fn(Entity child) for the direct children in attach order, fn may detach or destroy the child it is given
+		template<typename Fn>
+		void ForEachChild(Fn&& fn) const
+		{
+			for (entt::entity child = m_FirstChild; child != entt::null;)
+			{
+				Entity childEntity = MakeEntity(child);
+				child = childEntity.GetComponent<HierarchyComponent>().m_NextSibling;
+				fn(childEntity);
+			}
+		}
+
+	private:
+		Entity MakeEntity(entt::entity handle) const
+		{
+			return handle != entt::null ? Entity(handle, m_Entity.GetWorld()) : Entity(entt::null, nullptr);
+		}
+
+	private:
+		entt::entity m_Parent = entt::null;
+		entt::entity m_FirstChild = entt::null;
+		entt::entity m_LastChild = entt::null;
+		entt::entity m_PrevSibling = entt::null;
+		entt::entity m_NextSibling = entt::null;
+		uint32_t m_ChildCount = 0;
+
+		// Slot in the breadth first arrays of TransformHierarchy, valid after its last rebuild
+		uint32_t m_HierarchyIndex = 0;
+	};
+}
@@ -0,0 +1,134 @@
+#include "LemonPCH.h"
+#include "NameComponent.h"
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace Lemon
+{
+	struct NameComponent::NameTable
+	{
+		std::mutex Mutex;
+		// Keyed by a view of the entry's own string, looking a name up never allocates
+		std::unordered_map<std::string_view, Scope<InternedName>> Names;
+	};
+
+	NameComponent::NameComponent(const NameComponent& other)
+		: IComponent(other), m_Name(other.m_Name)
+	{
+		if (m_Name)
+		{
+			// other holds a reference, the entry can not be released meanwhile
+			m_Name->RefCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	NameComponent::NameComponent(NameComponent&& other) noexcept
+		: IComponent(other), m_Name(other.m_Name)
+	{
+		other.m_Name = nullptr;
+	}
+
+	NameComponent::~NameComponent()
+	{
+		Release(m_Name);
+	}
+
+	NameComponent& NameComponent::operator=(const NameComponent& other)
+	{
+		if (this != &other)
+		{
+			IComponent::operator=(other);
+			if (other.m_Name)
+			{
+				other.m_Name->RefCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			Release(m_Name);
+			m_Name = other.m_Name;
+		}
+		return *this;
+	}
+
+	NameComponent& NameComponent::operator=(NameComponent&& other) noexcept
+	{
+		if (this != &other)
+		{
+			IComponent::operator=(other);
+			Release(m_Name);
+			m_Name = other.m_Name;
+			other.m_Name = nullptr;
+		}
+		return *this;
+	}
+
+	void NameComponent::SetName(const std::string& name)
+	{
+		if (m_Name && m_Name->Name == name)
+		{
+			return;
+		}
+		InternedName* newName = Intern(name);
+		Release(m_Name);
+		m_Name = newName;
+	}
+
+	NameComponent::NameTable& NameComponent::GetNameTable()
+	{
+		static NameTable nameTable;
+		return nameTable;
+	}
+
+	NameComponent::InternedName* NameComponent::Intern(const std::string& name)
+	{
+		if (name.empty())
+		{
+			return nullptr;
+		}
+
+		LEMON_MEMORY_SCOPE(EntityStorage);
+		NameTable& nameTable = GetNameTable();
+		std::lock_guard<std::mutex> lock(nameTable.Mutex);
+		auto iter = nameTable.Names.find(name);
+		if (iter == nameTable.Names.end())
+		{
+			Scope<InternedName> entry = CreateScope<InternedName>();
+			entry->Name = name;
+			const std::string_view key = entry->Name;
+			iter = nameTable.Names.emplace(key, std::move(entry)).first;
+		}
+		InternedName* entry = iter->second.get();
+		entry->RefCount.fetch_add(1, std::memory_order_relaxed);
+		return entry;
+	}
+
+	void NameComponent::Release(InternedName* name)
+	{
+		if (!name)
+		{
+			return;
+		}
+
+		// Only the last reference takes the lock, Intern can not revive an entry while we hold it
+		uint32_t refCount = name->RefCount.load(std::memory_order_relaxed);
+		while (refCount > 1)
+		{
+			if (name->RefCount.compare_exchange_weak(refCount, refCount - 1, std::memory_order_acq_rel))
+			{
+				return;
+			}
+		}
+
+		NameTable& nameTable = GetNameTable();
+		std::lock_guard<std::mutex> lock(nameTable.Mutex);
+		if (name->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			nameTable.Names.erase(nameTable.Names.find(name->Name));
+		}
+	}
+
+	const std::string& NameComponent::EmptyName()
+	{
+		static const std::string emptyName;
+		return emptyName;
+	}
+}
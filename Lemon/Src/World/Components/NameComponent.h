@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/Core.h"
+#include "IComponent.h"
+#include <atomic>
+#include <string>
+
+namespace Lemon
+{
+	// The entity's display name. Names are interned and reference counted, equal names share one string
+	// which is freed when the last NameComponent holding it goes away
+	class LEMON_API NameComponent : public IComponent
+	{
+	public:
+		NameComponent() = default;
+		NameComponent(const std::string& name) : m_Name(Intern(name)) {}
+		NameComponent(const NameComponent& other);
+		NameComponent(NameComponent&& other) noexcept;
+		~NameComponent();
+
+		NameComponent& operator=(const NameComponent& other);
+		NameComponent& operator=(NameComponent&& other) noexcept;
+
+		const std::string& GetName() const { return m_Name ? m_Name->Name : EmptyName(); }
+		void SetName(const std::string& name);
+
+	private:
+		struct InternedName
+		{
+			std::string Name;
+			std::atomic<uint32_t> RefCount = 0;
+		};
+
+		struct NameTable;
+
+		static NameTable& GetNameTable();
+		// Returns the shared entry with one more reference, thread safe
+		static InternedName* Intern(const std::string& name);
+		static void Release(InternedName* name);
+		static const std::string& EmptyName();
+
+	private:
+		InternedName* m_Name = nullptr;
+	};
+}
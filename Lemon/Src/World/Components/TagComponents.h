@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Lemon
+{
+	// Empty components, entt keeps only the entity list for them.
+	// Set through Entity (e.g. Entity::SetGizmo), they do not derive IComponent
+
+	// Editor helpers like the grid, drawn in the gizmo pass and hidden from the hierarchy
+	struct GizmoTag {};
+}
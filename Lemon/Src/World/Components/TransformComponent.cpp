@@ -1 +1,99 @@
-﻿#include "LemonPCH.h"
\ No newline at end of file
+﻿#include "LemonPCH.h"
+#include "TransformComponent.h"
+#include "HierarchyComponent.h"
+#include "World/World.h"
+
+namespace Lemon
+{
+	void TransformComponent::UpdateMatrices() const
+	{
+		if (!m_bDirty)
+		{
+			return;
+		}
+
+		SetLocalToWorldMatrix(m_bHasParent ? GetParentMatrix() * GetLocalMatrix() : GetLocalMatrix());
+	}
+
+	glm::mat4 TransformComponent::GetParentMatrix() const
+	{
+		return GetParentTransform().GetLocalToWorldMatrix();
+	}
+
+	const TransformComponent& TransformComponent::GetParentTransform() const
+	{
+		Entity parent = m_Entity.GetComponent<HierarchyComponent>().GetParent();
+		return parent.GetComponent<TransformComponent>();
+	}
+
+	bool TransformComponent::IsInterpolated(float alpha) const
+	{
+		if (alpha >= 1.0f)
+		{
+			return false;
+		}
+
+		const TransformComponent* transform = this;
+		while (!transform->HasMovedInLastStep())
+		{
+			if (!transform->m_bHasParent)
+			{
+				return false;
+			}
+			transform = &transform->GetParentTransform();
+		}
+		return true;
+	}
+
+	glm::mat4 TransformComponent::GetInterpolatedTransform(float alpha) const
+	{
+		glm::mat4 transform;
+		if (alpha >= 1.0f || !ComputeInterpolatedTransform(alpha, transform))
+		{
+			return GetTransform();
+		}
+		return transform;
+	}
+
+	bool TransformComponent::ComputeInterpolatedTransform(float alpha, glm::mat4& outTransform) const
+	{
+		glm::mat4 parentMatrix;
+		const bool bParentInterpolated = m_bHasParent && GetParentTransform().ComputeInterpolatedTransform(alpha, parentMatrix);
+		const bool bMoved = HasMovedInLastStep();
+		if (!bMoved && !bParentInterpolated)
+		{
+			return false;
+		}
+
+		glm::mat4 localMatrix = GetLocalMatrix();
+		if (bMoved)
+		{
+			glm::vec3 position = glm::mix(m_PreviousPosition, m_Position, alpha);
+			glm::quat rotation = glm::slerp(glm::quat(glm::radians(m_PreviousRotation)), glm::quat(glm::radians(m_Rotation)), alpha);
+			glm::vec3 scale = glm::mix(m_PreviousScale, m_Scale, alpha);
+
+			localMatrix = glm::translate(glm::mat4(1.0f), position)
+				* glm::toMat4(rotation)
+				* glm::scale(glm::mat4(1.0f), scale);
+		}
+
+		if (m_bHasParent)
+		{
+			outTransform = (bParentInterpolated ? parentMatrix : GetParentMatrix()) * localMatrix;
+		}
+		else
+		{
+			outTransform = localMatrix;
+		}
+		return true;
+	}
+
+	void TransformComponent::SetLocalToWorldMatrix(const glm::mat4& localToWorld) const
+	{
+		m_LocalToWorld = localToWorld;
+		m_WorldToLocal = glm::inverse(m_LocalToWorld);
+		m_WorldToLocalTranspose = glm::transpose(m_WorldToLocal);
+		m_bDirty = false;
+		m_MatrixVersion++;
+	}
+}
@@ -6,70 +6,134 @@
 #include <glm/gtx/quaternion.hpp>
 namespace Lemon
 {
+    // Position/rotation/scale are only written through the setters, which mark the cached matrices dirty.
+    // The matrices are rebuilt on first use after a change, World::UpdateTransforms does it for every transform once per frame
+    // (in SIMD groups through TransformBatch).
+    // Below a parent (World::SetParent) position/rotation/scale are relative to it. Moving a parent only reaches
+    // the cached matrices of its descendants with the next World::UpdateTransforms
     class LEMON_API TransformComponent : public IComponent
     {
+		friend class World;
+		friend class TransformHierarchy;
+		friend class TransformBatch;
 	public:
-        glm::vec3 Position = { 0.0f, 0.0f, 0.0f };
-        // uint : degree
-        glm::vec3 Rotation = { 0.0f, 0.0f, 0.0f };
-        glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
-
         TransformComponent() = default;
         TransformComponent(const TransformComponent&) = default;
         TransformComponent(const glm::vec3& position)
-            : Position(position) {}
-        glm::mat4 GetTransform() const
-        {
-			/*
-            glm::mat4 rotation1 = glm::rotate(glm::mat4(1.0f), Rotation.x, { 1, 0, 0 })
-            * glm::rotate(glm::mat4(1.0f), Rotation.y, { 0, 1, 0 })
-            * glm::rotate(glm::mat4(1.0f), Rotation.z, { 0, 0, 1 });
-			glm::mat4 test10 = glm::rotate(glm::mat4(1.0f), 0.0f, { 0, 1, 0 });
-			glm::mat4 test11 = glm::rotate(glm::mat4(1.0f), glm::radians(180.0f), { 0, 1, 0 });
-			glm::mat4 test12 = glm::rotate(glm::mat4(1.0f), 360.0f, { 0, 1, 0 });
+            : m_Position(position) {}
+
+		const glm::vec3& GetPosition() const { return m_Position; }
+		// uint : degree
+		const glm::vec3& GetRotation() const { return m_Rotation; }
+		const glm::vec3& GetScale() const { return m_Scale; }
+		void SetPosition(const glm::vec3& position) { m_Position = position; MarkDirty(); }
+		void SetRotation(const glm::vec3& rotation) { m_Rotation = rotation; MarkDirty(); }
+		void SetScale(const glm::vec3& scale) { m_Scale = scale; MarkDirty(); }
+
+		// Position/rotation/scale as a matrix, relative to the parent
+		glm::mat4 GetLocalMatrix() const
+		{
+			return glm::translate(glm::mat4(1.0f), m_Position)
+				* glm::toMat4(glm::quat(glm::radians(m_Rotation)))
+				* glm::scale(glm::mat4(1.0f), m_Scale);
+		}
+
+		//====Cached matrices====//
+		const glm::mat4& GetLocalToWorldMatrix() const { UpdateMatrices(); return m_LocalToWorld; }
+		const glm::mat4& GetWorldToLocalMatrix() const { UpdateMatrices(); return m_WorldToLocal; }
+		// Transforms normals to world space
+		const glm::mat4& GetWorldToLocalTransposeMatrix() const { UpdateMatrices(); return m_WorldToLocalTranspose; }
+		bool IsDirty() const { return m_bDirty; }
+		// Changes every time the cached matrices are rebuilt, caches of data derived from them (world bounds) compare it
+		uint32_t GetMatrixVersion() const { return m_MatrixVersion; }
+		void UpdateMatrices() const;
+
+        glm::mat4 GetTransform() const { return GetLocalToWorldMatrix(); }
+		glm::vec3 GetWorldPosition() const { return glm::vec3(GetLocalToWorldMatrix()[3]); }
+		bool HasParent() const { return m_bHasParent; }
+
+		// Keep the state of the last simulated step so rendering can interpolate towards the current one
+		void SavePreviousState()
+		{
+			m_PreviousPosition = m_Position;
+			m_PreviousRotation = m_Rotation;
+			m_PreviousScale = m_Scale;
+			m_bHasPreviousState = true;
+		}
 
-			glm::mat4 test1 = glm::toMat4(glm::quat(glm::vec3(0, 0, 0)));
-			glm::mat4 test2 = glm::toMat4(glm::quat(glm::vec3(0, glm::radians(90.0f), 0)));
-			glm::mat4 test3 = glm::toMat4(glm::quat(glm::vec3(0, glm::radians(180.0f), 0)));
-			glm::mat4 test4 = glm::toMat4(glm::quat(glm::vec3(0, 360, 0)));
-			*/
-            glm::mat4 rotation = glm::toMat4(glm::quat(glm::radians(Rotation)));
+		// True when the last simulated step moved it or one of its ancestors, only then GetInterpolatedTransform
+		// differs from the cached matrix
+		bool IsInterpolated(float alpha) const;
 
-            return glm::translate(glm::mat4(1.0f), Position)
-                * rotation
-                * glm::scale(glm::mat4(1.0f), Scale);
-        }
+		// alpha 0 is the previous simulated step, 1 the current one. Below a parent the interpolated parent
+		// matrix is composed down the hierarchy, a still child follows its moving parent
+		glm::mat4 GetInterpolatedTransform(float alpha) const;
 
 		glm::vec3 GetForwardVector() const
 		{
-			glm::quat rotation = glm::quat(glm::radians(Rotation));
+			glm::quat rotation = glm::quat(glm::radians(m_Rotation));
 			return rotation * glm::vec3(0, 0, 1);
 		}
 		glm::vec3 GetBackVector() const
 		{
-			glm::quat rotation = glm::quat(glm::radians(Rotation));
+			glm::quat rotation = glm::quat(glm::radians(m_Rotation));
 			return rotation * glm::vec3(0, 0, -1);
 		}
 		glm::vec3 GetRightVector() const
 		{
-			glm::quat rotation = glm::quat(glm::radians(Rotation));
+			glm::quat rotation = glm::quat(glm::radians(m_Rotation));
 			return rotation * glm::vec3(1, 0, 0);
 		}
 		glm::vec3 GetLeftVector() const
 		{
-			glm::quat rotation = glm::quat(glm::radians(Rotation));
+			glm::quat rotation = glm::quat(glm::radians(m_Rotation));
 			return rotation * glm::vec3(-1, 0, 0);
 		}
 		glm::vec3 GetUpVector() const
 		{
-			glm::quat rotation = glm::quat(glm::radians(Rotation));
+			glm::quat rotation = glm::quat(glm::radians(m_Rotation));
 			return rotation * glm::vec3(0, 1, 0);
 		}
 		glm::vec3 GetDownVector() const
 		{
-			glm::quat rotation = glm::quat(glm::radians(Rotation));
+			glm::quat rotation = glm::quat(glm::radians(m_Rotation));
 			return rotation * glm::vec3(0, -1, 0);
 		}
+
+	private:
+		void MarkDirty() { m_bDirty = true; m_bMoved = true; }
+		// The parent's cached local to world matrix
+		glm::mat4 GetParentMatrix() const;
+		const TransformComponent& GetParentTransform() const;
+		bool HasMovedInLastStep() const
+		{
+			return m_bHasPreviousState
+				&& (m_PreviousPosition != m_Position || m_PreviousRotation != m_Rotation || m_PreviousScale != m_Scale);
+		}
+		// Leaves outTransform untouched and returns false when neither it nor an ancestor moved in the last step
+		bool ComputeInterpolatedTransform(float alpha, glm::mat4& outTransform) const;
+		// Set by the hierarchy update, which already combined the parent and local matrices
+		void SetLocalToWorldMatrix(const glm::mat4& localToWorld) const;
+
+	private:
+        glm::vec3 m_Position = { 0.0f, 0.0f, 0.0f };
+        glm::vec3 m_Rotation = { 0.0f, 0.0f, 0.0f };
+        glm::vec3 m_Scale = { 1.0f, 1.0f, 1.0f };
+
+		// Fixed timestep: state before the last simulated step
+		glm::vec3 m_PreviousPosition = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 m_PreviousRotation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 m_PreviousScale = { 1.0f, 1.0f, 1.0f };
+		bool m_bHasPreviousState = false;
+
+		mutable bool m_bDirty = true;
+		mutable uint32_t m_MatrixVersion = 0;
+		// Changed since the last World::UpdateTransforms, its subtree is recomputed there. The lazy getters leave it set
+		bool m_bMoved = true;
+		bool m_bHasParent = false;
+		mutable glm::mat4 m_LocalToWorld = glm::mat4(1.0f);
+		mutable glm::mat4 m_WorldToLocal = glm::mat4(1.0f);
+		mutable glm::mat4 m_WorldToLocalTranspose = glm::mat4(1.0f);
     };
     
 }
\ No newline at end of file
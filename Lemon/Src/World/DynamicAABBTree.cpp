@@ -0,0 +1,509 @@
+#include "LemonPCH.h"
+#include "DynamicAABBTree.h"
+
+namespace Lemon
+{
+	namespace
+	{
+		// Reinsertions before RebalanceIfNeeded looks at the tree at all, for small trees
+		constexpr uint32_t MinReinsertsBeforeRebalance = 64;
+		// Area ratio growth over the last rebuild that triggers the next one
+		constexpr float RebuildAreaGrowth = 1.2f;
+	}
+
+	uint32_t DynamicAABBTree::CreateProxy(const AABB& bounds, entt::entity entity)
+	{
+		const uint32_t proxy = AllocateNode();
+		Node& node = m_Nodes[proxy];
+		node.Bounds = bounds.Expanded(glm::vec3(FatMargin));
+		node.Entity = entity;
+		node.Height = 0;
+		InsertLeaf(proxy);
+		m_ProxyCount++;
+		return proxy;
+	}
+
+	void DynamicAABBTree::DestroyProxy(uint32_t proxy)
+	{
+		LEMON_CORE_ASSERT(m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0, "Not a proxy");
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_ProxyCount--;
+	}
+
+	bool DynamicAABBTree::MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement)
+	{
+		const glm::vec3 predicted = displacement * DisplacementMultiplier;
+		AABB fatBounds = bounds.Expanded(glm::vec3(FatMargin));
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (predicted[axis] < 0.0f)
+			{
+				fatBounds.Min[axis] += predicted[axis];
+			}
+			else
+			{
+				fatBounds.Max[axis] += predicted[axis];
+			}
+		}
+
+		// Still inside, unless a big move once stretched the fat box far beyond what it needs now
+		const AABB& oldFatBounds = m_Nodes[proxy].Bounds;
+		if (oldFatBounds.Contains(bounds) && fatBounds.Expanded(glm::vec3(4.0f * FatMargin)).Contains(oldFatBounds))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxy);
+		m_Nodes[proxy].Bounds = fatBounds;
+		InsertLeaf(proxy);
+		m_ReinsertCount++;
+		return true;
+	}
+
+	void DynamicAABBTree::Clear()
+	{
+		m_Nodes.clear();
+		m_Root = NullNode;
+		m_FreeList = NullNode;
+		m_ProxyCount = 0;
+		m_ReinsertCount = 0;
+		m_RebuiltAreaRatio = 0.0f;
+	}
+
+	float DynamicAABBTree::GetAreaRatio() const
+	{
+		if (m_Root == NullNode)
+		{
+			return 0.0f;
+		}
+
+		float totalArea = 0.0f;
+		for (const Node& node : m_Nodes)
+		{
+			if (node.Height >= 0)
+			{
+				totalArea += node.Bounds.GetSurfaceArea();
+			}
+		}
+		const float rootArea = m_Nodes[m_Root].Bounds.GetSurfaceArea();
+		return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+	}
+
+	void DynamicAABBTree::Rebuild()
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		m_RebuildLeaves.clear();
+		for (uint32_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (m_Nodes[i].Height == 0)
+			{
+				m_RebuildLeaves.push_back(i);
+			}
+			else if (m_Nodes[i].Height > 0)
+			{
+				FreeNode(i);
+			}
+		}
+
+		m_Root = NullNode;
+		if (!m_RebuildLeaves.empty())
+		{
+			m_Root = BuildTopDown(m_RebuildLeaves.data(), static_cast<uint32_t>(m_RebuildLeaves.size()));
+			m_Nodes[m_Root].Parent = NullNode;
+		}
+		m_ReinsertCount = 0;
+		m_RebuiltAreaRatio = GetAreaRatio();
+	}
+
+	bool DynamicAABBTree::RebalanceIfNeeded()
+	{
+		if (m_ReinsertCount < (std::max)(m_ProxyCount, MinReinsertsBeforeRebalance))
+		{
+			return false;
+		}
+
+		m_ReinsertCount = 0;
+		if (m_RebuiltAreaRatio > 0.0f && GetAreaRatio() <= m_RebuiltAreaRatio * RebuildAreaGrowth)
+		{
+			return false;
+		}
+		Rebuild();
+		return true;
+	}
+
+	bool DynamicAABBTree::Validate() const
+	{
+		auto fail = [](const char* problem, uint32_t node)
+		{
+			LEMON_CORE_ERROR("DynamicAABBTree: {0} at node {1}", problem, node);
+			return false;
+		};
+		const uint32_t nodeCount = static_cast<uint32_t>(m_Nodes.size());
+
+		if (m_Root != NullNode && (m_Root >= nodeCount || m_Nodes[m_Root].Parent != NullNode))
+		{
+			return fail("root with a parent", m_Root);
+		}
+
+		uint32_t reachedCount = 0;
+		uint32_t leafCount = 0;
+		std::vector<uint32_t> stack;
+		if (m_Root != NullNode)
+		{
+			stack.push_back(m_Root);
+		}
+		while (!stack.empty())
+		{
+			const uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = m_Nodes[index];
+			// More nodes than exist means a node is reached twice
+			if (++reachedCount > nodeCount)
+			{
+				return fail("cycle", index);
+			}
+
+			if (node.IsLeaf())
+			{
+				if (node.Child2 != NullNode || node.Height != 0)
+				{
+					return fail("leaf with a child or a height", index);
+				}
+				leafCount++;
+				continue;
+			}
+
+			if (node.Child1 >= nodeCount || node.Child2 >= nodeCount)
+			{
+				return fail("missing child", index);
+			}
+			const Node& child1 = m_Nodes[node.Child1];
+			const Node& child2 = m_Nodes[node.Child2];
+			if (child1.Parent != index || child2.Parent != index)
+			{
+				return fail("child linked to another parent", index);
+			}
+			if (node.Height != 1 + (std::max)(child1.Height, child2.Height))
+			{
+				return fail("wrong height", index);
+			}
+			const AABB bounds = AABB::Union(child1.Bounds, child2.Bounds);
+			if (node.Bounds.Min != bounds.Min || node.Bounds.Max != bounds.Max)
+			{
+				return fail("bounds not the union of its children", index);
+			}
+			stack.push_back(node.Child1);
+			stack.push_back(node.Child2);
+		}
+
+		if (leafCount != m_ProxyCount)
+		{
+			return fail("leaf count differs from the proxy count", m_Root);
+		}
+
+		uint32_t freeCount = 0;
+		for (uint32_t index = m_FreeList; index != NullNode; index = m_Nodes[index].Parent)
+		{
+			if (index >= nodeCount || m_Nodes[index].Height != -1 || ++freeCount > nodeCount)
+			{
+				return fail("broken free list", index);
+			}
+		}
+		if (reachedCount + freeCount != nodeCount)
+		{
+			return fail("node neither in the tree nor free", m_Root);
+		}
+		return true;
+	}
+
+	uint32_t DynamicAABBTree::AllocateNode()
+	{
+		uint32_t index;
+		if (m_FreeList == NullNode)
+		{
+			index = static_cast<uint32_t>(m_Nodes.size());
+			m_Nodes.emplace_back();
+		}
+		else
+		{
+			index = m_FreeList;
+			m_FreeList = m_Nodes[index].Parent;
+			m_Nodes[index] = Node();
+		}
+		return index;
+	}
+
+	void DynamicAABBTree::FreeNode(uint32_t node)
+	{
+		m_Nodes[node].Parent = m_FreeList;
+		m_Nodes[node].Height = -1;
+		m_Nodes[node].Entity = entt::null;
+		m_FreeList = node;
+	}
+
+	void DynamicAABBTree::InsertLeaf(uint32_t leaf)
+	{
+		if (m_Root == NullNode)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = NullNode;
+			return;
+		}
+
+		// Walk down towards the sibling that grows the tree's surface area the least
+		const AABB leafBounds = m_Nodes[leaf].Bounds;
+		uint32_t index = m_Root;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node& node = m_Nodes[index];
+			const float area = node.Bounds.GetSurfaceArea();
+			const float combinedArea = AABB::Union(node.Bounds, leafBounds).GetSurfaceArea();
+
+			// New parent for this node and the leaf
+			const float cost = 2.0f * combinedArea;
+			// Every node below grows at least by this much
+			const float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [this, &leafBounds, inheritanceCost](uint32_t child)
+			{
+				const AABB& childBounds = m_Nodes[child].Bounds;
+				const float childCombinedArea = AABB::Union(childBounds, leafBounds).GetSurfaceArea();
+				return m_Nodes[child].IsLeaf()
+					? childCombinedArea + inheritanceCost
+					: childCombinedArea - childBounds.GetSurfaceArea() + inheritanceCost;
+			};
+			const float cost1 = descendCost(node.Child1);
+			const float cost2 = descendCost(node.Child2);
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		const uint32_t sibling = index;
+		const uint32_t oldParent = m_Nodes[sibling].Parent;
+		const uint32_t newParent = AllocateNode();
+		Node& parent = m_Nodes[newParent];
+		parent.Parent = oldParent;
+		parent.Bounds = AABB::Union(leafBounds, m_Nodes[sibling].Bounds);
+		parent.Height = m_Nodes[sibling].Height + 1;
+		parent.Child1 = sibling;
+		parent.Child2 = leaf;
+
+		if (oldParent != NullNode)
+		{
+			if (m_Nodes[oldParent].Child1 == sibling)
+			{
+				m_Nodes[oldParent].Child1 = newParent;
+			}
+			else
+			{
+				m_Nodes[oldParent].Child2 = newParent;
+			}
+		}
+		else
+		{
+			m_Root = newParent;
+		}
+		m_Nodes[sibling].Parent = newParent;
+		m_Nodes[leaf].Parent = newParent;
+
+		RefitAncestors(m_Nodes[leaf].Parent);
+	}
+
+	void DynamicAABBTree::RemoveLeaf(uint32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		const uint32_t parent = m_Nodes[leaf].Parent;
+		const uint32_t grandParent = m_Nodes[parent].Parent;
+		const uint32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+		// The sibling takes the parent's place
+		if (grandParent != NullNode)
+		{
+			if (m_Nodes[grandParent].Child1 == parent)
+			{
+				m_Nodes[grandParent].Child1 = sibling;
+			}
+			else
+			{
+				m_Nodes[grandParent].Child2 = sibling;
+			}
+			m_Nodes[sibling].Parent = grandParent;
+			FreeNode(parent);
+			RefitAncestors(grandParent);
+		}
+		else
+		{
+			m_Root = sibling;
+			m_Nodes[sibling].Parent = NullNode;
+			FreeNode(parent);
+		}
+	}
+
+	void DynamicAABBTree::RefitAncestors(uint32_t node)
+	{
+		while (node != NullNode)
+		{
+			node = Balance(node);
+
+			Node& current = m_Nodes[node];
+			const Node& child1 = m_Nodes[current.Child1];
+			const Node& child2 = m_Nodes[current.Child2];
+			current.Height = 1 + (std::max)(child1.Height, child2.Height);
+			current.Bounds = AABB::Union(child1.Bounds, child2.Bounds);
+
+			node = current.Parent;
+		}
+	}
+
+	uint32_t DynamicAABBTree::Balance(uint32_t indexA)
+	{
+		Node& a = m_Nodes[indexA];
+		if (a.IsLeaf() || a.Height < 2)
+		{
+			return indexA;
+		}
+
+		const uint32_t indexB = a.Child1;
+		const uint32_t indexC = a.Child2;
+		Node& b = m_Nodes[indexB];
+		Node& c = m_Nodes[indexC];
+
+		auto replaceInParent = [this, indexA](uint32_t parent, uint32_t replacement)
+		{
+			if (parent == NullNode)
+			{
+				m_Root = replacement;
+			}
+			else if (m_Nodes[parent].Child1 == indexA)
+			{
+				m_Nodes[parent].Child1 = replacement;
+			}
+			else
+			{
+				m_Nodes[parent].Child2 = replacement;
+			}
+		};
+
+		const int32_t balance = c.Height - b.Height;
+
+		// Rotate c up, a becomes its child and keeps the lower of c's children
+		if (balance > 1)
+		{
+			const uint32_t indexF = c.Child1;
+			const uint32_t indexG = c.Child2;
+			Node& f = m_Nodes[indexF];
+			Node& g = m_Nodes[indexG];
+
+			c.Child1 = indexA;
+			c.Parent = a.Parent;
+			a.Parent = indexC;
+			replaceInParent(c.Parent, indexC);
+
+			if (f.Height > g.Height)
+			{
+				c.Child2 = indexF;
+				a.Child2 = indexG;
+				g.Parent = indexA;
+				a.Bounds = AABB::Union(b.Bounds, g.Bounds);
+				c.Bounds = AABB::Union(a.Bounds, f.Bounds);
+				a.Height = 1 + (std::max)(b.Height, g.Height);
+				c.Height = 1 + (std::max)(a.Height, f.Height);
+			}
+			else
+			{
+				c.Child2 = indexG;
+				a.Child2 = indexF;
+				f.Parent = indexA;
+				a.Bounds = AABB::Union(b.Bounds, f.Bounds);
+				c.Bounds = AABB::Union(a.Bounds, g.Bounds);
+				a.Height = 1 + (std::max)(b.Height, f.Height);
+				c.Height = 1 + (std::max)(a.Height, g.Height);
+			}
+			return indexC;
+		}
+
+		// Rotate b up
+		if (balance < -1)
+		{
+			const uint32_t indexD = b.Child1;
+			const uint32_t indexE = b.Child2;
+			Node& d = m_Nodes[indexD];
+			Node& e = m_Nodes[indexE];
+
+			b.Child1 = indexA;
+			b.Parent = a.Parent;
+			a.Parent = indexB;
+			replaceInParent(b.Parent, indexB);
+
+			if (d.Height > e.Height)
+			{
+				b.Child2 = indexD;
+				a.Child1 = indexE;
+				e.Parent = indexA;
+				a.Bounds = AABB::Union(c.Bounds, e.Bounds);
+				b.Bounds = AABB::Union(a.Bounds, d.Bounds);
+				a.Height = 1 + (std::max)(c.Height, e.Height);
+				b.Height = 1 + (std::max)(a.Height, d.Height);
+			}
+			else
+			{
+				b.Child2 = indexE;
+				a.Child1 = indexD;
+				d.Parent = indexA;
+				a.Bounds = AABB::Union(c.Bounds, d.Bounds);
+				b.Bounds = AABB::Union(a.Bounds, e.Bounds);
+				a.Height = 1 + (std::max)(c.Height, d.Height);
+				b.Height = 1 + (std::max)(a.Height, e.Height);
+			}
+			return indexB;
+		}
+
+		return indexA;
+	}
+
+	uint32_t DynamicAABBTree::BuildTopDown(uint32_t* leaves, uint32_t count)
+	{
+		if (count == 1)
+		{
+			return leaves[0];
+		}
+
+		AABB centers;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			centers.Merge(m_Nodes[leaves[i]].Bounds.GetCenter());
+		}
+		const glm::vec3 size = centers.Max - centers.Min;
+		const int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+
+		const uint32_t half = count / 2;
+		std::nth_element(leaves, leaves + half, leaves + count, [this, axis](uint32_t lhs, uint32_t rhs)
+		{
+			return m_Nodes[lhs].Bounds.GetCenter()[axis] < m_Nodes[rhs].Bounds.GetCenter()[axis];
+		});
+
+		const uint32_t child1 = BuildTopDown(leaves, half);
+		const uint32_t child2 = BuildTopDown(leaves + half, count - half);
+
+		const uint32_t index = AllocateNode();
+		Node& node = m_Nodes[index];
+		node.Child1 = child1;
+		node.Child2 = child2;
+		node.Bounds = AABB::Union(m_Nodes[child1].Bounds, m_Nodes[child2].Bounds);
+		node.Height = 1 + (std::max)(m_Nodes[child1].Height, m_Nodes[child2].Height);
+		m_Nodes[child1].Parent = index;
+		m_Nodes[child2].Parent = index;
+		return index;
+	}
+}
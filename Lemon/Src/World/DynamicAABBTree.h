@@ -0,0 +1,263 @@
+#pragma once
+#include "Core/Core.h"
+#include "Math/Bounds.h"
+#include <entt/include/entt.hpp>
+#include <vector>
+
+namespace Lemon
+{
+	/**
+	 * Bounding volume hierarchy over entity bounds that is updated in place as they move.
+	 * Every proxy is stored with a fat box, its bounds grown by a margin and by the last displacement, so small
+	 * moves do not touch the tree at all. Leaving the fat box removes and reinserts the leaf at the cheapest sibling
+	 * (surface area heuristic), tree rotations on the way up keep it balanced. Many reinsertions still degrade it
+	 * over time, RebalanceIfNeeded then rebuilds it top down.
+	 * Queries report the fat boxes, callers test the tight bounds themselves when they need to.
+	 */
+	class LEMON_API DynamicAABBTree
+	{
+	public:
+		static constexpr uint32_t NullNode = ~0u;
+		// Absolute margin of the fat boxes, in world units
+		static constexpr float FatMargin = 0.1f;
+		// The fat box also stretches this many times the last displacement ahead of the proxy
+		static constexpr float DisplacementMultiplier = 2.0f;
+
+		uint32_t CreateProxy(const AABB& bounds, entt::entity entity);
+		void DestroyProxy(uint32_t proxy);
+		// Reinserts the proxy when bounds left its fat box, returns whether it did
+		bool MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement);
+		void Clear();
+
+		const AABB& GetFatBounds(uint32_t proxy) const { return m_Nodes[proxy].Bounds; }
+		entt::entity GetEntity(uint32_t proxy) const { return m_Nodes[proxy].Entity; }
+		uint32_t GetProxyCount() const { return m_ProxyCount; }
+		uint32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+		// Summed area of all nodes over the root's, lower is a better tree
+		float GetAreaRatio() const;
+
+		// Top down rebuild, median split along the longest axis of the leaf centers
+		void Rebuild();
+		// Rebuilds once the reinsertions since the last rebuild add up to the proxy count and the area ratio grew
+		// noticeably since, so the check stays cheap when nothing moves. Returns whether it rebuilt
+		bool RebalanceIfNeeded();
+
+		// Walks the whole tree: parent and child links, heights, every node's bounds the union of its children's,
+		// one leaf per proxy and every other node on the free list. Logs the first problem and returns false
+		bool Validate() const;
+
+		//====Queries====//
+		// fn(entt::entity) returns false to stop the query early
+
+		template<typename Fn>
+		void QueryAABB(const AABB& bounds, Fn&& fn) const
+		{
+			NodeStack stack;
+			stack.Push(m_Root);
+			while (!stack.IsEmpty())
+			{
+				const uint32_t nodeIndex = stack.Pop();
+				if (nodeIndex == NullNode)
+				{
+					continue;
+				}
+				const Node& node = m_Nodes[nodeIndex];
+				if (!node.Bounds.Overlaps(bounds))
+				{
+					continue;
+				}
+				if (node.IsLeaf())
+				{
+					if (!fn(node.Entity))
+					{
+						return;
+					}
+					continue;
+				}
+				stack.Push(node.Child1);
+				stack.Push(node.Child2);
+			}
+		}
+
+		// Subtrees fully inside the frustum are reported without testing their nodes
+		template<typename Fn>
+		void QueryFrustum(const Frustum& frustum, Fn&& fn) const
+		{
+			NodeStack stack;
+			stack.Push(m_Root);
+			while (!stack.IsEmpty())
+			{
+				const uint32_t nodeIndex = stack.Pop();
+				if (nodeIndex == NullNode)
+				{
+					continue;
+				}
+				const Node& node = m_Nodes[nodeIndex];
+				const EFrustumTest test = frustum.Test(node.Bounds);
+				if (test == EFrustumTest::Outside)
+				{
+					continue;
+				}
+				if (test == EFrustumTest::Inside)
+				{
+					if (!ReportSubtree(nodeIndex, fn))
+					{
+						return;
+					}
+					continue;
+				}
+				if (node.IsLeaf())
+				{
+					if (!fn(node.Entity))
+					{
+						return;
+					}
+					continue;
+				}
+				stack.Push(node.Child1);
+				stack.Push(node.Child2);
+			}
+		}
+
+		// fn(entt::entity, float distance to the fat box) returns the new maximum distance: the distance of
+		// its own hit clips the ray to it, maxDistance keeps going and 0 stops. Nearer children are visited first
+		template<typename Fn>
+		void RayCast(const Ray& ray, float maxDistance, Fn&& fn) const
+		{
+			NodeStack stack;
+			stack.Push(m_Root);
+			while (!stack.IsEmpty())
+			{
+				const uint32_t nodeIndex = stack.Pop();
+				if (nodeIndex == NullNode)
+				{
+					continue;
+				}
+				const Node& node = m_Nodes[nodeIndex];
+				float distance;
+				if (!node.Bounds.IntersectsRay(ray, maxDistance, distance))
+				{
+					continue;
+				}
+				if (node.IsLeaf())
+				{
+					maxDistance = fn(node.Entity, distance);
+					if (maxDistance <= 0.0f)
+					{
+						return;
+					}
+					continue;
+				}
+
+				float distance1 = FLT_MAX;
+				float distance2 = FLT_MAX;
+				const bool bHit1 = m_Nodes[node.Child1].Bounds.IntersectsRay(ray, maxDistance, distance1);
+				const bool bHit2 = m_Nodes[node.Child2].Bounds.IntersectsRay(ray, maxDistance, distance2);
+				// Far one first, the near one is popped next
+				if (distance1 <= distance2)
+				{
+					stack.Push(bHit2 ? node.Child2 : NullNode);
+					stack.Push(bHit1 ? node.Child1 : NullNode);
+				}
+				else
+				{
+					stack.Push(bHit1 ? node.Child1 : NullNode);
+					stack.Push(bHit2 ? node.Child2 : NullNode);
+				}
+			}
+		}
+
+	private:
+		struct Node
+		{
+			AABB Bounds;
+			uint32_t Parent = NullNode;
+			uint32_t Child1 = NullNode;
+			uint32_t Child2 = NullNode;
+			// Leaf 0, free -1
+			int32_t Height = 0;
+			entt::entity Entity = entt::null;
+
+			bool IsLeaf() const { return Child1 == NullNode; }
+		};
+
+		// Traversal stack, on the stack of the caller unless the tree is unusually deep
+		class NodeStack
+		{
+		public:
+			void Push(uint32_t node)
+			{
+				if (m_Count < InlineCapacity)
+				{
+					m_Inline[m_Count] = node;
+				}
+				else
+				{
+					m_Overflow.push_back(node);
+				}
+				m_Count++;
+			}
+			uint32_t Pop()
+			{
+				m_Count--;
+				if (m_Count < InlineCapacity)
+				{
+					return m_Inline[m_Count];
+				}
+				const uint32_t node = m_Overflow.back();
+				m_Overflow.pop_back();
+				return node;
+			}
+			bool IsEmpty() const { return m_Count == 0; }
+
+		private:
+			static constexpr uint32_t InlineCapacity = 128;
+			uint32_t m_Inline[InlineCapacity];
+			uint32_t m_Count = 0;
+			std::vector<uint32_t> m_Overflow;
+		};
+
+		template<typename Fn>
+		bool ReportSubtree(uint32_t root, Fn& fn) const
+		{
+			NodeStack stack;
+			stack.Push(root);
+			while (!stack.IsEmpty())
+			{
+				const Node& node = m_Nodes[stack.Pop()];
+				if (node.IsLeaf())
+				{
+					if (!fn(node.Entity))
+					{
+						return false;
+					}
+					continue;
+				}
+				stack.Push(node.Child1);
+				stack.Push(node.Child2);
+			}
+			return true;
+		}
+
+		uint32_t AllocateNode();
+		void FreeNode(uint32_t node);
+		void InsertLeaf(uint32_t leaf);
+		void RemoveLeaf(uint32_t leaf);
+		// Refits bounds and heights from node up to the root, rotating unbalanced nodes on the way
+		void RefitAncestors(uint32_t node);
+		uint32_t Balance(uint32_t node);
+		uint32_t BuildTopDown(uint32_t* leaves, uint32_t count);
+
+	private:
+		std::vector<Node> m_Nodes;
+		uint32_t m_Root = NullNode;
+		// Linked through Node::Parent
+		uint32_t m_FreeList = NullNode;
+		uint32_t m_ProxyCount = 0;
+
+		uint32_t m_ReinsertCount = 0;
+		float m_RebuiltAreaRatio = 0.0f;
+		// Scratch of Rebuild, kept to reuse its capacity
+		std::vector<uint32_t> m_RebuildLeaves;
+	};
+}
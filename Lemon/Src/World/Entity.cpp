@@ -1,12 +1,50 @@
 ﻿#include "LemonPCH.h"
 #include "Entity.h"
+#include "World.h"
+#include "Components/NameComponent.h"
+#include "Components/TagComponents.h"
 
 namespace Lemon
 {
-    Entity::Entity(entt::entity handle, World* world, const std::string& entityName)
-        : m_EntityHandle(handle), m_World(world), m_entityName(entityName)
+    bool Entity::IsValid() const
     {
-        
+        return m_World && GetRegistry<IComponent>().valid(m_EntityHandle);
     }
 
-}
\ No newline at end of file
+    const std::string& Entity::GetName() const
+    {
+        static const std::string emptyName;
+        const NameComponent* nameComp = GetRegistry<NameComponent>().try_get<NameComponent>(m_EntityHandle);
+        return nameComp ? nameComp->GetName() : emptyName;
+    }
+
+    void Entity::SetName(const std::string& name)
+    {
+        if (NameComponent* nameComp = GetRegistry<NameComponent>().try_get<NameComponent>(m_EntityHandle))
+        {
+            nameComp->SetName(name);
+        }
+        else
+        {
+            AddComponent<NameComponent>(name);
+        }
+    }
+
+    bool Entity::IsGizmo() const
+    {
+        return GetRegistry<GizmoTag>().has<GizmoTag>(m_EntityHandle);
+    }
+
+    void Entity::SetGizmo(bool bIsGizmo)
+    {
+        entt::registry& registry = GetRegistry<GizmoTag>();
+        if (bIsGizmo)
+        {
+            registry.emplace_or_replace<GizmoTag>(m_EntityHandle);
+        }
+        else
+        {
+            registry.remove_if_exists<GizmoTag>(m_EntityHandle);
+        }
+    }
+}
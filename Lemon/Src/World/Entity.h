@@ -1,11 +1,14 @@
 #pragma once
 #include "Core/Core.h"
+#include "Core/MemoryTracker.h"
+#include "Log/Log.h"
 #include <type_traits>
 #include <entt/include/entt.hpp>
 
 namespace Lemon
 {
     class World;
+    class IComponent;
 
 #define CHECK_COMPONENT_VALID() 	constexpr bool bValid = std::is_base_of<IComponent, T>::value;\
 									LEMON_CORE_ASSERT(bValid, "Component is not derived IComponent");
@@ -14,15 +17,15 @@ namespace Lemon
     {
     public:
         Entity() = default;
-        Entity(entt::entity handle, World* world, const std::string& entityName);
-        Entity(const Entity& other) = default;
+        Entity(entt::entity handle, World* world) : m_EntityHandle(handle), m_World(world) {}
 
         template<typename T, typename... Args>
         T& AddComponent(Args&&... args)
         {
 			CHECK_COMPONENT_VALID();
             LEMON_CORE_ASSERT(!HasComponent<T>(), "Entity already has component!");
-            T& component = m_World->m_Registry.emplace<T>(m_EntityHandle, std::forward<Args>(args)...);
+            LEMON_MEMORY_SCOPE(EntityStorage);
+            T& component = GetRegistry<T>().template emplace<T>(m_EntityHandle, std::forward<Args>(args)...);
 			component.m_Entity = *this;
             return component;
         }
@@ -32,14 +35,14 @@ namespace Lemon
 		{
 			CHECK_COMPONENT_VALID();
 			LEMON_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
-            return m_World->m_Registry.get<T>(m_EntityHandle);
+            return GetRegistry<T>().template get<T>(m_EntityHandle);
         }
 		template<typename T>
 		const T& GetComponent() const
 		{
 			CHECK_COMPONENT_VALID();
 			LEMON_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
-			return m_World->m_Registry.get<T>(m_EntityHandle);
+			return GetRegistry<T>().template get<T>(m_EntityHandle);
 		}
 
         template<typename T>
@@ -47,18 +50,19 @@ namespace Lemon
 		{
 			CHECK_COMPONENT_VALID();
             LEMON_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
-            m_World->m_Registry.remove<T>(m_EntityHandle);
+            LEMON_MEMORY_SCOPE(EntityStorage);
+            GetRegistry<T>().template remove<T>(m_EntityHandle);
         }
         
         template<typename T>
         bool HasComponent()
         {
-            return m_World->m_Registry.has<T>(m_EntityHandle);
+            return GetRegistry<T>().template has<T>(m_EntityHandle);
         }
 		template<typename T>
 		bool HasComponent() const
 		{
-			return m_World->m_Registry.has<T>(m_EntityHandle);
+			return GetRegistry<T>().template has<T>(m_EntityHandle);
 		}
         // operator
         operator bool() const { return m_EntityHandle != entt::null && m_World != nullptr; }
@@ -73,24 +77,30 @@ namespace Lemon
             return !(*this == other);
         }
 		World* GetWorld() const { return m_World; }
+		// Not destroyed yet, unlike operator bool which only checks for a null handle
+		bool IsValid() const;
 
-    	// Name
-    	const std::string& GetName() const { return m_entityName; }
-		std::string& GetName() {return m_entityName;}
-		// Gizmo flag
-		bool IsGizmo() const { return m_bIsGizmo; }
-		void SetGizmo(bool bIsGizmo) { m_bIsGizmo = bIsGizmo; }
+    	// Name, kept in the NameComponent. Empty when the entity has none
+    	const std::string& GetName() const;
+		void SetName(const std::string& name);
+		// Gizmo flag, the GizmoTag
+		bool IsGizmo() const;
+		void SetGizmo(bool bIsGizmo);
+
+    private:
+        // World is only forward declared here, the dependent W delays the lookup to instantiation
+        template<typename T, typename W = World>
+        entt::registry& GetRegistry() const
+        {
+            return static_cast<W*>(m_World)->m_Registry;
+        }
 
-    	//
-    	void MarkDestroy() { m_bIsDestroy = true; }
-    	bool IsMarkDestroy() const { return m_bIsDestroy; }
-    	
     private:
         entt::entity m_EntityHandle {0};
         World* m_World = nullptr;
-        std::string m_entityName;
-		bool m_bIsGizmo = false;
-    	bool m_bIsDestroy = false;
     };
+
+    // Passed by value everywhere, every component embeds one
+    static_assert(sizeof(Entity) == 16 && std::is_trivially_copyable<Entity>::value, "Entity must stay a small trivially copyable handle");
 }
 
@@ -0,0 +1,121 @@
+#include "LemonPCH.h"
+#include "EntityCommandBuffer.h"
+#include "World.h"
+#include "Components/NameComponent.h"
+#include "Components/TransformComponent.h"
+
+namespace Lemon
+{
+	EntityCommandBuffer::~EntityCommandBuffer()
+	{
+		Clear();
+	}
+
+	EntityCommandBuffer::PendingEntity EntityCommandBuffer::CreateEntity(const std::string& name /*= std::string()*/)
+	{
+		Command command;
+		command.Type = ECommandType::CreateEntity;
+		command.PendingIndex = m_PendingEntityCount;
+		if (!name.empty())
+		{
+			// Holds a reference on the interned name until the playback, interning is thread safe
+			command.Payload = new (AllocatePayload(sizeof(NameComponent), alignof(NameComponent))) NameComponent(name);
+			command.DestroyPayload = [](void* payload) { static_cast<NameComponent*>(payload)->~NameComponent(); };
+		}
+		m_Commands.push_back(command);
+		return PendingEntity{ m_PendingEntityCount++ };
+	}
+
+	void EntityCommandBuffer::DestroyEntity(Entity entity)
+	{
+		Command command;
+		command.Type = ECommandType::DestroyEntity;
+		command.Target = entity;
+		command.PendingIndex = InvalidIndex;
+		m_Commands.push_back(command);
+	}
+
+	void EntityCommandBuffer::Playback(World& world)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		m_CreatedEntities.reserve(m_PendingEntityCount);
+		for (Command& command : m_Commands)
+		{
+			if (command.Type == ECommandType::CreateEntity)
+			{
+				const NameComponent* name = static_cast<const NameComponent*>(command.Payload);
+				m_CreatedEntities.push_back(world.CreateEntity(name ? name->GetName() : std::string()));
+				continue;
+			}
+
+			Entity entity = command.PendingIndex != InvalidIndex ? m_CreatedEntities[command.PendingIndex] : Entity(command.Target, &world);
+			if (!entity.IsValid())
+			{
+				continue;
+			}
+
+			if (command.Type == ECommandType::DestroyEntity)
+			{
+				world.DestroyEntity(entity);
+			}
+			else
+			{
+				command.Apply(entity, command.Payload);
+			}
+		}
+
+		Clear();
+	}
+
+	void EntityCommandBuffer::Clear()
+	{
+		for (const Command& command : m_Commands)
+		{
+			if (command.DestroyPayload)
+			{
+				command.DestroyPayload(command.Payload);
+			}
+		}
+		m_Commands.clear();
+		m_CreatedEntities.clear();
+		m_PendingEntityCount = 0;
+
+		m_BlockIndex = 0;
+		m_BlockOffset = 0;
+		m_LargePayloads.clear();
+	}
+
+	void* EntityCommandBuffer::AllocatePayload(size_t size, size_t alignment)
+	{
+		if (size > BlockSize)
+		{
+			m_LargePayloads.emplace_back(new uint8_t[size]);
+			return m_LargePayloads.back().get();
+		}
+
+		if (m_Blocks.empty())
+		{
+			m_Blocks.emplace_back(new uint8_t[BlockSize]);
+		}
+		size_t offset = (m_BlockOffset + alignment - 1) & ~(alignment - 1);
+		if (offset + size > BlockSize)
+		{
+			m_BlockIndex++;
+			if (m_BlockIndex == m_Blocks.size())
+			{
+				m_Blocks.emplace_back(new uint8_t[BlockSize]);
+			}
+			offset = 0;
+		}
+		m_BlockOffset = offset + size;
+		return m_Blocks[m_BlockIndex].get() + offset;
+	}
+
+	void EntityCommandBuffer::ReplaceComponent(TransformComponent& existing, TransformComponent&& component)
+	{
+		existing.SetPosition(component.GetPosition());
+		existing.SetRotation(component.GetRotation());
+		existing.SetScale(component.GetScale());
+	}
+}
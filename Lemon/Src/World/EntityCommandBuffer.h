@@ -0,0 +1,160 @@
+#pragma once
+#include "Core/Core.h"
+#include "Entity.h"
+#include <entt/include/entt.hpp>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Lemon
+{
+	class World;
+	class TransformComponent;
+
+	/**
+	 * Records structural changes (create, destroy, add and remove component) without touching the registry,
+	 * so jobs can prepare them in parallel. World plays them back on the main thread at a sync point, in recording order.
+	 * A buffer must only be recorded by one thread at a time, World::CreateCommandBuffer hands every job its own.
+	 * Components are constructed when recorded and moved into the registry by the playback.
+	 */
+	class LEMON_API EntityCommandBuffer
+	{
+	public:
+		// An entity created by this buffer, it only exists once the buffer is played back
+		struct PendingEntity
+		{
+			uint32_t Index = 0;
+		};
+
+		EntityCommandBuffer() = default;
+		~EntityCommandBuffer();
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+		PendingEntity CreateEntity(const std::string& name = std::string());
+		// Through World::DestroyEntity, so the entity still lives until the end of the frame
+		void DestroyEntity(Entity entity);
+
+		// Replaces the component when the entity already has one, like the TransformComponent every entity is created with
+		template<typename T, typename... Args>
+		void AddComponent(Entity entity, Args&&... args)
+		{
+			RecordAddComponent<T>(entity, InvalidIndex, std::forward<Args>(args)...);
+		}
+		template<typename T, typename... Args>
+		void AddComponent(PendingEntity entity, Args&&... args)
+		{
+			RecordAddComponent<T>(entt::null, entity.Index, std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		void RemoveComponent(Entity entity) { RecordRemoveComponent<T>(entity, InvalidIndex); }
+		template<typename T>
+		void RemoveComponent(PendingEntity entity) { RecordRemoveComponent<T>(entt::null, entity.Index); }
+
+		bool IsEmpty() const { return m_Commands.empty(); }
+		uint32_t GetCommandCount() const { return static_cast<uint32_t>(m_Commands.size()); }
+
+		// Applies the commands in recording order and clears the buffer, main thread only.
+		// Commands on entities that died before the playback are skipped
+		void Playback(World& world);
+		// Drops the commands without applying them, the memory is kept for the next recording
+		void Clear();
+
+	private:
+		enum class ECommandType : uint8_t
+		{
+			CreateEntity,
+			DestroyEntity,
+			AddComponent,
+			RemoveComponent,
+		};
+
+		struct Command
+		{
+			ECommandType Type;
+			// A living entity, or PendingIndex names one this buffer creates
+			entt::entity Target = entt::null;
+			uint32_t PendingIndex = 0;
+			// The component, or the NameComponent holding the name of CreateEntity
+			void* Payload = nullptr;
+			void (*Apply)(Entity& entity, void* payload) = nullptr;
+			void (*DestroyPayload)(void* payload) = nullptr;
+		};
+
+		static constexpr uint32_t InvalidIndex = ~0u;
+		static constexpr size_t BlockSize = 16 * 1024;
+
+		void* AllocatePayload(size_t size, size_t alignment);
+
+		template<typename T, typename... Args>
+		void RecordAddComponent(entt::entity target, uint32_t pendingIndex, Args&&... args)
+		{
+			static_assert(std::is_base_of<IComponent, T>::value, "Component is not derived IComponent");
+			static_assert(alignof(T) <= alignof(std::max_align_t), "Over aligned components are not supported");
+
+			Command command;
+			command.Type = ECommandType::AddComponent;
+			command.Target = target;
+			command.PendingIndex = pendingIndex;
+			command.Payload = new (AllocatePayload(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			command.Apply = &ApplyAddComponent<T>;
+			if constexpr (!std::is_trivially_destructible<T>::value)
+			{
+				command.DestroyPayload = [](void* payload) { static_cast<T*>(payload)->~T(); };
+			}
+			m_Commands.push_back(command);
+		}
+
+		template<typename T>
+		void RecordRemoveComponent(entt::entity target, uint32_t pendingIndex)
+		{
+			Command command;
+			command.Type = ECommandType::RemoveComponent;
+			command.Target = target;
+			command.PendingIndex = pendingIndex;
+			command.Apply = [](Entity& entity, void*)
+			{
+				if (entity.HasComponent<T>())
+				{
+					entity.RemoveComponent<T>();
+				}
+			};
+			m_Commands.push_back(command);
+		}
+
+		template<typename T>
+		static void ApplyAddComponent(Entity& entity, void* payload)
+		{
+			T& component = *static_cast<T*>(payload);
+			if (!entity.HasComponent<T>())
+			{
+				entity.AddComponent<T>(std::move(component));
+				return;
+			}
+			T& existing = entity.GetComponent<T>();
+			ReplaceComponent(existing, std::move(component));
+			existing.m_Entity = entity;
+		}
+
+		template<typename T>
+		static void ReplaceComponent(T& existing, T&& component) { existing = std::move(component); }
+		// Through the setters, the parent link and the dirty flags stay intact
+		static void ReplaceComponent(TransformComponent& existing, TransformComponent&& component);
+
+	private:
+		std::vector<Command> m_Commands;
+		uint32_t m_PendingEntityCount = 0;
+
+		// Payload memory, blocks are bump allocated and kept across Clear
+		std::vector<Scope<uint8_t[]>> m_Blocks;
+		uint32_t m_BlockIndex = 0;
+		size_t m_BlockOffset = 0;
+		// Payloads larger than a block, freed by Clear
+		std::vector<Scope<uint8_t[]>> m_LargePayloads;
+
+		// The entities of CreateEntity, filled during Playback
+		std::vector<Entity> m_CreatedEntities;
+	};
+}
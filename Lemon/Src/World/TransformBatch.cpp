@@ -0,0 +1,175 @@
+#include "LemonPCH.h"
+#include "TransformBatch.h"
+#include "Components/TransformComponent.h"
+#include "Core/JobSystem.h"
+#include "Math/SimdLanes.h"
+#include <cmath>
+
+namespace Lemon
+{
+	namespace
+	{
+		// One float of every transform in the group
+		using Lanes = SimdLanes;
+		using Float = Lanes::Float;
+
+		// Sine and cosine together, Cephes polynomials after reducing x to [-pi/4, pi/4] around the nearest multiple of pi/2.
+		// About 1e-7 absolute error for the angles of a transform
+		FORCEINLINE void SinCos(Float x, Float& outSin, Float& outCos)
+		{
+			const Lanes::Int quadrant = Lanes::ToInt(Lanes::Mul(x, Lanes::Splat(0.636619772367581343f)));
+			const Float k = Lanes::ToFloat(quadrant);
+			// pi/2 split in three so k * part stays exact
+			Float r = Lanes::Sub(x, Lanes::Mul(k, Lanes::Splat(1.5703125f)));
+			r = Lanes::Sub(r, Lanes::Mul(k, Lanes::Splat(4.837512969970703125e-4f)));
+			r = Lanes::Sub(r, Lanes::Mul(k, Lanes::Splat(7.54978995489188216e-8f)));
+
+			const Float r2 = Lanes::Mul(r, r);
+			Float sinPoly = Lanes::Add(Lanes::Mul(r2, Lanes::Splat(-1.9515295891e-4f)), Lanes::Splat(8.3321608736e-3f));
+			sinPoly = Lanes::Add(Lanes::Mul(r2, sinPoly), Lanes::Splat(-1.6666654611e-1f));
+			const Float sinR = Lanes::Add(r, Lanes::Mul(Lanes::Mul(r, r2), sinPoly));
+			Float cosPoly = Lanes::Add(Lanes::Mul(r2, Lanes::Splat(2.443315711809948e-5f)), Lanes::Splat(-1.388731625493765e-3f));
+			cosPoly = Lanes::Add(Lanes::Mul(r2, cosPoly), Lanes::Splat(4.166664568298827e-2f));
+			const Float cosR = Lanes::Add(Lanes::Sub(Lanes::Splat(1.0f), Lanes::Mul(r2, Lanes::Splat(0.5f))), Lanes::Mul(Lanes::Mul(r2, r2), cosPoly));
+
+			// Odd quadrants swap sine and cosine, the sign follows the quadrant
+			const Lanes::Mask swap = Lanes::HasBit(quadrant, 1);
+			const Float sinValue = Lanes::Select(swap, cosR, sinR);
+			const Float cosValue = Lanes::Select(swap, sinR, cosR);
+			const Float zero = Lanes::Splat(0.0f);
+			outSin = Lanes::Select(Lanes::HasBit(quadrant, 2), Lanes::Sub(zero, sinValue), sinValue);
+			outCos = Lanes::Select(Lanes::HasBit(Lanes::AddInt(quadrant, 1), 2), Lanes::Sub(zero, cosValue), cosValue);
+		}
+
+		// SoA copy of one group of transforms and its results
+		struct TransformLanes
+		{
+			// [component][lane]
+			alignas(32) float Position[3][Lanes::Count];
+			alignas(32) float Rotation[3][Lanes::Count];
+			alignas(32) float Scale[3][Lanes::Count];
+			// [column][row][lane] of the upper 3x4, the bottom row is always 0, 0, 0, 1
+			alignas(32) float LocalToWorld[4][3][Lanes::Count];
+			alignas(32) float WorldToLocal[4][3][Lanes::Count];
+		};
+
+		FORCEINLINE void ComputeLanes(TransformLanes& lanes)
+		{
+			// Degrees to half angle radians, like glm::quat(glm::radians(rotation))
+			const Float toHalfRadians = Lanes::Splat(0.00872664625997164788f);
+			Float sin[3];
+			Float cos[3];
+			for (uint32_t axis = 0; axis < 3; axis++)
+			{
+				SinCos(Lanes::Mul(Lanes::LoadAligned(lanes.Rotation[axis]), toHalfRadians), sin[axis], cos[axis]);
+			}
+
+			const Float cxcy = Lanes::Mul(cos[0], cos[1]);
+			const Float sxsy = Lanes::Mul(sin[0], sin[1]);
+			const Float sxcy = Lanes::Mul(sin[0], cos[1]);
+			const Float cxsy = Lanes::Mul(cos[0], sin[1]);
+			const Float qw = Lanes::Add(Lanes::Mul(cxcy, cos[2]), Lanes::Mul(sxsy, sin[2]));
+			const Float qx = Lanes::Sub(Lanes::Mul(sxcy, cos[2]), Lanes::Mul(cxsy, sin[2]));
+			const Float qy = Lanes::Add(Lanes::Mul(cxsy, cos[2]), Lanes::Mul(sxcy, sin[2]));
+			const Float qz = Lanes::Sub(Lanes::Mul(cxcy, sin[2]), Lanes::Mul(sxsy, cos[2]));
+
+			// glm::mat3_cast, rotation[column][row]
+			const Float one = Lanes::Splat(1.0f);
+			const Float two = Lanes::Splat(2.0f);
+			const Float qxx = Lanes::Mul(qx, qx), qyy = Lanes::Mul(qy, qy), qzz = Lanes::Mul(qz, qz);
+			const Float qxz = Lanes::Mul(qx, qz), qxy = Lanes::Mul(qx, qy), qyz = Lanes::Mul(qy, qz);
+			const Float qwx = Lanes::Mul(qw, qx), qwy = Lanes::Mul(qw, qy), qwz = Lanes::Mul(qw, qz);
+			const Float rotation[3][3] =
+			{
+				{ Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(qyy, qzz))), Lanes::Mul(two, Lanes::Add(qxy, qwz)), Lanes::Mul(two, Lanes::Sub(qxz, qwy)) },
+				{ Lanes::Mul(two, Lanes::Sub(qxy, qwz)), Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(qxx, qzz))), Lanes::Mul(two, Lanes::Add(qyz, qwx)) },
+				{ Lanes::Mul(two, Lanes::Add(qxz, qwy)), Lanes::Mul(two, Lanes::Sub(qyz, qwx)), Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(qxx, qyy))) },
+			};
+
+			const Float position[3] = { Lanes::LoadAligned(lanes.Position[0]), Lanes::LoadAligned(lanes.Position[1]), Lanes::LoadAligned(lanes.Position[2]) };
+			Float inverseTranslation[3] = { Lanes::Splat(0.0f), Lanes::Splat(0.0f), Lanes::Splat(0.0f) };
+			for (uint32_t column = 0; column < 3; column++)
+			{
+				const Float scale = Lanes::LoadAligned(lanes.Scale[column]);
+				const Float inverseScale = Lanes::Div(one, scale);
+				for (uint32_t row = 0; row < 3; row++)
+				{
+					// translate * rotate * scale scales the rotation columns
+					Lanes::StoreAligned(lanes.LocalToWorld[column][row], Lanes::Mul(rotation[column][row], scale));
+					// inverse(scale) * transpose(rotate) * inverse(translate)
+					const Float inverse = Lanes::Mul(rotation[column][row], inverseScale);
+					Lanes::StoreAligned(lanes.WorldToLocal[row][column], inverse);
+					inverseTranslation[column] = Lanes::Sub(inverseTranslation[column], Lanes::Mul(inverse, position[row]));
+				}
+				Lanes::StoreAligned(lanes.LocalToWorld[3][column], position[column]);
+				Lanes::StoreAligned(lanes.WorldToLocal[3][column], inverseTranslation[column]);
+			}
+		}
+	}
+
+	void TransformBatch::Update(const std::vector<TransformComponent*>& transforms, JobSystem* jobSystem)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		const uint32_t count = static_cast<uint32_t>(transforms.size());
+		TransformComponent* const* data = transforms.data();
+		if (jobSystem && count > GrainSize)
+		{
+			JobHandle handle = jobSystem->ParallelFor(count, GrainSize, [data](uint32_t begin, uint32_t end)
+				{
+					UpdateRange(data + begin, end - begin);
+				});
+			jobSystem->Wait(handle);
+		}
+		else
+		{
+			UpdateRange(data, count);
+		}
+	}
+
+	const char* TransformBatch::GetInstructionSetName()
+	{
+		return Lanes::Name();
+	}
+
+	void TransformBatch::UpdateRange(TransformComponent* const* transforms, uint32_t count)
+	{
+		static_assert(GrainSize % Lanes::Count == 0, "A parallel range must hold whole groups");
+
+		TransformLanes lanes;
+		for (uint32_t groupBegin = 0; groupBegin < count; groupBegin += Lanes::Count)
+		{
+			const uint32_t groupSize = (std::min)(Lanes::Count, count - groupBegin);
+			for (uint32_t lane = 0; lane < Lanes::Count; lane++)
+			{
+				// The lanes past the end compute an identity transform
+				const TransformComponent* transform = lane < groupSize ? transforms[groupBegin + lane] : nullptr;
+				for (uint32_t axis = 0; axis < 3; axis++)
+				{
+					lanes.Position[axis][lane] = transform ? transform->m_Position[axis] : 0.0f;
+					lanes.Rotation[axis][lane] = transform ? transform->m_Rotation[axis] : 0.0f;
+					lanes.Scale[axis][lane] = transform ? transform->m_Scale[axis] : 1.0f;
+				}
+			}
+
+			ComputeLanes(lanes);
+
+			for (uint32_t lane = 0; lane < groupSize; lane++)
+			{
+				const TransformComponent& transform = *transforms[groupBegin + lane];
+				for (uint32_t column = 0; column < 4; column++)
+				{
+					const float w = column == 3 ? 1.0f : 0.0f;
+					transform.m_LocalToWorld[column] = glm::vec4(lanes.LocalToWorld[column][0][lane], lanes.LocalToWorld[column][1][lane], lanes.LocalToWorld[column][2][lane], w);
+					transform.m_WorldToLocal[column] = glm::vec4(lanes.WorldToLocal[column][0][lane], lanes.WorldToLocal[column][1][lane], lanes.WorldToLocal[column][2][lane], w);
+					// Transposed, the translation ends up in the bottom row
+					transform.m_WorldToLocalTranspose[column] = column == 3
+						? glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)
+						: glm::vec4(lanes.WorldToLocal[0][column][lane], lanes.WorldToLocal[1][column][lane], lanes.WorldToLocal[2][column][lane], lanes.WorldToLocal[3][column][lane]);
+				}
+				transform.m_bDirty = false;
+				transform.m_MatrixVersion++;
+			}
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Core/Core.h"
+#include <vector>
+
+namespace Lemon
+{
+	class JobSystem;
+	class TransformComponent;
+
+	/**
+	 * Rebuilds the cached matrices of many TransformComponents at once.
+	 * Position/rotation/scale of a group of transforms (8 with AVX2, 4 with SSE2) are copied into SoA lanes,
+	 * the Euler to quaternion conversion, translate * rotate * scale and its inverse are computed for the whole
+	 * group, then the matrices are written back. The inverse uses the TRS structure instead of a general 4x4 inverse.
+	 * Results match TransformComponent::UpdateMatrices up to float rounding.
+	 */
+	class LEMON_API TransformBatch
+	{
+	public:
+		// Split across jobSystem in ranges of GrainSize when it is given and there are more than that.
+		// The transforms must not have a parent, their matrices are relative to the world
+		static void Update(const std::vector<TransformComponent*>& transforms, JobSystem* jobSystem);
+
+		// "AVX2", "SSE2" or "Scalar", fixed at compile time
+		static const char* GetInstructionSetName();
+
+		static constexpr uint32_t GrainSize = 1024;
+
+	private:
+		static void UpdateRange(TransformComponent* const* transforms, uint32_t count);
+	};
+}
@@ -0,0 +1,115 @@
+#include "LemonPCH.h"
+#include "TransformHierarchy.h"
+#include "Components/HierarchyComponent.h"
+#include "Components/TransformComponent.h"
+#include "Core/JobSystem.h"
+
+namespace Lemon
+{
+	void TransformHierarchy::Rebuild(entt::registry& registry)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		m_Entities.clear();
+		m_ParentIndices.clear();
+		m_LevelOffsets.clear();
+
+		auto view = registry.view<HierarchyComponent>();
+		for (const entt::entity entity : view)
+		{
+			if (view.get<HierarchyComponent>(entity).m_Parent == entt::null)
+			{
+				m_Entities.push_back(entity);
+				m_ParentIndices.push_back(InvalidIndex);
+			}
+		}
+
+		// Breadth first, the children of level i are appended as level i + 1
+		uint32_t levelBegin = 0;
+		while (levelBegin < m_Entities.size())
+		{
+			m_LevelOffsets.push_back(levelBegin);
+			const uint32_t levelEnd = static_cast<uint32_t>(m_Entities.size());
+			for (uint32_t i = levelBegin; i < levelEnd; i++)
+			{
+				HierarchyComponent& hierarchy = view.get<HierarchyComponent>(m_Entities[i]);
+				hierarchy.m_HierarchyIndex = i;
+				for (entt::entity child = hierarchy.m_FirstChild; child != entt::null; child = view.get<HierarchyComponent>(child).m_NextSibling)
+				{
+					m_Entities.push_back(child);
+					m_ParentIndices.push_back(i);
+				}
+			}
+			levelBegin = levelEnd;
+		}
+		m_LevelOffsets.push_back(levelBegin);
+
+		m_WorldMatrices.resize(m_Entities.size());
+		m_Dirty.assign(m_Entities.size(), 1);
+		m_bStructureChanged = false;
+	}
+
+	void TransformHierarchy::Update(entt::registry& registry, JobSystem* jobSystem)
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		if (m_bStructureChanged)
+		{
+			Rebuild(registry);
+		}
+
+		registry.view<TransformComponent, HierarchyComponent>().each([this](TransformComponent& transform, const HierarchyComponent& hierarchy)
+		{
+			if (transform.m_bMoved)
+			{
+				m_Dirty[hierarchy.m_HierarchyIndex] = 1;
+				transform.m_bMoved = false;
+			}
+		});
+
+		// Parents come first, one pass pushes the flags down every subtree
+		const uint32_t nodeCount = GetNodeCount();
+		for (uint32_t i = m_LevelOffsets.size() > 1 ? m_LevelOffsets[1] : nodeCount; i < nodeCount; i++)
+		{
+			m_Dirty[i] |= m_Dirty[m_ParentIndices[i]];
+		}
+
+		for (uint32_t level = 0; level < GetLevelCount(); level++)
+		{
+			const uint32_t begin = m_LevelOffsets[level];
+			const uint32_t end = m_LevelOffsets[level + 1];
+			if (jobSystem && end - begin > ParallelGrainSize)
+			{
+				JobHandle handle = jobSystem->ParallelFor(end - begin, ParallelGrainSize, [this, &registry, begin](uint32_t rangeBegin, uint32_t rangeEnd)
+					{
+						UpdateRange(registry, begin + rangeBegin, begin + rangeEnd);
+					});
+				jobSystem->Wait(handle);
+			}
+			else
+			{
+				UpdateRange(registry, begin, end);
+			}
+		}
+
+		std::fill(m_Dirty.begin(), m_Dirty.end(), 0);
+	}
+
+	void TransformHierarchy::UpdateRange(entt::registry& registry, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (!m_Dirty[i])
+			{
+				continue;
+			}
+
+			const TransformComponent& transform = registry.get<TransformComponent>(m_Entities[i]);
+			const uint32_t parentIndex = m_ParentIndices[i];
+			m_WorldMatrices[i] = parentIndex == InvalidIndex
+				? transform.GetLocalMatrix()
+				: m_WorldMatrices[parentIndex] * transform.GetLocalMatrix();
+			transform.SetLocalToWorldMatrix(m_WorldMatrices[i]);
+		}
+	}
+}
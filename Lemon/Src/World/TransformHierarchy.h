@@ -0,0 +1,50 @@
+#pragma once
+#include "Core/Core.h"
+#include <glm/glm.hpp>
+#include <entt/include/entt.hpp>
+#include <vector>
+
+namespace Lemon
+{
+	class JobSystem;
+
+	/**
+	 * World matrices of every entity with a HierarchyComponent, stored as parallel arrays in breadth first order:
+	 * the roots, then all their children, then the grandchildren... Each level only reads the level before it,
+	 * so the update walks the arrays front to back and the nodes of a level update in parallel.
+	 * A moved transform marks its slot dirty, the dirty flag is pushed down to its subtree before the update
+	 * and clean subtrees are skipped.
+	 */
+	class LEMON_API TransformHierarchy
+	{
+	public:
+		// An attach, detach or destroy happened, the next Update rebuilds the order
+		void MarkStructureChanged() { m_bStructureChanged = true; }
+
+		// Recomputes the world matrices of the moved transforms and their descendants.
+		// Levels larger than ParallelGrainSize are split across jobSystem, which may be null
+		void Update(entt::registry& registry, JobSystem* jobSystem);
+
+		uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Entities.size()); }
+		uint32_t GetLevelCount() const { return m_LevelOffsets.empty() ? 0 : static_cast<uint32_t>(m_LevelOffsets.size() - 1); }
+
+		static constexpr uint32_t ParallelGrainSize = 1024;
+
+	private:
+		void Rebuild(entt::registry& registry);
+		void UpdateRange(entt::registry& registry, uint32_t begin, uint32_t end);
+
+	private:
+		static constexpr uint32_t InvalidIndex = ~0u;
+
+		std::vector<entt::entity> m_Entities;
+		// Always a slot of an earlier level, InvalidIndex for roots
+		std::vector<uint32_t> m_ParentIndices;
+		std::vector<glm::mat4> m_WorldMatrices;
+		std::vector<uint8_t> m_Dirty;
+		// Level i is [m_LevelOffsets[i], m_LevelOffsets[i + 1])
+		std::vector<uint32_t> m_LevelOffsets;
+
+		bool m_bStructureChanged = true;
+	};
+}
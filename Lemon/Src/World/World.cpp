@@ -4,10 +4,14 @@
 #include "Components/CameraComponent.h"
 #include "Components/DirectionalLightComponent.h"
 #include "Components/EnvironmentComponent.h"
+#include "Components/HierarchyComponent.h"
+#include "Components/NameComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/TransformComponent.h"
 #include "Core/Engine.h"
+#include "Core/JobSystem.h"
 #include "Core/Timer.h"
+#include "RenderCore/Mesh.h"
 #include "entt/include/entt.hpp"
 #include "RenderCore/Geometry/Cube.h"
 #include "RenderCore/Geometry/Sphere.h"
@@ -19,25 +23,190 @@
 
 namespace Lemon
 {
+    namespace
+    {
+        // Index of the entity without its version, recycled handles share it
+        uint32_t GetEntityId(entt::entity entity)
+        {
+            return entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
+        }
+    }
+
     World::World(Engine* engine)
         :ISystem(engine)
     {
-		    
+		// Created before any component so the renderable pools stay sorted from the start
+		View<TransformComponent, StaticMeshComponent>();
+
+		m_Registry.on_destroy<TransformComponent>().connect<&World::OnRenderableDestroyed>(*this);
+		m_Registry.on_destroy<StaticMeshComponent>().connect<&World::OnRenderableDestroyed>(*this);
 	}
     
     Entity World::CreateEntity(const std::string& name, bool bIsGizmoDebug /*= false*/)
     {
-        Entity entity(m_Registry.create(), this, name);
+        LEMON_MEMORY_SCOPE(EntityStorage);
+        Entity entity(m_Registry.create(), this);
         entity.AddComponent<TransformComponent>();
+		if (!name.empty())
+		{
+			entity.AddComponent<NameComponent>(name);
+		}
 		entity.SetGizmo(bIsGizmoDebug);
+
+        const uint32_t entityId = GetEntityId(entity);
+        if (entityId >= m_EntityIndices.size())
+        {
+            m_EntityIndices.resize(entityId + 1);
+        }
+        m_EntityIndices[entityId] = static_cast<uint32_t>(m_Entitys.size());
         m_Entitys.emplace_back(entity);
         return entity;
     }
    
     void World::DestroyEntity(Entity& entity)
     {
-    	entity.MarkDestroy();
-        m_Registry.destroy(entity);
+        m_PendingDestroyEntitys.push_back(entity);
+    }
+
+    void World::DestroyPendingEntities()
+    {
+        if (m_PendingDestroyEntitys.empty())
+        {
+            return;
+        }
+
+        LEMON_PROFILE_FUNCTION();
+        LEMON_MEMORY_SCOPE(EntityStorage);
+        for (const entt::entity entity : m_PendingDestroyEntitys)
+        {
+            // Destroyed twice, or already with its parent
+            if (!m_Registry.valid(entity))
+            {
+                continue;
+            }
+
+            HierarchyComponent* hierarchy = m_Registry.try_get<HierarchyComponent>(entity);
+            if (!hierarchy)
+            {
+                RemoveFromEntityList(entity);
+                m_Registry.destroy(entity);
+                continue;
+            }
+
+            DetachFromParent(entity, *hierarchy);
+            // Collected first, destroying moves the components the links are read from
+            m_DestroySubtree.assign(1, entity);
+            for (size_t i = 0; i < m_DestroySubtree.size(); i++)
+            {
+                const HierarchyComponent& nodeHierarchy = m_Registry.get<HierarchyComponent>(m_DestroySubtree[i]);
+                for (entt::entity child = nodeHierarchy.m_FirstChild; child != entt::null; child = m_Registry.get<HierarchyComponent>(child).m_NextSibling)
+                {
+                    m_DestroySubtree.push_back(child);
+                }
+            }
+            for (const entt::entity node : m_DestroySubtree)
+            {
+                RemoveFromEntityList(node);
+            }
+            m_Registry.destroy(m_DestroySubtree.begin(), m_DestroySubtree.end());
+            m_TransformHierarchy.MarkStructureChanged();
+        }
+        m_PendingDestroyEntitys.clear();
+    }
+
+    void World::RemoveFromEntityList(entt::entity entity)
+    {
+        // Swap and pop, the last entity takes the freed slot
+        const uint32_t index = m_EntityIndices[GetEntityId(entity)];
+        LEMON_CORE_ASSERT(index < m_Entitys.size() && m_Entitys[index] == entity, "Entity is not in the world's list");
+        const Entity last = m_Entitys.back();
+        m_Entitys[index] = last;
+        m_EntityIndices[GetEntityId(last)] = index;
+        m_Entitys.pop_back();
+    }
+
+    void World::SetParent(Entity child, Entity parent)
+    {
+        LEMON_CORE_ASSERT(child, "Invalid child entity");
+        for (Entity ancestor = parent; ancestor; ancestor = GetParent(ancestor))
+        {
+            if (ancestor == child)
+            {
+                LEMON_CORE_WARN("Cannot attach {0} below its own descendant {1}", child.GetName(), parent.GetName());
+                return;
+            }
+        }
+
+        // Both exist before any reference is taken, adding one may move the other
+        if (!child.HasComponent<HierarchyComponent>())
+        {
+            child.AddComponent<HierarchyComponent>();
+        }
+        if (parent && !parent.HasComponent<HierarchyComponent>())
+        {
+            parent.AddComponent<HierarchyComponent>();
+        }
+
+        HierarchyComponent& hierarchy = m_Registry.get<HierarchyComponent>(child);
+        DetachFromParent(child, hierarchy);
+        if (parent)
+        {
+            HierarchyComponent& parentHierarchy = m_Registry.get<HierarchyComponent>(parent);
+            hierarchy.m_Parent = parent;
+            hierarchy.m_PrevSibling = parentHierarchy.m_LastChild;
+            if (parentHierarchy.m_LastChild != entt::null)
+            {
+                m_Registry.get<HierarchyComponent>(parentHierarchy.m_LastChild).m_NextSibling = child;
+            }
+            else
+            {
+                parentHierarchy.m_FirstChild = child;
+            }
+            parentHierarchy.m_LastChild = child;
+            parentHierarchy.m_ChildCount++;
+        }
+
+        TransformComponent& transform = m_Registry.get<TransformComponent>(child);
+        transform.m_bHasParent = static_cast<bool>(parent);
+        transform.MarkDirty();
+        m_TransformHierarchy.MarkStructureChanged();
+    }
+
+    Entity World::GetParent(Entity entity) const
+    {
+        const HierarchyComponent* hierarchy = m_Registry.try_get<HierarchyComponent>(entity);
+        return hierarchy ? hierarchy->GetParent() : Entity();
+    }
+
+    void World::DetachFromParent(entt::entity entity, HierarchyComponent& hierarchy)
+    {
+        if (hierarchy.m_Parent == entt::null)
+        {
+            return;
+        }
+
+        HierarchyComponent& parentHierarchy = m_Registry.get<HierarchyComponent>(hierarchy.m_Parent);
+        if (hierarchy.m_PrevSibling != entt::null)
+        {
+            m_Registry.get<HierarchyComponent>(hierarchy.m_PrevSibling).m_NextSibling = hierarchy.m_NextSibling;
+        }
+        else
+        {
+            parentHierarchy.m_FirstChild = hierarchy.m_NextSibling;
+        }
+        if (hierarchy.m_NextSibling != entt::null)
+        {
+            m_Registry.get<HierarchyComponent>(hierarchy.m_NextSibling).m_PrevSibling = hierarchy.m_PrevSibling;
+        }
+        else
+        {
+            parentHierarchy.m_LastChild = hierarchy.m_PrevSibling;
+        }
+        parentHierarchy.m_ChildCount--;
+
+        hierarchy.m_Parent = entt::null;
+        hierarchy.m_PrevSibling = entt::null;
+        hierarchy.m_NextSibling = entt::null;
     }
     
     bool World::Initialize()
@@ -56,7 +225,7 @@ namespace Lemon
 			bHasInitGeometry = true;
 			//Create Cube
 			Entity cube = CreateEntity("Cube1");
-			cube.GetComponent<TransformComponent>().Position = { 0, 0, 2.5 };
+			cube.GetComponent<TransformComponent>().SetPosition({ 0, 0, 2.5 });
 			//cube.GetComponent<TransformComponent>().Position = { 0, 0, 0.5 };
 			//cube.GetComponent<TransformComponent>().Rotation = { 20.0f, 0, 0 };
 
@@ -107,18 +276,31 @@ namespace Lemon
     	Entity directionalLightEntity = CreateEntity("DirectionalLight");
     	DirectionalLightComponent& directionalLightComp = directionalLightEntity.AddComponent<DirectionalLightComponent>();
 		TransformComponent& transformComp = directionalLightEntity.GetComponent<TransformComponent>();
-    	transformComp.Rotation = glm::vec3(0, 0, 45); // set light dir
+    	transformComp.SetRotation(glm::vec3(0, 0, 45)); // set light dir
     }
 	
     void World::Tick(float deltaTime)
 	{
-		InitRenderGeometry();
+		// The demo scene needs GPU resources
+		if (IsRHIAvailable())
+		{
+			InitRenderGeometry();
+		}
+
+		// Rendering interpolates between the previous and this step
+		if (GetEngine()->GetTimer()->IsFixedTimestep())
+		{
+			ParallelEach<TransformComponent>([](TransformComponent& transformComp) { transformComp.SavePreviousState(); });
+		}
 
         if(cubeEntity)
         {
-        	cubeEntity.GetComponent<TransformComponent>().Position.x = 5.0f * sin(0.4f * GetEngine()->GetTimer()->GetGameTime());
+        	TransformComponent& cubeTransform = cubeEntity.GetComponent<TransformComponent>();
+        	glm::vec3 cubePosition = cubeTransform.GetPosition();
+        	cubePosition.x = 5.0f * sin(0.4f * GetEngine()->GetTimer()->GetGameTime());
+        	cubeTransform.SetPosition(cubePosition);
         	
-            cubeEntity.GetComponent<TransformComponent>().Rotation += glm::vec3(0.0f, 0.0f, 0.1f);          
+            cubeTransform.SetRotation(cubeTransform.GetRotation() + glm::vec3(0.0f, 0.0f, 0.1f));
         }
 
 		if (MainCameraEntity)
@@ -131,17 +313,19 @@ namespace Lemon
 			glm::vec3 translation;
 			glm::vec3 scale;
 			GridGizmo::ComputeWorldAndScaleWithSnap(MainCameraEntity.GetComponent<CameraComponent>(), translation, scale);
-			GridGizmoEntity.GetComponent<TransformComponent>().Position = translation;
-			GridGizmoEntity.GetComponent<TransformComponent>().Scale = scale;
+			GridGizmoEntity.GetComponent<TransformComponent>().SetPosition(translation);
+			GridGizmoEntity.GetComponent<TransformComponent>().SetScale(scale);
 		}
 
+		// Queries of the next step and the renderer see this step's moves
+		UpdateTransforms();
     }
     
     void World::CreateMainCamera()
     {
 		MainCameraEntity = CreateEntity("MainCamera");
 		//MainCameraEntity.GetComponent<TransformComponent>().Rotation = glm::vec3(0, 180.0f, 0);
-		MainCameraEntity.GetComponent<TransformComponent>().Position = glm::vec3(10, 10, -20.0f);
+		MainCameraEntity.GetComponent<TransformComponent>().SetPosition(glm::vec3(10, 10, -20.0f));
         CameraComponent& camera = MainCameraEntity.AddComponent<CameraComponent>();
         camera.SetProjectionType(CameraComponent::ProjectionType::Perspective);
     }
@@ -197,60 +381,312 @@ namespace Lemon
     	
 	}
 
-    std::vector<Entity> World::GetAllEntities() const
-    {
-        return m_Entitys;
-    }
-
 	void World::EndOneFrame()
     {
-    	// remove the destroy entity in m_entitys
-	    for(auto iter = m_Entitys.begin(); iter != m_Entitys.end();)
-	    {
-		    if(iter->IsMarkDestroy())
-		    {
-		    	// STL erase iterator, the iterator the next element
-		    	m_Entitys.erase(iter);
-		    }
-	    	else
-		    {
-			    iter++;
-		    }
-	    }
-    	
+    	PlaybackCommandBuffers();
+    	// After rendering, nothing holds the frame's entity lists anymore
+    	DestroyPendingEntities();
+
+    	// A frame may run no fixed step, the renderer must not wait for the next one to see the frame's edits
+    	if (GetEngine()->GetTimer()->IsFixedTimestep())
+    	{
+    		UpdateTransforms();
+    	}
     }
 
+	void World::RunChunks(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& function)
+	{
+		JobSystem* jobSystem = GetEngine()->GetSystem<JobSystem>();
+		if (jobSystem && count > grainSize)
+		{
+			jobSystem->Wait(jobSystem->ParallelFor(count, grainSize, function));
+		}
+		else if (count > 0)
+		{
+			function(0, count);
+		}
+	}
+
+	EntityCommandBuffer& World::CreateCommandBuffer(uint32_t sortKey)
+	{
+		std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
+		Scope<EntityCommandBuffer> buffer;
+		if (m_FreeCommandBuffers.empty())
+		{
+			buffer = CreateScope<EntityCommandBuffer>();
+		}
+		else
+		{
+			buffer = std::move(m_FreeCommandBuffers.back());
+			m_FreeCommandBuffers.pop_back();
+		}
+		EntityCommandBuffer& result = *buffer;
+		m_CommandBuffers.push_back({ sortKey, std::move(buffer) });
+		return result;
+	}
+
+	void World::PlaybackCommandBuffers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
+			if (m_CommandBuffers.empty())
+			{
+				return;
+			}
+			// Buffers created during the playback wait for the next sync point
+			m_PlaybackCommandBuffers.swap(m_CommandBuffers);
+		}
+
+		LEMON_PROFILE_FUNCTION();
+		std::stable_sort(m_PlaybackCommandBuffers.begin(), m_PlaybackCommandBuffers.end(),
+			[](const QueuedCommandBuffer& a, const QueuedCommandBuffer& b) { return a.SortKey < b.SortKey; });
+		for (QueuedCommandBuffer& queued : m_PlaybackCommandBuffers)
+		{
+			queued.Buffer->Playback(*this);
+		}
+
+		std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
+		for (QueuedCommandBuffer& queued : m_PlaybackCommandBuffers)
+		{
+			m_FreeCommandBuffers.push_back(std::move(queued.Buffer));
+		}
+		m_PlaybackCommandBuffers.clear();
+	}
+
+	void World::UpdateTransforms()
+	{
+		LEMON_PROFILE_FUNCTION();
+		JobSystem* jobSystem = GetEngine()->GetSystem<JobSystem>();
+
+		m_DirtyTransforms.clear();
+		m_Registry.view<TransformComponent>(entt::exclude<HierarchyComponent>).each([this](TransformComponent& transform)
+		{
+			if (transform.IsDirty())
+			{
+				m_DirtyTransforms.push_back(&transform);
+			}
+		});
+		TransformBatch::Update(m_DirtyTransforms, jobSystem);
+
+		m_TransformHierarchy.Update(m_Registry, jobSystem);
+
+		UpdateSpatialTree();
+	}
+
+	const World::SpatialProxy& World::GetSpatialProxy(entt::entity entity) const
+	{
+		static const SpatialProxy emptyProxy;
+		const uint32_t entityId = GetEntityId(entity);
+		return entityId < m_SpatialProxies.size() ? m_SpatialProxies[entityId] : emptyProxy;
+	}
+
+	void World::UpdateSpatialTree()
+	{
+		LEMON_PROFILE_FUNCTION();
+
+		// Finding the moved meshes only reads, the tree updates after it are serial. Every chunk fills its own
+		// list, the lists keep their capacity across frames and are walked in chunk order so the tree is the same on any number of threads
+		auto view = View<TransformComponent, StaticMeshComponent>();
+		const uint32_t grainSize = AlignGrainSize(ParallelGrainSize);
+		const uint32_t numChunks = (GetIterationRange<TransformComponent, StaticMeshComponent>(view).second + grainSize - 1) / grainSize;
+		if (m_ChangedRenderables.size() < numChunks)
+		{
+			m_ChangedRenderables.resize(numChunks);
+		}
+
+		auto findChanged = [this](std::vector<entt::entity>& changed, entt::entity entity, const TransformComponent& transform, const StaticMeshComponent& staticMesh)
+		{
+			const SpatialProxy& proxy = GetSpatialProxy(entity);
+			const Mesh* mesh = staticMesh.GetRenderMesh().get();
+			if (mesh != proxy.RenderMesh || (mesh && (proxy.Node == DynamicAABBTree::NullNode || transform.GetMatrixVersion() != proxy.MatrixVersion)))
+			{
+				changed.push_back(entity);
+			}
+		};
+		ForEachChunk<TransformComponent, StaticMeshComponent>(view, grainSize, [this, &view, &findChanged](uint32_t chunk, const entt::entity* first, const entt::entity* last)
+		{
+			std::vector<entt::entity>& changed = m_ChangedRenderables[chunk];
+			changed.clear();
+			for (; first != last; ++first)
+			{
+				InvokeEach<TransformComponent, StaticMeshComponent>(view, *first, findChanged, changed);
+			}
+		});
+
+		for (uint32_t chunk = 0; chunk < numChunks; chunk++)
+		{
+			for (const entt::entity entity : m_ChangedRenderables[chunk])
+			{
+				UpdateSpatialProxy(entity);
+			}
+			m_ChangedRenderables[chunk].clear();
+		}
+
+		m_SpatialTree.RebalanceIfNeeded();
+	}
+
+	void World::UpdateSpatialProxy(entt::entity entity)
+	{
+		const uint32_t entityId = GetEntityId(entity);
+		if (entityId >= m_SpatialProxies.size())
+		{
+			m_SpatialProxies.resize(entityId + 1);
+		}
+		SpatialProxy& proxy = m_SpatialProxies[entityId];
+		proxy.RenderMesh = m_Registry.get<StaticMeshComponent>(entity).GetRenderMesh().get();
+		if (!proxy.RenderMesh || !proxy.RenderMesh->GetLocalBounds().IsValid())
+		{
+			if (proxy.Node != DynamicAABBTree::NullNode)
+			{
+				m_SpatialTree.DestroyProxy(proxy.Node);
+				proxy.Node = DynamicAABBTree::NullNode;
+			}
+			return;
+		}
+
+		const TransformComponent& transform = m_Registry.get<TransformComponent>(entity);
+		const AABB bounds = proxy.RenderMesh->GetLocalBounds().Transformed(transform.GetLocalToWorldMatrix());
+		proxy.MatrixVersion = transform.GetMatrixVersion();
+		if (proxy.Node == DynamicAABBTree::NullNode)
+		{
+			proxy.Node = m_SpatialTree.CreateProxy(bounds, entity);
+		}
+		else
+		{
+			m_SpatialTree.MoveProxy(proxy.Node, bounds, bounds.GetCenter() - proxy.Bounds.GetCenter());
+		}
+		proxy.Bounds = bounds;
+	}
+
+	void World::OnRenderableDestroyed(entt::registry& registry, entt::entity entity)
+	{
+		const uint32_t entityId = GetEntityId(entity);
+		if (entityId < m_SpatialProxies.size() && m_SpatialProxies[entityId].Node != DynamicAABBTree::NullNode)
+		{
+			m_SpatialTree.DestroyProxy(m_SpatialProxies[entityId].Node);
+		}
+		if (entityId < m_SpatialProxies.size())
+		{
+			m_SpatialProxies[entityId] = SpatialProxy();
+		}
+	}
+
+	bool World::ValidateSpatialTree() const
+	{
+		if (!m_SpatialTree.Validate())
+		{
+			return false;
+		}
+
+		bool bValid = true;
+		uint32_t proxyCount = 0;
+		m_Registry.view<const TransformComponent, const StaticMeshComponent>().each([this, &bValid, &proxyCount](entt::entity entity, const TransformComponent& transform, const StaticMeshComponent& staticMesh)
+		{
+			const Mesh* mesh = staticMesh.GetRenderMesh().get();
+			if (!bValid || !mesh || !mesh->GetLocalBounds().IsValid())
+			{
+				return;
+			}
+
+			const SpatialProxy& proxy = GetSpatialProxy(entity);
+			const AABB bounds = mesh->GetLocalBounds().Transformed(transform.GetLocalToWorldMatrix());
+			if (proxy.Node == DynamicAABBTree::NullNode || m_SpatialTree.GetEntity(proxy.Node) != entity
+				|| !m_SpatialTree.GetFatBounds(proxy.Node).Contains(bounds))
+			{
+				LEMON_CORE_ERROR("World: the spatial tree does not hold the bounds of entity {0}", GetEntityId(entity));
+				bValid = false;
+			}
+			proxyCount++;
+		});
+
+		if (bValid && proxyCount != m_SpatialTree.GetProxyCount())
+		{
+			LEMON_CORE_ERROR("World: {0} meshes but {1} spatial proxies", proxyCount, m_SpatialTree.GetProxyCount());
+			bValid = false;
+		}
+		return bValid;
+	}
+
+	Entity World::Raycast(const Ray& ray, float maxDistance /*= FLT_MAX*/, float* outDistance /*= nullptr*/)
+	{
+		entt::entity closest = entt::null;
+		m_SpatialTree.RayCast(ray, maxDistance, [this, &ray, &maxDistance, &closest](entt::entity entity, float)
+		{
+			float distance;
+			if (GetSpatialProxy(entity).Bounds.IntersectsRay(ray, maxDistance, distance))
+			{
+				// Only nearer hits are of interest from here on
+				maxDistance = distance;
+				closest = entity;
+			}
+			return maxDistance;
+		});
+
+		if (outDistance && closest != entt::null)
+		{
+			*outDistance = maxDistance;
+		}
+		return closest != entt::null ? Entity(closest, this) : Entity();
+	}
+
 	//////////////////////////////////////////////////////////////////////////
 #include <sstream>
 	void World::CreateTestSphere()
 	{
-		float metallic = 0.0f;
-		float roughness = 0.0f;
+		constexpr uint32_t rowCount = 10;
+		constexpr uint32_t columnCount = 10;
 		glm::vec3 position = glm::vec3(0, 0, 0);
-		for (int i = 0; i < 10; i++)
+		std::vector<Ref<Mesh>> sphereMeshes(rowCount * columnCount);
+
+		// One job per row builds the geometry and records the entities, keyed by the row so they are created in loop order
+		auto buildRows = [this, &sphereMeshes, position](uint32_t begin, uint32_t end)
 		{
-			metallic = i * 0.1f;
-			for (int j = 0; j < 10; j++)
+			for (uint32_t i = begin; i < end; i++)
 			{
-				roughness = j * 0.1f;
-
-				std::stringstream ss;
-				ss << "metallic" << metallic << "roughness" << roughness;
-				Entity sphere = CreateEntity("Sphere" + ss.str());
-				
-				StaticMeshComponent& staticMesh2 = sphere.AddComponent<StaticMeshComponent>();
-				TransformComponent& transformComp = sphere.GetComponent<TransformComponent>();
-				transformComp.Position = position + glm::vec3(i * 2, 0.0f, 0.0f) + glm::vec3(0.0f, j * 2, 0);
-				Ref<Mesh> sphereMesh = CreateRef<Sphere>();
-				staticMesh2.SetMesh(sphereMesh);
-				Ref<Material> renderMaterial = CreateRef<Material>();
-				renderMaterial->Metallic = metallic;
-				renderMaterial->Roughness = roughness;
-				sphereMesh->SetMaterial(renderMaterial);
-				//staticMesh2.SetVisiable(false);
+				EntityCommandBuffer& commandBuffer = CreateCommandBuffer(i);
+				const float metallic = i * 0.1f;
+				for (uint32_t j = 0; j < columnCount; j++)
+				{
+					const float roughness = j * 0.1f;
+
+					std::stringstream ss;
+					ss << "metallic" << metallic << "roughness" << roughness;
+					EntityCommandBuffer::PendingEntity sphere = commandBuffer.CreateEntity("Sphere" + ss.str());
+
+					// Shaders and RHI buffers are created on the main thread below
+					Ref<Mesh> sphereMesh = CreateRef<Sphere>(1.0f, false);
+					Ref<Material> renderMaterial = CreateRef<Material>();
+					renderMaterial->Metallic = metallic;
+					renderMaterial->Roughness = roughness;
+					sphereMesh->SetMaterial(renderMaterial);
+					sphereMeshes[i * columnCount + j] = sphereMesh;
+
+					StaticMeshComponent staticMesh;
+					staticMesh.SetMesh(sphereMesh);
+					//staticMesh.SetVisiable(false);
+					commandBuffer.AddComponent<StaticMeshComponent>(sphere, std::move(staticMesh));
+					commandBuffer.AddComponent<TransformComponent>(sphere, position + glm::vec3(i * 2.0f, 0.0f, 0.0f) + glm::vec3(0.0f, j * 2.0f, 0));
+				}
 			}
+		};
+
+		JobSystem* jobSystem = GetEngine()->GetSystem<JobSystem>();
+		if (jobSystem)
+		{
+			jobSystem->Wait(jobSystem->ParallelFor(rowCount, 1, buildRows));
+		}
+		else
+		{
+			buildRows(0, rowCount);
+		}
+		PlaybackCommandBuffers();
+
+		for (const Ref<Mesh>& sphereMesh : sphereMeshes)
+		{
+			sphereMesh->CreateShader<SF_Vertex>("Assets/Shaders/SimpleStandardVertex.hlsl", "MainVS");
+			sphereMesh->CreateShader<SF_Pixel>("Assets/Shaders/SimpleStandardPixel.hlsl", "MainPS");
+			sphereMesh->CreateRHIBuffers();
 		}
-		
 	}
 
 }
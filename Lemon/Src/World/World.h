@@ -1,12 +1,25 @@
 #pragma once
 #include "Core/Core.h"
 #include "Core/ISystem.h"
+#include "Core/FrameAllocator.h"
 #include <entt/include/entt.hpp>
+#include "DynamicAABBTree.h"
 #include "Entity.h"
+#include "EntityCommandBuffer.h"
+#include "TransformBatch.h"
+#include "TransformHierarchy.h"
 #include "RenderCore/RenderCore.h"
+#include <functional>
+#include <mutex>
 
 namespace Lemon
 {
+    class TransformComponent;
+    class StaticMeshComponent;
+    class HierarchyComponent;
+
+    class Mesh;
+
     class LEMON_API World : public ISystem
     {
         friend class Entity;
@@ -16,17 +29,233 @@ namespace Lemon
         
         bool Initialize() override;
         void Tick(float deltaTime) override;
+        EMemoryTag GetMemoryTag() const override { return EMemoryTag::World; }
 
     	void EndOneFrame();
+    	// Rebuilds the cached matrices of the transforms changed since the last call, the spatial tree follows the moved meshes.
+    	// Tick calls it after every simulation step, so rendering and headless runs see the final state of the frame.
+    	// EndOneFrame calls it for fixed steps, edits made between steps are in place for the next frame
+    	void UpdateTransforms();
 
         Entity CreateEntity(const std::string& name = std::string(), bool bIsGizmoDebug = false);
+		// Queued, the entity stays valid until EndOneFrame destroys it together with its children.
+		// Lists built during the frame, like the renderer's, never see a destroyed handle
 		void DestroyEntity(Entity& entity);
+
+        //====Hierarchy====//
+        // Attaches child below parent, its position/rotation/scale become relative to parent.
+        // A null parent makes it a root again. Attaching below its own descendant is refused
+        void SetParent(Entity child, Entity parent);
+        Entity GetParent(Entity entity) const;
+        const TransformHierarchy& GetTransformHierarchy() const { return m_TransformHierarchy; }
+
+        //====Spatial queries====//
+        // Over the world bounds of the entities with a StaticMeshComponent as of the last UpdateTransforms.
+        // Queries made during Tick see the bounds at the end of the previous step, not the moves of the current one
+        // fn(Entity) returns false to stop the query
+        template<typename Fn>
+        void QueryFrustum(const Frustum& frustum, Fn&& fn)
+        {
+            m_SpatialTree.QueryFrustum(frustum, [this, &frustum, &fn](entt::entity entity)
+            {
+                return !frustum.Intersects(GetSpatialProxy(entity).Bounds) || fn(Entity(entity, this));
+            });
+        }
+        template<typename Fn>
+        void QueryAABB(const AABB& bounds, Fn&& fn)
+        {
+            m_SpatialTree.QueryAABB(bounds, [this, &bounds, &fn](entt::entity entity)
+            {
+                return !bounds.Overlaps(GetSpatialProxy(entity).Bounds) || fn(Entity(entity, this));
+            });
+        }
+        // Nearest entity whose bounds the ray hits within maxDistance, a null Entity when there is none
+        Entity Raycast(const Ray& ray, float maxDistance = FLT_MAX, float* outDistance = nullptr);
+        const DynamicAABBTree& GetSpatialTree() const { return m_SpatialTree; }
+        // DynamicAABBTree::Validate, and every mesh has a proxy whose fat box holds its current world bounds.
+        // Right after UpdateTransforms, logs the first problem and returns false
+        bool ValidateSpatialTree() const;
+
+        //====Command buffers====//
+        // A buffer for one job to record structural changes into, thread safe. The buffers are played back
+        // in sortKey order, give every job its own key (e.g. the begin of its range) so the result does not
+        // depend on which thread ran first
+        EntityCommandBuffer& CreateCommandBuffer(uint32_t sortKey);
+        // Sync point, main thread only: plays back every buffer created so far. EndOneFrame calls it too
+        void PlaybackCommandBuffers();
         
         Entity GetMainCamera() const { return MainCameraEntity; }
 		Entity GetMainEnvironment() const { return MainEnvironmentEntity; }
                 
-        std::vector<Entity> GetAllEntities() const;
+        // Every living entity in no particular order, destroyed ones leave at EndOneFrame. Not a copy, CreateEntity invalidates it
+        const std::vector<Entity>& GetAllEntities() const { return m_Entitys; }
+
+        //====Iteration====//
+        // Calls fn for every entity that has all Components, without copying or allocating.
+        // fn takes the components by reference, optionally after the entt::entity:
+        //  world.Each<TransformComponent, StaticMeshComponent>([](entt::entity entity, TransformComponent& transform, StaticMeshComponent& staticMesh) {});
+        // Components must not be added or removed during the iteration
+        template<typename... Components, typename Fn>
+        void Each(Fn&& fn)
+        {
+            View<Components...>().each(std::forward<Fn>(fn));
+        }
+
+        // Range of the entities that have all Components, view.get<T>(entity) fetches a component:
+        //  for (entt::entity entity : world.View<CameraComponent>())
+        // <TransformComponent, StaticMeshComponent> is an owning group, its components are packed at the front of their pools
+        template<typename... Components>
+        auto View()
+        {
+            if constexpr (std::is_same_v<entt::type_list<Components...>, RenderableComponents>)
+            {
+                return m_Registry.template group<Components...>();
+            }
+            else
+            {
+                return m_Registry.template view<Components...>();
+            }
+        }
+
+        //====Parallel iteration====//
+        static constexpr uint32_t ParallelGrainSize = 1024;
+        // Chunks start on a cache line of the packed entity and component arrays
+        static constexpr uint32_t ChunkAlignment = 64 / sizeof(entt::entity);
+
+        // Each, split into chunks of grainSize entities that run on the JobSystem. A view with a single chunk runs inline.
+        // fn is called from worker threads, it may only write the components it is given, PerThread scratch
+        // or data of its own entity. Main thread only, components must not be added or removed meanwhile:
+        //  world.ParallelEach<TransformComponent>([](TransformComponent& transform) { transform.SavePreviousState(); });
+        template<typename... Components, typename Fn>
+        void ParallelEach(Fn&& fn, uint32_t grainSize = ParallelGrainSize)
+        {
+            auto view = View<Components...>();
+            ForEachChunk<Components...>(view, grainSize, [&view, &fn](uint32_t, const entt::entity* first, const entt::entity* last)
+            {
+                for (; first != last; ++first)
+                {
+                    InvokeEach<Components...>(view, *first, fn);
+                }
+            });
+        }
+
+        // ParallelEach that folds into a value. Every chunk starts from identity and fn(T& partial, [entity,] components&...)
+        // accumulates into it, combine(T& result, T& partial) then merges the chunks in order on the calling thread.
+        // The chunks only depend on grainSize, so the result is the same on any number of threads, float sums included
+        template<typename... Components, typename T, typename Fn, typename CombineFn>
+        T ParallelReduce(const T& identity, Fn&& fn, CombineFn&& combine, uint32_t grainSize = ParallelGrainSize)
+        {
+            struct alignas(64) Partial
+            {
+                T Value;
+            };
+            auto view = View<Components...>();
+            const uint32_t alignedGrainSize = AlignGrainSize(grainSize);
+            std::vector<Partial> partials((GetIterationRange<Components...>(view).second + alignedGrainSize - 1) / alignedGrainSize, Partial{ identity });
+            ForEachChunk<Components...>(view, grainSize, [&view, &fn, &partials](uint32_t chunk, const entt::entity* first, const entt::entity* last)
+            {
+                T& partial = partials[chunk].Value;
+                for (; first != last; ++first)
+                {
+                    InvokeEach<Components...>(view, *first, fn, partial);
+                }
+            });
+
+            T result = identity;
+            for (Partial& partial : partials)
+            {
+                combine(result, partial.Value);
+            }
+            return result;
+        }
     private:
+        // Exactly this order selects the owning group
+        using RenderableComponents = entt::type_list<TransformComponent, StaticMeshComponent>;
+
+        // Packed entities a view iterates over: a group's own, otherwise the smallest pool, filtered by InvokeEach
+        template<typename... Components, typename ViewType>
+        std::pair<const entt::entity*, uint32_t> GetIterationRange(const ViewType& view)
+        {
+            if constexpr (sizeof...(Components) == 1 || std::is_same_v<entt::type_list<Components...>, RenderableComponents>)
+            {
+                return { view.data(), static_cast<uint32_t>(view.size()) };
+            }
+            else
+            {
+                std::pair<const entt::entity*, uint32_t> range = { nullptr, ~0u };
+                auto consider = [&range](const auto& pool)
+                {
+                    if (pool.size() < range.second)
+                    {
+                        range = { pool.data(), static_cast<uint32_t>(pool.size()) };
+                    }
+                };
+                (consider(m_Registry.template view<Components>()), ...);
+                return range;
+            }
+        }
+
+        static uint32_t AlignGrainSize(uint32_t grainSize)
+        {
+            return (std::max)((grainSize + ChunkAlignment - 1) / ChunkAlignment * ChunkAlignment, ChunkAlignment);
+        }
+
+        // chunkFn(chunk index, first, last) for every chunk of the iteration range
+        template<typename... Components, typename ViewType, typename ChunkFn>
+        void ForEachChunk(const ViewType& view, uint32_t grainSize, ChunkFn&& chunkFn)
+        {
+            const std::pair<const entt::entity*, uint32_t> range = GetIterationRange<Components...>(view);
+            const entt::entity* entities = range.first;
+            grainSize = AlignGrainSize(grainSize);
+            RunChunks(range.second, grainSize, [&](uint32_t begin, uint32_t end)
+            {
+                chunkFn(begin / grainSize, entities + begin, entities + end);
+            });
+        }
+
+        // fn([prefix...,] [entity,] components&...)
+        template<typename... Components, typename ViewType, typename Fn, typename... Prefix>
+        static void InvokeEach(const ViewType& view, entt::entity entity, Fn& fn, Prefix&... prefix)
+        {
+            if constexpr (sizeof...(Components) > 1 && !std::is_same_v<entt::type_list<Components...>, RenderableComponents>)
+            {
+                if (!view.contains(entity))
+                {
+                    return;
+                }
+            }
+            if constexpr (std::is_invocable_v<Fn&, Prefix&..., entt::entity, Components&...>)
+            {
+                fn(prefix..., entity, view.template get<Components>(entity)...);
+            }
+            else
+            {
+                fn(prefix..., view.template get<Components>(entity)...);
+            }
+        }
+
+        // ParallelFor on the JobSystem when there is more than one range, inline otherwise
+        void RunChunks(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& function);
+    private:
+        struct SpatialProxy
+        {
+            uint32_t Node = DynamicAABBTree::NullNode;
+            // State the tree node was built from, the node is refit when it changes
+            uint32_t MatrixVersion = 0;
+            const Mesh* RenderMesh = nullptr;
+            // Tight world bounds
+            AABB Bounds;
+        };
+        const SpatialProxy& GetSpatialProxy(entt::entity entity) const;
+        void UpdateSpatialTree();
+        // Creates, refits or removes the tree node of a renderable
+        void UpdateSpatialProxy(entt::entity entity);
+        void OnRenderableDestroyed(entt::registry& registry, entt::entity entity);
+
+        void DetachFromParent(entt::entity entity, HierarchyComponent& hierarchy);
+        void DestroyPendingEntities();
+        void RemoveFromEntityList(entt::entity entity);
+
         void CreateMainCamera();
 		void CreateEnvironment(float SkySphereRadius = 1000.0f);
 
@@ -44,6 +273,32 @@ namespace Lemon
 		Entity MainEnvironmentEntity;
 
         std::vector<Entity> m_Entitys;
+        // Slot of every entity in m_Entitys, indexed by the entity id
+        std::vector<uint32_t> m_EntityIndices;
+        // Destroyed by EndOneFrame
+        std::vector<entt::entity> m_PendingDestroyEntitys;
+        std::vector<entt::entity> m_DestroySubtree;
+
+        TransformHierarchy m_TransformHierarchy;
+
+        DynamicAABBTree m_SpatialTree;
+        // Indexed by the entity id
+        std::vector<SpatialProxy> m_SpatialProxies;
+        // Scratch of UpdateSpatialTree, one list per chunk
+        std::vector<std::vector<entt::entity>> m_ChangedRenderables;
+
+        struct QueuedCommandBuffer
+        {
+            uint32_t SortKey;
+            Scope<EntityCommandBuffer> Buffer;
+        };
+        std::mutex m_CommandBufferMutex;
+        std::vector<QueuedCommandBuffer> m_CommandBuffers;
+        std::vector<QueuedCommandBuffer> m_PlaybackCommandBuffers;
+        // Played back, kept to reuse their memory
+        std::vector<Scope<EntityCommandBuffer>> m_FreeCommandBuffers;
+        // Scratch of UpdateTransforms, kept to reuse its capacity
+        std::vector<TransformComponent*> m_DirtyTransforms;
 
         std::vector<Entity> m_EnvironmentEntitys;
 
@@ -0,0 +1,35 @@
+#include "Benchmarks.h"
+#include "Core/Core.h"
+#include "Core/Engine.h"
+#include "RHI/DynamicRHI.h"
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	static Scope<Engine> s_Engine;
+
+	Engine& GetBenchEngine()
+	{
+		if (!s_Engine)
+		{
+			RHISetBackend(ERHIBackend::Null);
+
+			WindowData windowData;
+			windowData.Width = 1280;
+			windowData.Height = 720;
+			s_Engine = CreateScope<Engine>(windowData);
+
+			// The first frame creates the demo scene and precomputes IBL, keep that out of the measurements
+			s_Engine->BeginOneFrame();
+			s_Engine->Tick();
+			s_Engine->EndOneFrame();
+		}
+		return *s_Engine;
+	}
+
+	void ShutdownBenchEngine()
+	{
+		s_Engine = nullptr;
+	}
+}
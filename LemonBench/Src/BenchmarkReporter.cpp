@@ -0,0 +1,101 @@
+#include "Benchmarks.h"
+
+#include <thread>
+
+namespace LemonBench
+{
+	static std::vector<BenchmarkResult>& GetResults()
+	{
+		static std::vector<BenchmarkResult> results;
+		return results;
+	}
+
+	static uint32_t& GetFailures()
+	{
+		static uint32_t failures = 0;
+		return failures;
+	}
+
+	static const char* GetBuildConfig()
+	{
+#if defined(LEMON_DEBUG)
+		return "Debug";
+#elif defined(LEMON_RELEASE)
+		return "Release";
+#elif defined(LEMON_SHIPPING)
+		return "Shipping";
+#else
+		return "Unknown";
+#endif
+	}
+
+	static std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		escaped.reserve(text.size());
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	void BenchmarkReporter::Report(const BenchmarkResult& result)
+	{
+		GetResults().push_back(result);
+	}
+
+	void BenchmarkReporter::Report(const std::string& name, double value, const char* unit)
+	{
+		Report(MakeResult(name, unit, 1, { value }));
+	}
+
+	void BenchmarkReporter::PrintResult(const BenchmarkResult& result)
+	{
+		printf("%-40s median %12.2f %-2s  min %12.2f  max %12.2f\n", result.Name.c_str(),
+			result.Median, result.Unit.c_str(), result.Min, result.Max);
+	}
+
+	void BenchmarkReporter::ReportFailure(const std::string& name, const std::string& message)
+	{
+		printf("FAILED %s: %s\n", name.c_str(), message.c_str());
+		GetFailures()++;
+	}
+
+	uint32_t BenchmarkReporter::GetFailureCount()
+	{
+		return GetFailures();
+	}
+
+	bool BenchmarkReporter::WriteJson(const char* filePath)
+	{
+		FILE* file = fopen(filePath, "w");
+		if (!file)
+		{
+			printf("Could not write %s\n", filePath);
+			return false;
+		}
+
+		fprintf(file, "{\n");
+		fprintf(file, "  \"version\": 1,\n");
+		fprintf(file, "  \"config\": \"%s\",\n", GetBuildConfig());
+		fprintf(file, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+		fprintf(file, "  \"results\": [\n");
+		const std::vector<BenchmarkResult>& results = GetResults();
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const BenchmarkResult& result = results[i];
+			fprintf(file, "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, \"mean\": %.4f, \"median\": %.4f, \"min\": %.4f, \"max\": %.4f}%s\n",
+				EscapeJson(result.Name).c_str(), EscapeJson(result.Unit).c_str(), static_cast<unsigned long long>(result.Iterations),
+				result.Mean, result.Median, result.Min, result.Max, i + 1 < results.size() ? "," : "");
+		}
+		fprintf(file, "  ]\n");
+		fprintf(file, "}\n");
+		fclose(file);
+		return true;
+	}
+}
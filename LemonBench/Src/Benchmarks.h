@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Lemon
+{
+	class Engine;
+}
+
+namespace LemonBench
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	inline double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Keeps the compiler from dropping a result that is never read
+	template<typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+		(void)sink;
+#endif
+	}
+
+	//====Results====//
+	// One tracked number. Names are stable ("Group.Case/Param") so runs of different builds can be diffed
+	struct BenchmarkResult
+	{
+		std::string Name;
+		std::string Unit;
+		uint64_t Iterations = 0;
+		double Mean = 0.0;
+		double Median = 0.0;
+		double Min = 0.0;
+		double Max = 0.0;
+	};
+
+	// Statistics over the samples, each sample already in unit
+	inline BenchmarkResult MakeResult(const std::string& name, const char* unit, uint64_t iterations, std::vector<double> samples)
+	{
+		BenchmarkResult result;
+		result.Name = name;
+		result.Unit = unit;
+		result.Iterations = iterations;
+		if (samples.empty())
+		{
+			return result;
+		}
+
+		std::sort(samples.begin(), samples.end());
+		double sum = 0.0;
+		for (double sample : samples)
+		{
+			sum += sample;
+		}
+		result.Mean = sum / samples.size();
+		result.Median = samples[samples.size() / 2];
+		result.Min = samples.front();
+		result.Max = samples.back();
+		return result;
+	}
+
+	// Collects every result of the run, main writes them out as JSON at the end
+	class BenchmarkReporter
+	{
+	public:
+		static void Report(const BenchmarkResult& result);
+		// A single measured value, e.g. a speedup
+		static void Report(const std::string& name, double value, const char* unit);
+
+		static void PrintResult(const BenchmarkResult& result);
+		static bool WriteJson(const char* filePath);
+
+		// A result checked against a reference was wrong, the run exits with an error
+		static void ReportFailure(const std::string& name, const std::string& message);
+		static uint32_t GetFailureCount();
+	};
+
+	//====Harness====//
+	constexpr uint32_t DefaultSamples = 10;
+
+	// Times `samples` batches of `iterations` calls fn(i), after one warm up batch. Reported in ns per call.
+	// setup runs untimed before every batch, e.g. to refill what the previous batch consumed
+	template<typename Setup, typename Fn>
+	BenchmarkResult MeasureWithSetup(const std::string& name, uint32_t iterations, Setup&& setup, Fn&& fn, uint32_t samples = DefaultSamples)
+	{
+		std::vector<double> nsPerCall;
+		nsPerCall.reserve(samples);
+		for (uint32_t sample = 0; sample <= samples; sample++)
+		{
+			setup();
+			auto start = Clock::now();
+			for (uint32_t i = 0; i < iterations; i++)
+			{
+				fn(i);
+			}
+			const double ms = ElapsedMs(start);
+			if (sample > 0)
+			{
+				nsPerCall.push_back(ms * 1000000.0 / iterations);
+			}
+		}
+
+		BenchmarkResult result = MakeResult(name, "ns", static_cast<uint64_t>(iterations) * samples, std::move(nsPerCall));
+		BenchmarkReporter::Report(result);
+		BenchmarkReporter::PrintResult(result);
+		return result;
+	}
+
+	template<typename Fn>
+	BenchmarkResult Measure(const std::string& name, uint32_t iterations, Fn&& fn, uint32_t samples = DefaultSamples)
+	{
+		return MeasureWithSetup(name, iterations, []() {}, std::forward<Fn>(fn), samples);
+	}
+
+	//====Engine====//
+	// Headless engine on the Null RHI shared by the engine benchmarks, so every platform measures the same CPU work
+	Lemon::Engine& GetBenchEngine();
+	void ShutdownBenchEngine();
+
+	//====Benchmarks====//
+	void RunJobSystemBenchmarks();
+	void RunSystemManagerBenchmarks();
+	void RunLoggingBenchmarks();
+	void RunTransformBenchmarks();
+	void RunMeshBenchmarks();
+	void RunImageImporterBenchmarks();
+	void RunWorldBenchmarks();
+	void RunSceneBenchmarks();
+}
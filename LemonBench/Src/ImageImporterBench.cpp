@@ -0,0 +1,79 @@
+#include "Benchmarks.h"
+#ifdef LEMON_PLATFORM_WINDOW
+	// Lemon is built with Windows.h in its PCH, which renames LoadImage. Match it or the call does not link
+	#include <Windows.h>
+#endif
+#include "Resources/Importer/ImageImporter.h"
+
+#include <filesystem>
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	// Uncompressed 32 bit TGA with a gradient, so the benchmark does not depend on the asset folder
+	static std::string WriteTestImage(uint32_t size)
+	{
+		const std::string filePath = (std::filesystem::temp_directory_path() / ("LemonBench_" + std::to_string(size) + ".tga")).string();
+		FILE* file = fopen(filePath.c_str(), "wb");
+		if (!file)
+		{
+			return std::string();
+		}
+
+		uint8_t header[18] = {};
+		header[2] = 2; // uncompressed true color
+		header[12] = static_cast<uint8_t>(size & 0xFF);
+		header[13] = static_cast<uint8_t>(size >> 8);
+		header[14] = static_cast<uint8_t>(size & 0xFF);
+		header[15] = static_cast<uint8_t>(size >> 8);
+		header[16] = 32;
+		header[17] = 0x28; // 8 alpha bits, top left origin
+		fwrite(header, 1, sizeof(header), file);
+
+		std::vector<uint8_t> row(size * 4);
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				row[x * 4 + 0] = static_cast<uint8_t>(x);
+				row[x * 4 + 1] = static_cast<uint8_t>(y);
+				row[x * 4 + 2] = static_cast<uint8_t>(x ^ y);
+				row[x * 4 + 3] = 255;
+			}
+			fwrite(row.data(), 1, row.size(), file);
+		}
+		fclose(file);
+		return filePath;
+	}
+
+	static void BenchLoadImage(ImageImporter& importer, uint32_t size, uint32_t iterations)
+	{
+		const std::string filePath = WriteTestImage(size);
+		if (filePath.empty())
+		{
+			printf("Could not write the %u test image, skipping\n", size);
+			return;
+		}
+
+		Measure("ImageImporter.LoadImage/TGA" + std::to_string(size), iterations, [&importer, &filePath](uint32_t)
+		{
+			// Every call appends a mip, start from an empty texture like EnvironmentComponent does
+			TextureInfoData textureInfoData;
+			importer.LoadImage(filePath, textureInfoData);
+			DoNotOptimize(textureInfoData);
+		}, 5);
+
+		std::error_code error;
+		std::filesystem::remove(filePath, error);
+	}
+
+	void RunImageImporterBenchmarks()
+	{
+		printf("==== ImageImporter ====\n");
+
+		ImageImporter importer(nullptr);
+		BenchLoadImage(importer, 256, 50);
+		BenchLoadImage(importer, 1024, 10);
+	}
+}
@@ -0,0 +1,117 @@
+#include "Benchmarks.h"
+#include "Core/JobSystem.h"
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	static void PrintStats(const char* name, uint64_t jobs, double ms, const JobSystemStats& stats)
+	{
+		printf("%-28s %10llu jobs %9.2f ms %12.0f jobs/s  steals %llu/%llu (%.1f%%)\n", name,
+			static_cast<unsigned long long>(jobs), ms, jobs / (ms * 0.001),
+			static_cast<unsigned long long>(stats.StealSuccesses), static_cast<unsigned long long>(stats.StealAttempts),
+			stats.GetStealSuccessRate() * 100.0);
+	}
+
+	// Many tiny independent jobs, measures scheduling overhead
+	static void BenchEmptyJobs(JobSystem& jobSystem)
+	{
+		constexpr uint32_t batchSize = 2048;
+		constexpr uint32_t batches = 200;
+
+		jobSystem.ResetStats();
+		std::vector<JobHandle> handles(batchSize);
+		auto start = Clock::now();
+		for (uint32_t batch = 0; batch < batches; batch++)
+		{
+			for (uint32_t i = 0; i < batchSize; i++)
+			{
+				handles[i] = jobSystem.Schedule([]() {});
+			}
+			for (const JobHandle& handle : handles)
+			{
+				jobSystem.Wait(handle);
+			}
+		}
+		const double ms = ElapsedMs(start);
+		PrintStats("Schedule (empty)", static_cast<uint64_t>(batchSize) * batches, ms, jobSystem.GetStats());
+		BenchmarkReporter::Report("JobSystem.ScheduleEmpty", ms * 1000000.0 / (static_cast<double>(batchSize) * batches), "ns");
+	}
+
+	// ParallelFor over a math heavy loop, compared against a single thread
+	static void BenchParallelFor(JobSystem& jobSystem)
+	{
+		constexpr uint32_t count = 1 << 22;
+		constexpr uint32_t grainSize = 4096;
+		std::vector<float> data(count, 1.0f);
+
+		auto kernel = [&data](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				data[i] = std::sqrt(data[i] * 1.0001f + static_cast<float>(i));
+			}
+		};
+
+		auto serialStart = Clock::now();
+		kernel(0, count);
+		const double serialMs = ElapsedMs(serialStart);
+
+		jobSystem.ResetStats();
+		auto start = Clock::now();
+		jobSystem.Wait(jobSystem.ParallelFor(count, grainSize, kernel));
+		const double parallelMs = ElapsedMs(start);
+
+		PrintStats("ParallelFor (4M, grain 4k)", count / grainSize, parallelMs, jobSystem.GetStats());
+		printf("%-28s serial %.2f ms, parallel %.2f ms, speedup %.2fx\n", "", serialMs, parallelMs, serialMs / parallelMs);
+		BenchmarkReporter::Report("JobSystem.ParallelFor/4M", parallelMs, "ms");
+		BenchmarkReporter::Report("JobSystem.ParallelFor/4M/Speedup", serialMs / parallelMs, "x");
+	}
+
+	// Long dependency chains, every job only becomes ready once its predecessor finished
+	static void BenchDependencyChains(JobSystem& jobSystem)
+	{
+		constexpr uint32_t chains = 64;
+		constexpr uint32_t chainLength = 256;
+		std::atomic<uint32_t> executed = 0;
+
+		jobSystem.ResetStats();
+		std::vector<JobHandle> tails(chains);
+		auto start = Clock::now();
+		for (uint32_t step = 0; step < chainLength; step++)
+		{
+			for (uint32_t chain = 0; chain < chains; chain++)
+			{
+				tails[chain] = jobSystem.Schedule([&executed]() { executed++; }, tails[chain]);
+			}
+		}
+		for (const JobHandle& handle : tails)
+		{
+			jobSystem.Wait(handle);
+		}
+		const double ms = ElapsedMs(start);
+		PrintStats("Dependency chains (64x256)", executed.load(), ms, jobSystem.GetStats());
+		BenchmarkReporter::Report("JobSystem.DependencyChains/64x256", ms * 1000000.0 / executed.load(), "ns");
+	}
+
+	void RunJobSystemBenchmarks()
+	{
+		JobSystem jobSystem(nullptr);
+		jobSystem.Initialize();
+		printf("==== JobSystem (%u threads) ====\n", jobSystem.GetNumThreads());
+
+		BenchEmptyJobs(jobSystem);
+		BenchParallelFor(jobSystem);
+		BenchDependencyChains(jobSystem);
+
+		const JobSystemStats stats = jobSystem.GetStats();
+		for (size_t i = 0; i < stats.PerThread.size(); i++)
+		{
+			printf("  thread %2zu executed %llu jobs\n", i, static_cast<unsigned long long>(stats.PerThread[i].JobsExecuted));
+		}
+	}
+}
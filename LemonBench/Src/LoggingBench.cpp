@@ -0,0 +1,76 @@
+#include "Benchmarks.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	// Measures how long LEMON_CORE_ERROR blocks the calling thread, in ns per call
+	static std::vector<double> MeasureCallerLatency(uint32_t numThreads)
+	{
+		// Bursts stay below the ring capacity so async numbers measure the enqueue, not the drop path
+		constexpr uint32_t burstSize = 1024;
+		constexpr uint32_t bursts = 16;
+
+		std::vector<std::vector<double>> samples(numThreads);
+		for (uint32_t burst = 0; burst < bursts; burst++)
+		{
+			std::vector<std::thread> threads;
+			for (uint32_t t = 0; t < numThreads; t++)
+			{
+				threads.emplace_back([&samples, t]()
+				{
+					std::vector<double>& threadSamples = samples[t];
+					for (uint32_t i = 0; i < burstSize / 4; i++)
+					{
+						auto start = Clock::now();
+						LEMON_CORE_ERROR("Bench thread {} iteration {} value {:.3f} name {}", t, i, i * 0.5, "LemonBench");
+						threadSamples.push_back(ElapsedMs(start) * 1000000.0);
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+			Logger::Flush();
+		}
+
+		std::vector<double> result;
+		for (const std::vector<double>& threadSamples : samples)
+		{
+			result.insert(result.end(), threadSamples.begin(), threadSamples.end());
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	static void BenchLogging(const char* name, const char* resultName, ELogMode mode, uint32_t numThreads)
+	{
+		Logger::Init(mode, "LemonBench.log", false);
+		const uint64_t droppedBefore = Logger::GetDroppedCount();
+		const std::vector<double> samples = MeasureCallerLatency(numThreads);
+
+		auto percentile = [&samples](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1))]; };
+		printf("%-28s %2u threads  p50 %8.0f ns  p99 %8.0f ns  max %10.0f ns  dropped %llu\n", name, numThreads,
+			percentile(0.5), percentile(0.99), samples.back(),
+			static_cast<unsigned long long>(Logger::GetDroppedCount() - droppedBefore));
+		BenchmarkReporter::Report(MakeResult(std::string("Logging.CallerLatency/") + resultName + "/" + std::to_string(numThreads) + "T",
+			"ns", samples.size(), samples));
+	}
+
+	void RunLoggingBenchmarks()
+	{
+		printf("==== Logging caller latency ====\n");
+		BenchLogging("sync (before)", "Sync", ELogMode::Sync, 1);
+		BenchLogging("async", "Async", ELogMode::Async, 1);
+		BenchLogging("sync (before)", "Sync", ELogMode::Sync, 4);
+		BenchLogging("async", "Async", ELogMode::Async, 4);
+
+		Logger::Init();
+	}
+}
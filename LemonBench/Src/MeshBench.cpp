@@ -0,0 +1,43 @@
+#include "Benchmarks.h"
+#include "RenderCore/Geometry/Sphere.h"
+#include "RHI/DynamicRHI.h"
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	void RunMeshBenchmarks()
+	{
+		printf("==== Mesh ====\n");
+
+		// Without shaders the constructor only builds and copies the geometry
+		Measure("Sphere.BuildSphere/20x20", 100, [](uint32_t)
+		{
+			Sphere sphere(1.0f, false);
+			DoNotOptimize(sphere);
+		});
+		Measure("Sphere.BuildSphere/64x64", 20, [](uint32_t)
+		{
+			Sphere sphere(1.0f, false, 64, 64);
+			DoNotOptimize(sphere);
+		});
+
+		// Buffer creation goes through the Null RHI, what is measured is the staging copy and the declaration
+		GetBenchEngine();
+		if (!IsRHIAvailable())
+		{
+			printf("No RHI, skipping Mesh.CreateRHIBuffers\n");
+			return;
+		}
+		Sphere sphere;
+		Measure("Mesh.CreateRHIBuffers/Sphere20x20", 100, [&sphere](uint32_t)
+		{
+			sphere.CreateRHIBuffers();
+		});
+		Sphere denseSphere(1.0f, true, 64, 64);
+		Measure("Mesh.CreateRHIBuffers/Sphere64x64", 20, [&denseSphere](uint32_t)
+		{
+			denseSphere.CreateRHIBuffers();
+		});
+	}
+}
@@ -0,0 +1,116 @@
+#include "Benchmarks.h"
+#include "Core/Engine.h"
+#include "Core/FrameAllocator.h"
+#include "RenderCore/Geometry/Sphere.h"
+#include "RHI/DynamicRHI.h"
+#include "Renderer/Renderer.h"
+#include "World/Components/StaticMeshComponent.h"
+#include "World/Components/TransformComponent.h"
+#include "World/World.h"
+
+#include <sstream>
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	// Spheres laid out like World::CreateTestSphere, cycling through its 10x10 metallic/roughness materials.
+	// The meshes are shared, one sphere mesh per entity does not fit in memory at 100k
+	class SphereScene
+	{
+	public:
+		static constexpr uint32_t PaletteSize = 10;
+
+		SphereScene()
+		{
+			const bool bRHIAvailable = IsRHIAvailable();
+			for (uint32_t i = 0; i < PaletteSize; i++)
+			{
+				for (uint32_t j = 0; j < PaletteSize; j++)
+				{
+					Ref<Mesh> sphereMesh = CreateRef<Sphere>(1.0f, bRHIAvailable);
+					Ref<Material> renderMaterial = CreateRef<Material>();
+					renderMaterial->Metallic = i * 0.1f;
+					renderMaterial->Roughness = j * 0.1f;
+					sphereMesh->SetMaterial(renderMaterial);
+					m_Meshes.emplace_back(sphereMesh);
+				}
+			}
+		}
+
+		void Grow(World& world, uint32_t entityCount)
+		{
+			for (; m_EntityCount < entityCount; m_EntityCount++)
+			{
+				const uint32_t paletteIndex = m_EntityCount % (PaletteSize * PaletteSize);
+				const Ref<Mesh>& sphereMesh = m_Meshes[paletteIndex];
+
+				std::stringstream ss;
+				ss << "metallic" << sphereMesh->GetMaterial()->Metallic << "roughness" << sphereMesh->GetMaterial()->Roughness;
+				Entity sphere = world.CreateEntity("Sphere" + ss.str());
+
+				StaticMeshComponent& staticMesh = sphere.AddComponent<StaticMeshComponent>();
+				staticMesh.SetMesh(sphereMesh);
+				// 100x100 layers of the 2 unit spaced test grid
+				TransformComponent& transformComp = sphere.GetComponent<TransformComponent>();
+				transformComp.SetPosition(glm::vec3((m_EntityCount % 100) * 2.0f, ((m_EntityCount / 100) % 100) * 2.0f, (m_EntityCount / 10000) * 2.0f));
+			}
+		}
+
+	private:
+		std::vector<Ref<Mesh>> m_Meshes;
+		uint32_t m_EntityCount = 0;
+	};
+
+	static void BenchScene(Engine& engine, SphereScene& scene, uint32_t entityCount)
+	{
+		World& world = *engine.GetSystem<World>();
+		Renderer& renderer = *engine.GetSystem<Renderer>();
+		const std::string suffix = "/" + std::to_string(entityCount);
+
+		auto createStart = Clock::now();
+		scene.Grow(world, entityCount);
+		// Only the entities added on top of the previous scene
+		const BenchmarkResult createResult = MakeResult("Scene.Create" + suffix, "ms", 1, { ElapsedMs(createStart) });
+		BenchmarkReporter::Report(createResult);
+		BenchmarkReporter::PrintResult(createResult);
+
+		const uint32_t frameCount = (std::max)(5u, 30000u / entityCount);
+
+		// A full frame: world tick, classification and recording every pass on the Null RHI
+		std::vector<double> frameMs;
+		for (uint32_t frame = 0; frame <= frameCount; frame++)
+		{
+			auto start = Clock::now();
+			engine.BeginOneFrame();
+			engine.Tick();
+			engine.EndOneFrame();
+			if (frame > 0)
+			{
+				frameMs.push_back(ElapsedMs(start));
+			}
+		}
+		const BenchmarkResult frameResult = MakeResult("Scene.Frame" + suffix, "ms", frameCount, frameMs);
+		BenchmarkReporter::Report(frameResult);
+		BenchmarkReporter::PrintResult(frameResult);
+
+		// The entity classification of Renderer::Tick on its own, once per frame so the frame arena can recycle
+		MeasureWithSetup("Renderer.ClassifyEntitys" + suffix, 1,
+			[]() { FrameAllocator::EndFrame(); },
+			[&](uint32_t) { renderer.ClassifyEntitys(); },
+			frameCount);
+	}
+
+	void RunSceneBenchmarks()
+	{
+		printf("==== Scenes ====\n");
+
+		Engine& engine = GetBenchEngine();
+		SphereScene scene;
+		// Each scene grows the previous one. The entities are left to the engine shutdown, destroying 100k one by one takes longer than the benchmark
+		for (uint32_t entityCount : { 1000u, 10000u, 100000u })
+		{
+			BenchScene(engine, scene, entityCount);
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#include "Benchmarks.h"
+#include "Core/SystemManager.h"
+
+#include <utility>
+#include <vector>
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	template<int N>
+	class BenchSystem : public ISystem
+	{
+	public:
+		BenchSystem(Engine* engine) :ISystem(engine) {}
+	};
+
+	// The lookup SystemManager::GetSystem used before systems had a type index
+	template<typename T>
+	static T* LinearGetSystem(const std::vector<Ref<ISystem>>& systems)
+	{
+		for (const auto& system : systems)
+		{
+			if (system)
+			{
+				if (typeid(T) == typeid(*system))
+					return static_cast<T*>(system.get());
+			}
+		}
+		return nullptr;
+	}
+
+	template<int... N>
+	static void RegisterBenchSystems(SystemManager& systemManager, std::vector<Ref<ISystem>>& systems, std::integer_sequence<int, N...>)
+	{
+		(systemManager.RegisterSystem<BenchSystem<N>>(nullptr), ...);
+		(systems.emplace_back(CreateRef<BenchSystem<N>>(nullptr)), ...);
+	}
+
+	template<typename T, typename Lookup>
+	static double MeasureLookup(Lookup&& lookup)
+	{
+		constexpr uint32_t iterations = 10000000;
+		ISystem* volatile sink = nullptr;
+
+		auto start = Clock::now();
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			sink = lookup();
+		}
+		(void)sink;
+		return ElapsedMs(start) * 1000000.0 / iterations;
+	}
+
+	void RunSystemManagerBenchmarks()
+	{
+		constexpr int systemCount = 16;
+
+		SystemManager systemManager;
+		std::vector<Ref<ISystem>> systems;
+		RegisterBenchSystems(systemManager, systems, std::make_integer_sequence<int, systemCount>());
+
+		printf("==== SystemManager::GetSystem (%d systems) ====\n", systemCount);
+
+		using First = BenchSystem<0>;
+		using Last = BenchSystem<systemCount - 1>;
+		const double linearFirst = MeasureLookup<First>([&]() { return LinearGetSystem<First>(systems); });
+		const double linearLast = MeasureLookup<Last>([&]() { return LinearGetSystem<Last>(systems); });
+		const double indexedFirst = MeasureLookup<First>([&]() { return systemManager.GetSystem<First>(); });
+		const double indexedLast = MeasureLookup<Last>([&]() { return systemManager.GetSystem<Last>(); });
+
+		printf("%-28s first %6.2f ns  last %6.2f ns\n", "typeid scan (before)", linearFirst, linearLast);
+		printf("%-28s first %6.2f ns  last %6.2f ns\n", "type index (after)", indexedFirst, indexedLast);
+		BenchmarkReporter::Report("SystemManager.GetSystem/First", indexedFirst, "ns");
+		BenchmarkReporter::Report("SystemManager.GetSystem/Last", indexedLast, "ns");
+	}
+}
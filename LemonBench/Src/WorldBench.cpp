@@ -0,0 +1,384 @@
+#include "Benchmarks.h"
+#include "Core/Engine.h"
+#include "Core/JobSystem.h"
+#include "World/World.h"
+#include "World/Components/StaticMeshComponent.h"
+#include "World/Components/TransformComponent.h"
+#include "RenderCore/Geometry/Sphere.h"
+#include <random>
+
+using namespace Lemon;
+
+namespace LemonBench
+{
+	static void DestroyAll(World& world, std::vector<Entity>& entities)
+	{
+		for (Entity& entity : entities)
+		{
+			world.DestroyEntity(entity);
+		}
+		entities.clear();
+		world.EndOneFrame();
+	}
+
+	// 64 roots, 8 children per node down to 4 levels, 37440 attached transforms
+	static void BenchTransformHierarchy(World& world)
+	{
+		constexpr uint32_t rootCount = 64;
+		constexpr uint32_t fanOut = 8;
+		constexpr uint32_t depth = 4;
+
+		std::vector<Entity> roots;
+		std::vector<Entity> level;
+		std::vector<Entity> nextLevel;
+		for (uint32_t i = 0; i < rootCount; i++)
+		{
+			roots.emplace_back(world.CreateEntity("Root"));
+			roots.back().GetComponent<TransformComponent>().SetPosition(glm::vec3(i * 10.0f, 0.0f, 0.0f));
+		}
+		level = roots;
+		for (uint32_t d = 1; d < depth; d++)
+		{
+			nextLevel.clear();
+			for (Entity parent : level)
+			{
+				for (uint32_t i = 0; i < fanOut; i++)
+				{
+					Entity child = world.CreateEntity("Child");
+					child.GetComponent<TransformComponent>().SetPosition(glm::vec3(1.0f, 0.0f, i * 1.0f));
+					child.GetComponent<TransformComponent>().SetRotation(glm::vec3(0.0f, i * 45.0f, 0.0f));
+					world.SetParent(child, parent);
+					nextLevel.push_back(child);
+				}
+			}
+			level.swap(nextLevel);
+		}
+		world.UpdateTransforms();
+		const std::string suffix = "/" + std::to_string(world.GetTransformHierarchy().GetNodeCount());
+
+		// Every subtree is recomputed
+		MeasureWithSetup("World.UpdateTransforms.RootsMoved" + suffix, 1,
+			[&]()
+			{
+				for (Entity root : roots)
+				{
+					TransformComponent& transform = root.GetComponent<TransformComponent>();
+					transform.SetPosition(transform.GetPosition() + glm::vec3(0.0f, 0.1f, 0.0f));
+				}
+			},
+			[&](uint32_t) { world.UpdateTransforms(); });
+
+		// One leaf, the rest is skipped by the dirty flags
+		MeasureWithSetup("World.UpdateTransforms.LeafMoved" + suffix, 1,
+			[&]()
+			{
+				TransformComponent& transform = level.back().GetComponent<TransformComponent>();
+				transform.SetPosition(transform.GetPosition() + glm::vec3(0.0f, 0.1f, 0.0f));
+			},
+			[&](uint32_t) { world.UpdateTransforms(); });
+
+		for (Entity& root : roots)
+		{
+			world.DestroyEntity(root);
+		}
+		world.EndOneFrame();
+		world.UpdateTransforms();
+	}
+
+	// 100 x 100 meshes on a grid sharing one sphere, the tree against a scan over every entity
+	static void BenchSpatialQueries(World& world)
+	{
+		constexpr uint32_t gridSize = 100;
+		Ref<Mesh> sphereMesh = CreateRef<Sphere>(0.5f, false);
+		std::vector<Entity> entities;
+		for (uint32_t x = 0; x < gridSize; x++)
+		{
+			for (uint32_t z = 0; z < gridSize; z++)
+			{
+				Entity entity = world.CreateEntity("Sphere");
+				entity.GetComponent<TransformComponent>().SetPosition(glm::vec3(x * 2.0f, 0.0f, z * 2.0f));
+				entity.AddComponent<StaticMeshComponent>().SetMesh(sphereMesh);
+				entities.push_back(entity);
+			}
+		}
+		world.UpdateTransforms();
+		const std::string suffix = "/" + std::to_string(entities.size());
+
+		const AABB queryBounds(glm::vec3(90.0f, -1.0f, 90.0f), glm::vec3(110.0f, 1.0f, 110.0f));
+		Measure("World.QueryAABB.Tree" + suffix, 1, [&](uint32_t)
+			{
+				uint32_t count = 0;
+				world.QueryAABB(queryBounds, [&count](Entity) { count++; return true; });
+				DoNotOptimize(count);
+			});
+		Measure("World.QueryAABB.LinearScan" + suffix, 1, [&](uint32_t)
+			{
+				uint32_t count = 0;
+				for (const Entity& entity : world.GetAllEntities())
+				{
+					if (entity.HasComponent<StaticMeshComponent>())
+					{
+						const AABB bounds = entity.GetComponent<StaticMeshComponent>().GetRenderMesh()->GetLocalBounds()
+							.Transformed(entity.GetComponent<TransformComponent>().GetLocalToWorldMatrix());
+						count += bounds.Overlaps(queryBounds) ? 1 : 0;
+					}
+				}
+				DoNotOptimize(count);
+			});
+
+		const Ray ray(glm::vec3(101.0f, 0.0f, -10.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		Measure("World.Raycast" + suffix, 1, [&](uint32_t) { DoNotOptimize(world.Raycast(ray)); });
+
+		// A tenth of them drifts every frame, most stay inside their fat bounds
+		uint32_t frame = 0;
+		MeasureWithSetup("World.UpdateTransforms.SpatialRefit" + suffix, 1,
+			[&]()
+			{
+				frame++;
+				for (uint32_t i = frame % 10; i < entities.size(); i += 10)
+				{
+					TransformComponent& transform = entities[i].GetComponent<TransformComponent>();
+					transform.SetPosition(transform.GetPosition() + glm::vec3(0.03f, 0.0f, 0.0f));
+				}
+			},
+			[&](uint32_t) { world.UpdateTransforms(); });
+
+		DestroyAll(world, entities);
+		world.UpdateTransforms();
+	}
+
+	// The world bounds of every mesh in the world, the reference the spatial queries are checked against
+	static std::vector<std::pair<Entity, AABB>> CollectMeshBounds(World& world)
+	{
+		std::vector<std::pair<Entity, AABB>> meshBounds;
+		for (const Entity& entity : world.GetAllEntities())
+		{
+			if (!entity.HasComponent<StaticMeshComponent>() || !entity.GetComponent<StaticMeshComponent>().GetRenderMesh())
+			{
+				continue;
+			}
+			const AABB& localBounds = entity.GetComponent<StaticMeshComponent>().GetRenderMesh()->GetLocalBounds();
+			if (localBounds.IsValid())
+			{
+				meshBounds.emplace_back(entity, localBounds.Transformed(entity.GetComponent<TransformComponent>().GetLocalToWorldMatrix()));
+			}
+		}
+		return meshBounds;
+	}
+
+	// Random meshes drifting, jumping across the world and being replaced, then the tree is validated and its
+	// queries compared with a scan over every mesh. A wrong result fails the run
+	static void BenchSpatialChurn(World& world)
+	{
+		constexpr uint32_t meshCount = 5000;
+		constexpr float worldSize = 200.0f;
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> coordinate(0.0f, worldSize);
+		std::uniform_real_distribution<float> drift(-0.05f, 0.05f);
+		std::uniform_real_distribution<float> scale(0.5f, 3.0f);
+		std::uniform_int_distribution<uint32_t> pick(0, meshCount - 1);
+		std::uniform_int_distribution<uint32_t> percent(0, 99);
+
+		Ref<Mesh> sphereMesh = CreateRef<Sphere>(0.5f, false);
+		auto createMesh = [&]()
+		{
+			Entity entity = world.CreateEntity("Sphere");
+			TransformComponent& transform = entity.GetComponent<TransformComponent>();
+			transform.SetPosition(glm::vec3(coordinate(random), coordinate(random), coordinate(random)));
+			transform.SetScale(glm::vec3(scale(random)));
+			entity.AddComponent<StaticMeshComponent>().SetMesh(sphereMesh);
+			return entity;
+		};
+		std::vector<Entity> entities;
+		for (uint32_t i = 0; i < meshCount; i++)
+		{
+			entities.push_back(createMesh());
+		}
+		world.UpdateTransforms();
+
+		// Per frame a fifth moves, one in ten of those to anywhere, and 1% is destroyed and replaced
+		MeasureWithSetup("World.UpdateTransforms.SpatialChurn/" + std::to_string(meshCount), 1,
+			[&]()
+			{
+				for (uint32_t i = 0; i < meshCount / 5; i++)
+				{
+					TransformComponent& transform = entities[pick(random)].GetComponent<TransformComponent>();
+					if (percent(random) < 10)
+					{
+						transform.SetPosition(glm::vec3(coordinate(random), coordinate(random), coordinate(random)));
+					}
+					else
+					{
+						transform.SetPosition(transform.GetPosition() + glm::vec3(drift(random), drift(random), drift(random)));
+					}
+				}
+				for (uint32_t i = 0; i < meshCount / 100; i++)
+				{
+					Entity& entity = entities[pick(random)];
+					world.DestroyEntity(entity);
+					world.EndOneFrame();
+					entity = createMesh();
+				}
+			},
+			[&](uint32_t) { world.UpdateTransforms(); }, 20);
+
+		const std::string checkName = "World.SpatialChurn.Check";
+		if (!world.ValidateSpatialTree())
+		{
+			BenchmarkReporter::ReportFailure(checkName, "the spatial tree is inconsistent, see the log");
+		}
+
+		const std::vector<std::pair<Entity, AABB>> meshBounds = CollectMeshBounds(world);
+		std::uniform_real_distribution<float> extent(1.0f, 20.0f);
+		uint32_t aabbMismatches = 0;
+		for (uint32_t query = 0; query < 100; query++)
+		{
+			const glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+			const AABB queryBounds(center - glm::vec3(extent(random)), center + glm::vec3(extent(random)));
+
+			std::vector<entt::entity> found;
+			world.QueryAABB(queryBounds, [&found](Entity entity) { found.push_back(entity); return true; });
+			std::vector<entt::entity> expected;
+			for (const auto& [entity, bounds] : meshBounds)
+			{
+				if (bounds.Overlaps(queryBounds))
+				{
+					expected.push_back(entity);
+				}
+			}
+			std::sort(found.begin(), found.end());
+			std::sort(expected.begin(), expected.end());
+			aabbMismatches += found != expected ? 1 : 0;
+		}
+
+		std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+		uint32_t rayMismatches = 0;
+		for (uint32_t query = 0; query < 100; query++)
+		{
+			const Ray ray(glm::vec3(coordinate(random), coordinate(random), -10.0f),
+				glm::vec3(direction(random) * 0.5f, direction(random) * 0.5f, 1.0f));
+
+			float distance = FLT_MAX;
+			const Entity hit = world.Raycast(ray, FLT_MAX, &distance);
+			Entity expected;
+			float expectedDistance = FLT_MAX;
+			for (const auto& [entity, bounds] : meshBounds)
+			{
+				float entityDistance;
+				if (bounds.IntersectsRay(ray, expectedDistance, entityDistance) && entityDistance < expectedDistance)
+				{
+					expected = entity;
+					expectedDistance = entityDistance;
+				}
+			}
+			// Equally near meshes may be reported in any order
+			const bool bMatch = hit == expected || (hit && expected && distance == expectedDistance);
+			rayMismatches += bMatch ? 0 : 1;
+		}
+
+		printf("%-40s %u of 100 boxes, %u of 100 rays differ from a linear scan\n", checkName.c_str(), aabbMismatches, rayMismatches);
+		if (aabbMismatches > 0 || rayMismatches > 0)
+		{
+			BenchmarkReporter::ReportFailure(checkName, "QueryAABB or Raycast differs from a linear scan");
+		}
+
+		DestroyAll(world, entities);
+		world.UpdateTransforms();
+	}
+
+	void RunWorldBenchmarks()
+	{
+		printf("==== World ====\n");
+
+		World& world = *GetBenchEngine().GetSystem<World>();
+		constexpr uint32_t entityCount = 10000;
+		std::vector<Entity> entities;
+		entities.reserve(entityCount);
+
+		MeasureWithSetup("World.CreateEntity", entityCount,
+			[&]() { DestroyAll(world, entities); },
+			[&](uint32_t) { entities.emplace_back(world.CreateEntity("Entity")); });
+		DestroyAll(world, entities);
+
+		MeasureWithSetup("World.DestroyEntity/10000", entityCount,
+			[&]()
+			{
+				// Previous batch is only queued, destroy it outside the measurement
+				world.EndOneFrame();
+				entities.clear();
+				for (uint32_t i = 0; i < entityCount; i++)
+				{
+					entities.emplace_back(world.CreateEntity("Entity"));
+				}
+			},
+			[&](uint32_t i) { world.DestroyEntity(entities[i]); });
+		world.EndOneFrame();
+		entities.clear();
+
+		// The queue flush: registry destruction and swap and pop out of the world's list
+		MeasureWithSetup("World.EndOneFrame/Destroyed10000", 1,
+			[&]()
+			{
+				for (uint32_t i = 0; i < entityCount; i++)
+				{
+					entities.emplace_back(world.CreateEntity("Entity"));
+				}
+				for (Entity& entity : entities)
+				{
+					world.DestroyEntity(entity);
+				}
+				entities.clear();
+			},
+			[&](uint32_t) { world.EndOneFrame(); }, 5);
+
+		// Recorded by jobs of 1024 entities, then played back at the sync point
+		JobSystem* jobSystem = GetBenchEngine().GetSystem<JobSystem>();
+		MeasureWithSetup("World.CommandBuffer.CreateEntity/10000", 1,
+			[&]() { world.EndOneFrame(); },
+			[&](uint32_t)
+			{
+				JobHandle handle = jobSystem->ParallelFor(entityCount, 1024, [&world](uint32_t begin, uint32_t end)
+					{
+						EntityCommandBuffer& commandBuffer = world.CreateCommandBuffer(begin);
+						for (uint32_t i = begin; i < end; i++)
+						{
+							EntityCommandBuffer::PendingEntity entity = commandBuffer.CreateEntity("Entity");
+							commandBuffer.AddComponent<TransformComponent>(entity, glm::vec3(i * 1.0f, 0.0f, 0.0f));
+						}
+					});
+				jobSystem->Wait(handle);
+				const size_t firstCreated = world.GetAllEntities().size();
+				world.PlaybackCommandBuffers();
+				// Only queued, the next setup flushes them
+				for (size_t i = firstCreated; i < world.GetAllEntities().size(); i++)
+				{
+					Entity entity = world.GetAllEntities()[i];
+					world.DestroyEntity(entity);
+				}
+			}, 5);
+		world.EndOneFrame();
+
+		// Same per-entity work, serial vs split into chunks on the job system
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			entities.emplace_back(world.CreateEntity("Entity"));
+		}
+		Measure("World.Each.SavePreviousState/10000", 1,
+			[&](uint32_t) { world.Each<TransformComponent>([](TransformComponent& transform) { transform.SavePreviousState(); }); });
+		Measure("World.ParallelEach.SavePreviousState/10000", 1,
+			[&](uint32_t) { world.ParallelEach<TransformComponent>([](TransformComponent& transform) { transform.SavePreviousState(); }); });
+		Measure("World.ParallelReduce.SumPositions/10000", 1,
+			[&](uint32_t)
+			{
+				glm::vec3 sum = world.ParallelReduce<TransformComponent>(glm::vec3(0.0f),
+					[](glm::vec3& partial, TransformComponent& transform) { partial += transform.GetPosition(); },
+					[](glm::vec3& result, glm::vec3& partial) { result += partial; });
+				DoNotOptimize(sum);
+			});
+		DestroyAll(world, entities);
+
+		BenchTransformHierarchy(world);
+		BenchSpatialQueries(world);
+		BenchSpatialChurn(world);
+	}
+}
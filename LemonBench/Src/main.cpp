@@ -0,0 +1,66 @@
+//= INCLUDES ======
+#include "Benchmarks.h"
+#include "Log/Log.h"
+#include <cstring>
+//=================
+
+// usage: LemonBench [--filter name] [--json file.json]
+//	--filter only runs the groups whose name contains it
+//	--json writes every result, names are stable so files of different builds can be compared
+// Exits with 1 when a benchmark's result does not match its reference implementation
+int main(int argc, char** argv)
+{
+	const char* filter = nullptr;
+	const char* jsonPath = nullptr;
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--filter") == 0)
+		{
+			filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--json") == 0)
+		{
+			jsonPath = argv[++i];
+		}
+	}
+
+	Lemon::Logger::Init();
+
+	struct BenchmarkGroup
+	{
+		const char* Name;
+		void (*Run)();
+	};
+	// Scenes last, they leave their entities in the shared engine
+	const BenchmarkGroup groups[] =
+	{
+		{ "JobSystem", LemonBench::RunJobSystemBenchmarks },
+		{ "SystemManager", LemonBench::RunSystemManagerBenchmarks },
+		{ "Logging", LemonBench::RunLoggingBenchmarks },
+		{ "Transform", LemonBench::RunTransformBenchmarks },
+		{ "Mesh", LemonBench::RunMeshBenchmarks },
+		{ "ImageImporter", LemonBench::RunImageImporterBenchmarks },
+		{ "World", LemonBench::RunWorldBenchmarks },
+		{ "Scene", LemonBench::RunSceneBenchmarks },
+	};
+	for (const BenchmarkGroup& group : groups)
+	{
+		if (!filter || std::strstr(group.Name, filter))
+		{
+			group.Run();
+		}
+	}
+
+	LemonBench::ShutdownBenchEngine();
+
+	if (jsonPath && !LemonBench::BenchmarkReporter::WriteJson(jsonPath))
+	{
+		return 1;
+	}
+	if (LemonBench::BenchmarkReporter::GetFailureCount() > 0)
+	{
+		printf("%u checks failed\n", LemonBench::BenchmarkReporter::GetFailureCount());
+		return 1;
+	}
+	return 0;
+}
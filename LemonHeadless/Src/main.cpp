@@ -0,0 +1,137 @@
+//= INCLUDES ======
+#include "Core/Engine.h"
+#include "Core/Timer.h"
+#include "Input/InputRecorder.h"
+#include "Log/Log.h"
+#include "RHI/DynamicRHI.h"
+#include "RHI/Null/NullCommandList.h"
+#include "RHI/Null/NullDynamicRHI.h"
+#include "RHI/Software/SoftwareCommandList.h"
+#include "RHI/Software/SoftwareDynamicRHI.h"
+#include "RHI/Software/SoftwareResources.h"
+#include "Renderer/Renderer.h"
+#include "World/World.h"
+#include "World/Components/CameraComponent.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+//=================
+
+// Drives the engine loop without a window, e.g. on headless linux build machines
+// usage: LemonHeadless [frameCount] [--null-rhi | --software-rhi] [--capture file.ppm] [--record-input file | --replay-input file]
+//	--null-rhi runs the whole renderer against the recording Null RHI
+//	--software-rhi renders on the CPU, --capture then writes the last frame's scene color
+//	--record-input writes every frame's input and delta, --replay-input plays such a file back and runs until it ends
+int main(int argc, char** argv)
+{
+	uint32_t frameCount = 600;
+	const char* capturePath = nullptr;
+	const char* recordInputPath = nullptr;
+	const char* replayInputPath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--null-rhi") == 0)
+		{
+			Lemon::RHISetBackend(Lemon::ERHIBackend::Null);
+		}
+		else if (std::strcmp(argv[i], "--software-rhi") == 0)
+		{
+			Lemon::RHISetBackend(Lemon::ERHIBackend::Software);
+		}
+		else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+		{
+			capturePath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--record-input") == 0 && i + 1 < argc)
+		{
+			recordInputPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--replay-input") == 0 && i + 1 < argc)
+		{
+			replayInputPath = argv[++i];
+		}
+		else
+		{
+			frameCount = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+		}
+	}
+
+	// No Handle: no swap chain, no window input
+	Lemon::WindowData windowData;
+	windowData.Width = 1280;
+	windowData.Height = 720;
+
+	Lemon::Engine engine(windowData);
+	engine.SetFixedTimestep(true, 60.0);
+
+	Lemon::InputRecorder* inputRecorder = engine.GetInputRecorder();
+	if (replayInputPath)
+	{
+		if (!inputRecorder->StartReplay(replayInputPath))
+		{
+			return 1;
+		}
+		frameCount = inputRecorder->GetFrameCount();
+	}
+	else if (recordInputPath && !inputRecorder->StartRecording(recordInputPath))
+	{
+		return 1;
+	}
+
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		engine.BeginOneFrame();
+		engine.Tick();
+
+		// Same as the editor, the camera is the only thing driven by input
+		Lemon::Entity camera = engine.GetSystem<Lemon::World>()->GetMainCamera();
+		if (camera && camera.HasComponent<Lemon::CameraComponent>())
+		{
+			camera.GetComponent<Lemon::CameraComponent>().ProcessInputSystem(engine.GetTimer()->GetDeltaTimeSec());
+		}
+		engine.EndOneFrame();
+	}
+	inputRecorder->Stop();
+
+	const Lemon::FrameTimeStats stats = engine.GetTimer()->GetFrameTimeStats();
+	std::printf("Frames: %u  mean: %.3f ms  p50: %.3f ms  p95: %.3f ms  max: %.3f ms\n",
+		frameCount, stats.MeanMs, stats.P50Ms, stats.P95Ms, stats.MaxMs);
+
+	// Commands of the last rendered frame
+	if (const Lemon::NullDynamicRHI* nullRHI = Lemon::GetNullDynamicRHI())
+	{
+		if (const Lemon::NullCommandList* commandList = nullRHI->GetCommandList())
+		{
+			std::printf("RHI commands: %u  passes: %u  draws: %u  primitives: %llu\n",
+				commandList->GetCommandCount(), commandList->GetPassCount(),
+				commandList->GetCommandCount(Lemon::ENullRHICommand::DrawIndexPrimitive),
+				static_cast<unsigned long long>(commandList->GetPrimitiveCount()));
+		}
+	}
+
+	if (const Lemon::SoftwareDynamicRHI* softwareRHI = Lemon::GetSoftwareDynamicRHI())
+	{
+		if (Lemon::SoftwareCommandList* commandList = softwareRHI->GetCommandList())
+		{
+			const Lemon::SoftwareCommandList::Stats& drawStats = commandList->GetStats();
+			const Lemon::SoftwareRasterizer::Stats& rasterStats = commandList->GetRasterizer().GetStats();
+			std::printf("Software RHI (%s): draws: %u  skipped: %u  triangles: %llu / %llu  tiles: %llu\n",
+				Lemon::SoftwareRasterizer::GetInstructionSet(), drawStats.DrawCount, drawStats.SkippedDrawCount,
+				static_cast<unsigned long long>(rasterStats.TrianglesRasterized),
+				static_cast<unsigned long long>(rasterStats.TrianglesSubmitted),
+				static_cast<unsigned long long>(rasterStats.TilesRasterized));
+		}
+
+		const Lemon::Renderer* renderer = engine.GetSystem<Lemon::Renderer>();
+		if (capturePath && renderer && renderer->GetSceneRenderTargets())
+		{
+			const auto* sceneColor = static_cast<const Lemon::SoftwareTexture2D*>(renderer->GetSceneRenderTargets()->GetSceneColorTexture().get());
+			if (!sceneColor || !sceneColor->GetSurface().WritePPM(capturePath))
+			{
+				std::printf("Could not capture the scene color to %s\n", capturePath);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
@@ -105,6 +105,25 @@ project "Lemon"
 		buildoptions "/MD"
         optimize "On"
 
+	-- Headless only: no RHI, null input and no editor side third party code
+	filter "system:linux"
+		removefiles
+		{
+			"%{prj.name}/Src/RHI/D3D11/**",
+			"%{prj.name}/Src/Input/Windows/**",
+			"%{prj.name}/ThirdParty/ImGuizmo/ImGuizmo.cpp"
+		}
+		removelinks
+		{
+			"imgui"
+		}
+		-- msvc runtime switches from the configurations above
+		removebuildoptions
+		{
+			"/MDd",
+			"/MD"
+		}
+
 project "Editor"
 	location "Editor"
 	kind "ConsoleApp"
@@ -153,4 +172,120 @@ project "Editor"
 	filter "configurations:Shipping"
 		defines "LEMON_SHIPPING"
 		buildoptions "/MD"
-        optimize "On"
\ No newline at end of file
+        optimize "On"
+
+project "LemonBench"
+	location "LemonBench"
+	kind "ConsoleApp"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/Src/**.h",
+		"%{prj.name}/Src/**.cpp",
+	}
+
+	includedirs
+	{
+		"%{wks.location}/Lemon/ThirdParty/spdlog/include",
+		"%{wks.location}/Lemon/Src",
+		"%{ThirdPartyIncludeDir.glm}",
+		"%{ThirdPartyIncludeDir.std_image}",
+		"%{wks.location}/Lemon/ThirdParty",
+	}
+
+	links
+	{
+		"Lemon"
+	}
+
+	filter "system:Windows"
+		systemversion "latest" -- To use the latest version of the SDK available
+
+		defines
+		{
+			"LEMON_PLATFORM_WINDOW",
+			"LEMON_GRAPHICS_D3D11"
+		}
+
+	filter "configurations:Debug"
+		defines "LEMON_DEBUG"
+		buildoptions "/MDd"
+	    symbols "On"
+	filter "configurations:Release"
+		defines "LEMON_RELEASE"
+		buildoptions "/MD"
+	    optimize "On"
+	filter "configurations:Shipping"
+		defines "LEMON_SHIPPING"
+		buildoptions "/MD"
+        optimize "On"
+
+	-- Runs headless on the Null RHI, see the Lemon linux filter
+	filter "system:linux"
+		links
+		{
+			"pthread"
+		}
+		removebuildoptions
+		{
+			"/MDd",
+			"/MD"
+		}
+
+project "LemonHeadless"
+	location "LemonHeadless"
+	kind "ConsoleApp"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/Src/**.h",
+		"%{prj.name}/Src/**.cpp",
+	}
+
+	includedirs
+	{
+		"%{wks.location}/Lemon/ThirdParty/spdlog/include",
+		"%{wks.location}/Lemon/Src",
+		"%{ThirdPartyIncludeDir.glm}",
+		"%{wks.location}/Lemon/ThirdParty",
+	}
+
+	links
+	{
+		"Lemon"
+	}
+
+	filter "system:Windows"
+		systemversion "latest" -- To use the latest version of the SDK available
+
+		defines
+		{
+			"LEMON_PLATFORM_WINDOW",
+			"LEMON_GRAPHICS_D3D11"
+		}
+
+	filter "system:linux"
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		defines "LEMON_DEBUG"
+		symbols "On"
+	filter "configurations:Release"
+		defines "LEMON_RELEASE"
+		optimize "On"
+	filter "configurations:Shipping"
+		defines "LEMON_SHIPPING"
+		optimize "On"